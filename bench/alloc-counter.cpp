@@ -0,0 +1,45 @@
+#include "alloc-counter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<size_t> allocation_count{0};
+}
+
+namespace txservice::bench
+{
+size_t AllocationCount()
+{
+    return allocation_count.load(std::memory_order_relaxed);
+}
+}  // namespace txservice::bench
+
+void *operator new(size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// stable_sort's temporary buffer comes from here; it must pair with the
+// free-based delete below.
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
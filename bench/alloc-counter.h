@@ -0,0 +1,11 @@
+#ifndef TXSERVICE_BENCH_ALLOC_COUNTER_H_
+#define TXSERVICE_BENCH_ALLOC_COUNTER_H_
+
+#include <stddef.h>
+
+namespace txservice::bench
+{
+// number of global operator new calls made so far by the process.
+size_t AllocationCount();
+}  // namespace txservice::bench
+#endif  // TXSERVICE_BENCH_ALLOC_COUNTER_H_
@@ -0,0 +1,176 @@
+// Executor hot paths in isolation: driving one transaction through
+// MoveForward, dispatching Begin requests to task slots in LaunchRequests,
+// and answering an OperationRequest through its Result.
+#include <benchmark/benchmark.h>
+#include "alloc-counter.h"
+#include "memory/in-memory-versiondb.h"
+#include "transaction/operation-request-pool.h"
+#include "transaction/runtime-transaction-executor.h"
+#include "transaction/transaction-execution.h"
+#include "transaction/txn-id-generator-factory.h"
+
+namespace txservice::bench
+{
+using transaction::OperationRequest;
+using transaction::OperationRequestPool;
+using transaction::Result;
+using transaction::TransactionExecution;
+
+namespace
+{
+const TableName kTable = "bench";
+
+void RunToIdle(TransactionExecution &execution)
+{
+    while (!execution.MoveForward())
+    {
+    }
+}
+}  // namespace
+
+// one read-only transaction of `reads` reads, driven straight through
+// MoveForward. The in-memory handler answers inline, so this is the cost of
+// the operation state machines and the local state, without any queueing.
+static void BM_MoveForwardReadTxn(benchmark::State &state)
+{
+    size_t reads = state.range(0);
+    memory::InMemoryVersionDb db;
+    db.CreateVersionTable(kTable);
+    request::Handler::Pointer handler = db.MakeHandler();
+    transaction::SimpleTxnIDGeneratorFactory id_factory(1);
+    auto id_generator = id_factory.GetTxnIDGenerator(0);
+    transaction::LocalTimeProvider time_provider;
+    TransactionExecution execution(
+        0, handler.get(), id_generator.get(), &time_provider, nullptr);
+
+    OperationRequestPool requests(reads + 2);
+    OperationRequest *begin = requests.Acquire(1, transaction::Begin);
+    OperationRequest *commit = requests.Acquire(1, transaction::Commit);
+    std::vector<OperationRequest *> read_requests;
+    for (size_t i = 0; i < reads; i++)
+    {
+        read_requests.push_back(requests.Acquire(1,
+                                                 kTable,
+                                                 std::make_unique<IntKey>(i),
+                                                 std::make_unique<IntRecord>(0),
+                                                 transaction::Read));
+    }
+
+    size_t allocations = AllocationCount();
+    for (auto _ : state)
+    {
+        execution.Reset();
+        execution.SetCurrentRequest(begin);
+        execution.Begin(0);
+        RunToIdle(execution);
+        for (OperationRequest *read : read_requests)
+        {
+            execution.SetCurrentRequest(read);
+            execution.Read(&read->table_name_,
+                           read->key_.get(),
+                           read->record_.get(),
+                           nullptr);
+            RunToIdle(execution);
+        }
+        execution.SetCurrentRequest(commit);
+        execution.Commit();
+        RunToIdle(execution);
+        benchmark::DoNotOptimize(execution.GetTxnStatus());
+    }
+    state.counters["allocs"] = benchmark::Counter(
+        AllocationCount() - allocations, benchmark::Counter::kAvgIterations);
+
+    begin->Release();
+    commit->Release();
+    for (OperationRequest *read : read_requests)
+    {
+        read->Release();
+    }
+}
+BENCHMARK(BM_MoveForwardReadTxn)->Arg(1)->Arg(16)->Arg(128);
+
+// LaunchRequests placing a batch of Begin requests into task slots; the
+// transactions are committed with the timer stopped.
+static void BM_LaunchRequests(benchmark::State &state)
+{
+    uint32_t concurrent_txn_count = state.range(0);
+    memory::InMemoryVersionDb db;
+    transaction::SimpleTxnIDGeneratorFactory id_factory(1);
+    transaction::RuntimeTransactionExecutor executor(
+        0,
+        concurrent_txn_count,
+        id_factory.GetTxnIDGenerator(0),
+        db.MakeHandler(),
+        std::make_unique<transaction::LocalTimeProvider>(),
+        nullptr,
+        1 << 16);
+    OperationRequestPool requests(4 * concurrent_txn_count);
+    std::vector<OperationRequest *> acquired;
+    int64_t session_id = 0;
+
+    for (auto _ : state)
+    {
+        int64_t first_session_id = session_id;
+        for (uint32_t i = 0; i < concurrent_txn_count; i++)
+        {
+            OperationRequest *begin =
+                requests.Acquire(session_id++, transaction::Begin);
+            executor.Submit(begin);
+        }
+        executor.LaunchRequests();
+
+        state.PauseTiming();
+        for (int64_t s = first_session_id; s < session_id; s++)
+        {
+            executor.Submit(requests.Acquire(s, transaction::Commit));
+        }
+        executor.Run();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * concurrent_txn_count);
+}
+BENCHMARK(BM_LaunchRequests)->Arg(16)->Arg(256)->Arg(4096);
+
+// a client acquiring a pooled request, the executor answering it through a
+// Result, and the client waiting for and releasing it.
+static void BM_RequestRoundTrip(benchmark::State &state)
+{
+    OperationRequestPool requests(64);
+    Result result;
+    size_t allocations = AllocationCount();
+    for (auto _ : state)
+    {
+        OperationRequest *request = requests.Acquire(1, transaction::Commit);
+        request->AddRef();
+        result.Reset(request);
+        result.SetStatus(TxnStatus::kCommitted);
+        request->Release();
+        request->Wait();
+        benchmark::DoNotOptimize(request->GetResult()->IsCommitted());
+        request->Release();
+    }
+    state.counters["allocs"] = benchmark::Counter(
+        AllocationCount() - allocations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RequestRoundTrip);
+
+// the same through a shared_ptr request, as before requests were pooled.
+static void BM_SharedRequestRoundTrip(benchmark::State &state)
+{
+    Result result;
+    size_t allocations = AllocationCount();
+    for (auto _ : state)
+    {
+        auto shared = std::make_shared<OperationRequest>(1, transaction::Commit);
+        OperationRequest *request = OperationRequest::Adopt(shared);
+        result.Reset(request);
+        result.SetStatus(TxnStatus::kCommitted);
+        request->Release();
+        shared->Wait();
+        benchmark::DoNotOptimize(shared->GetResult()->IsCommitted());
+    }
+    state.counters["allocs"] = benchmark::Counter(
+        AllocationCount() - allocations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SharedRequestRoundTrip);
+}  // namespace txservice::bench
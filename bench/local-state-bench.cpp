@@ -0,0 +1,154 @@
+// LocalState write set build and scan, slab pools against the previous
+// one-entry-at-a-time layout. Besides time, every benchmark reports the heap
+// allocations per transaction; cache misses can be added with
+// --benchmark_perf_counters=CACHE-MISSES when Google Benchmark is built with
+// libpfm.
+#include <benchmark/benchmark.h>
+#include "alloc-counter.h"
+#include "transaction/local-state.h"
+
+namespace txservice::bench
+{
+using transaction::LocalState;
+
+namespace
+{
+// the pool layout before slabs: three heap objects per slot, growing by one.
+struct LegacyWriteSetPool
+{
+    struct Entry
+    {
+        std::unique_ptr<LocalState::SetKey> key_;
+        std::unique_ptr<WriteSetEntry> entry_;
+    };
+
+    explicit LegacyWriteSetPool(size_t capacity) : pop_index_(0)
+    {
+        while (pool_.size() < capacity)
+        {
+            Resize();
+        }
+    }
+
+    void Resize()
+    {
+        auto entry = std::make_unique<Entry>();
+        entry->key_ = std::make_unique<LocalState::SetKey>();
+        entry->entry_ = std::make_unique<WriteSetEntry>();
+        pool_.push_back(std::move(entry));
+    }
+
+    void Insert(TableName *table_name, Key *key, int64_t version)
+    {
+        if (pop_index_ == pool_.size())
+        {
+            Resize();
+        }
+        Entry *entry = pool_[pop_index_++].get();
+        entry->key_->Reset(table_name, key);
+        entry->entry_->Reset(version, false, nullptr, nullptr);
+    }
+
+    std::vector<std::unique_ptr<Entry>> pool_;
+    size_t pop_index_;
+};
+
+std::vector<IntKey> MakeKeys(size_t count)
+{
+    std::vector<IntKey> keys;
+    for (size_t i = 0; i < count; i++)
+    {
+        keys.emplace_back(i);
+    }
+    return keys;
+}
+
+// capacity TransactionExecution starts its LocalState with.
+constexpr size_t kInitialCapacity = 10;
+}  // namespace
+
+static void BM_LegacyWriteSetBuildAndScan(benchmark::State &state)
+{
+    size_t count = state.range(0);
+    TableName table_name = "bench";
+    std::vector<IntKey> keys = MakeKeys(count);
+    size_t allocations = AllocationCount();
+    for (auto _ : state)
+    {
+        LegacyWriteSetPool pool(kInitialCapacity);
+        for (size_t i = 0; i < count; i++)
+        {
+            pool.Insert(&table_name, &keys[i], i);
+        }
+        int64_t sum = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            sum += pool.pool_[i]->entry_->version_;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.counters["allocs"] = benchmark::Counter(
+        AllocationCount() - allocations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_LegacyWriteSetBuildAndScan)->Arg(16)->Arg(256)->Arg(5000);
+
+static void BM_SlabWriteSetBuildAndScan(benchmark::State &state)
+{
+    size_t count = state.range(0);
+    TableName table_name = "bench";
+    std::vector<IntKey> keys = MakeKeys(count);
+    size_t allocations = AllocationCount();
+    for (auto _ : state)
+    {
+        LocalState local_state(kInitialCapacity);
+        for (size_t i = 0; i < count; i++)
+        {
+            local_state.InsertWriteSet(
+                &table_name, &keys[i], i, false, nullptr, nullptr);
+        }
+        LocalState::WriteSet *write_set = local_state.GetAllWriteSet();
+        int64_t sum = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            sum += (*write_set)[i].entry_.version_;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.counters["allocs"] = benchmark::Counter(
+        AllocationCount() - allocations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SlabWriteSetBuildAndScan)->Arg(16)->Arg(256)->Arg(5000);
+
+// read and write sets of count keys each, then every key looked up in both,
+// as Insert/Update and SetCommitTsOperation do. Crosses the threshold above
+// which lookups go through the hash index.
+static void BM_LocalStateInsertAndFind(benchmark::State &state)
+{
+    size_t count = state.range(0);
+    TableName table_name = "bench";
+    std::vector<IntKey> keys = MakeKeys(count);
+    LocalState local_state(kInitialCapacity);
+    size_t allocations = AllocationCount();
+    for (auto _ : state)
+    {
+        local_state.Reset();
+        for (size_t i = 0; i < count; i++)
+        {
+            LocalState::KeyReadSetEntry *read = local_state.InsertReadSet();
+            read->key_.Reset(&table_name, &keys[i]);
+            local_state.InsertWriteSet(
+                &table_name, &keys[i], i, false, nullptr, &read->entry_);
+        }
+        size_t found = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            found += local_state.FindInReadSet(table_name, keys[i]) != nullptr;
+            found += local_state.FindInWriteSet(table_name, keys[i]) != nullptr;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.counters["allocs"] = benchmark::Counter(
+        AllocationCount() - allocations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_LocalStateInsertAndFind)->Arg(8)->Arg(64)->Arg(1024);
+}  // namespace txservice::bench
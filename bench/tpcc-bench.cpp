@@ -0,0 +1,229 @@
+// Simplified TPC-C NewOrder and Payment against both executors over the
+// in-memory version db. Rows are IntRecords under composite IntKeys, the
+// scale is cut down (kItemCount items, kCustomerPerDistrict customers per
+// district) and the mix is one NewOrder per Payment, so that a run stays
+// short while keeping the warehouse and district hot spots of the real mix.
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include "transaction/all-at-once-transaction-executor.h"
+#include "transaction/runtime-transaction-executor.h"
+#include "workload.h"
+
+namespace txservice::bench
+{
+using transaction::AllAtOnceTransactionExecutor;
+using transaction::RuntimeTransactionExecutor;
+
+namespace
+{
+constexpr int64_t kDistrictPerWarehouse = 10;
+constexpr int64_t kCustomerPerDistrict = 300;
+constexpr int64_t kItemCount = 1000;
+constexpr size_t kLoadBatch = 100;
+constexpr size_t kBatchPerSlot = 4;
+
+const TableName kWarehouse = "warehouse";
+const TableName kDistrict = "district";
+const TableName kCustomer = "customer";
+const TableName kItem = "item";
+const TableName kStock = "stock";
+const TableName kOrder = "orders";
+const TableName kNewOrder = "new_order";
+const TableName kOrderLine = "order_line";
+const TableName kHistory = "history";
+
+int64_t DistrictKey(int64_t w, int64_t d)
+{
+    return w * kDistrictPerWarehouse + d;
+}
+
+int64_t CustomerKey(int64_t w, int64_t d, int64_t c)
+{
+    return DistrictKey(w, d) * kCustomerPerDistrict + c;
+}
+
+int64_t StockKey(int64_t w, int64_t i)
+{
+    return w * kItemCount + i;
+}
+
+template <typename Executor>
+class Tpcc
+{
+public:
+    Tpcc(int64_t warehouse_count, uint32_t concurrent_txn_count)
+        : driver_({kWarehouse,
+                   kDistrict,
+                   kCustomer,
+                   kItem,
+                   kStock,
+                   kOrder,
+                   kNewOrder,
+                   kOrderLine,
+                   kHistory},
+                  concurrent_txn_count),
+          warehouse_count_(warehouse_count),
+          random_(42),
+          next_order_id_(0),
+          next_history_id_(0)
+    {
+    }
+
+    bool Load()
+    {
+        transactions_ = 0;
+        LoadTable(kWarehouse, warehouse_count_);
+        LoadTable(kDistrict, warehouse_count_ * kDistrictPerWarehouse);
+        LoadTable(kCustomer,
+                  warehouse_count_ * kDistrictPerWarehouse *
+                      kCustomerPerDistrict);
+        LoadTable(kItem, kItemCount);
+        LoadTable(kStock, warehouse_count_ * kItemCount);
+        return driver_.Drain() == transactions_;
+    }
+
+    void NewOrder()
+    {
+        int64_t w = Uniform(0, warehouse_count_ - 1);
+        int64_t d = Uniform(0, kDistrictPerWarehouse - 1);
+        int64_t c = Uniform(0, kCustomerPerDistrict - 1);
+        int64_t order_id = next_order_id_++;
+        int64_t line_count = Uniform(5, 15);
+
+        int64_t s = driver_.Begin();
+        driver_.Submit(s, kWarehouse, w, 0, transaction::Read);
+        driver_.Submit(s, kDistrict, DistrictKey(w, d), 0, transaction::Read);
+        // d_next_o_id + 1
+        driver_.Submit(
+            s, kDistrict, DistrictKey(w, d), order_id, transaction::Update);
+        driver_.Submit(
+            s, kCustomer, CustomerKey(w, d, c), 0, transaction::Read);
+        driver_.Submit(s, kOrder, order_id, line_count, transaction::Insert);
+        driver_.Submit(s, kNewOrder, order_id, 0, transaction::Insert);
+        items_.clear();
+        while (items_.size() < static_cast<size_t>(line_count))
+        {
+            int64_t i = Uniform(0, kItemCount - 1);
+            if (std::find(items_.begin(), items_.end(), i) != items_.end())
+            {
+                continue;
+            }
+            items_.push_back(i);
+            driver_.Submit(s, kItem, i, 0, transaction::Read);
+            driver_.Submit(s, kStock, StockKey(w, i), 0, transaction::Read);
+            // s_quantity - ol_quantity
+            driver_.Submit(
+                s, kStock, StockKey(w, i), order_id, transaction::Update);
+            driver_.Submit(s,
+                           kOrderLine,
+                           order_id * 16 + items_.size(),
+                           i,
+                           transaction::Insert);
+        }
+        driver_.Commit(s);
+    }
+
+    void Payment()
+    {
+        int64_t w = Uniform(0, warehouse_count_ - 1);
+        int64_t d = Uniform(0, kDistrictPerWarehouse - 1);
+        int64_t c = Uniform(0, kCustomerPerDistrict - 1);
+        int64_t amount = Uniform(1, 5000);
+
+        int64_t s = driver_.Begin();
+        // w_ytd, d_ytd and c_balance += amount
+        driver_.Submit(s, kWarehouse, w, 0, transaction::Read);
+        driver_.Submit(s, kWarehouse, w, amount, transaction::Update);
+        driver_.Submit(s, kDistrict, DistrictKey(w, d), 0, transaction::Read);
+        driver_.Submit(
+            s, kDistrict, DistrictKey(w, d), amount, transaction::Update);
+        driver_.Submit(
+            s, kCustomer, CustomerKey(w, d, c), 0, transaction::Read);
+        driver_.Submit(
+            s, kCustomer, CustomerKey(w, d, c), amount, transaction::Update);
+        driver_.Submit(
+            s, kHistory, next_history_id_++, amount, transaction::Insert);
+        driver_.Commit(s);
+    }
+
+    size_t Drain()
+    {
+        return driver_.Drain();
+    }
+
+private:
+    void LoadTable(const TableName &table, int64_t row_count)
+    {
+        for (int64_t key = 0; key < row_count;)
+        {
+            int64_t s = driver_.Begin();
+            for (size_t i = 0; i < kLoadBatch && key < row_count; i++, key++)
+            {
+                driver_.Submit(s, table, key, 0, transaction::Insert);
+            }
+            driver_.Commit(s);
+            transactions_++;
+        }
+    }
+
+    int64_t Uniform(int64_t min, int64_t max)
+    {
+        return std::uniform_int_distribution<int64_t>(min, max)(random_);
+    }
+
+    WorkloadDriver<Executor> driver_;
+    int64_t warehouse_count_;
+    std::mt19937_64 random_;
+    int64_t next_order_id_;
+    int64_t next_history_id_;
+    size_t transactions_;
+    std::vector<int64_t> items_;
+};
+}  // namespace
+
+template <typename Executor>
+static void BM_TpccNewOrderPayment(benchmark::State &state)
+{
+    int64_t warehouse_count = state.range(0);
+    uint32_t concurrent_txn_count = state.range(1);
+    Tpcc<Executor> tpcc(warehouse_count, concurrent_txn_count);
+    if (!tpcc.Load())
+    {
+        state.SkipWithError("loading tpcc tables aborted");
+        return;
+    }
+
+    size_t batch = kBatchPerSlot * concurrent_txn_count;
+    size_t transactions = 0;
+    size_t committed = 0;
+    for (auto _ : state)
+    {
+        for (size_t t = 0; t < batch; t += 2)
+        {
+            tpcc.NewOrder();
+            tpcc.Payment();
+        }
+        committed += tpcc.Drain();
+        transactions += batch;
+    }
+    state.counters["commits"] =
+        benchmark::Counter(committed, benchmark::Counter::kIsRate);
+    state.counters["abort_ratio"] =
+        transactions == 0 ? 0 : 1.0 - static_cast<double>(committed) /
+                                          transactions;
+    state.SetItemsProcessed(transactions);
+}
+
+BENCHMARK_TEMPLATE(BM_TpccNewOrderPayment, RuntimeTransactionExecutor)
+    ->ArgNames({"warehouses", "concurrent_txns"})
+    ->Args({1, 16})
+    ->Args({4, 16})
+    ->Args({4, 64})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_TpccNewOrderPayment, AllAtOnceTransactionExecutor)
+    ->ArgNames({"warehouses", "concurrent_txns"})
+    ->Args({1, 16})
+    ->Args({4, 16})
+    ->Args({4, 64})
+    ->Unit(benchmark::kMicrosecond);
+}  // namespace txservice::bench
@@ -0,0 +1,211 @@
+#ifndef TXSERVICE_BENCH_WORKLOAD_H_
+#define TXSERVICE_BENCH_WORKLOAD_H_
+
+// Building blocks of the workload benchmarks: a Zipfian key chooser and a
+// driver that submits batches of transactions to one executor, backed by an
+// in-memory version db, and runs the executor until they are all answered.
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+#include "memory/in-memory-versiondb.h"
+#include "transaction/operation-request-pool.h"
+#include "transaction/time-provider.h"
+#include "transaction/txn-id-generator-factory.h"
+
+namespace txservice::bench
+{
+/**
+ * Zipfian distribution over [0, item_count) as in YCSB (Gray et al.), with
+ * the popular items scattered over the key space instead of being the
+ * smallest keys.
+ */
+class ZipfianGenerator
+{
+public:
+    static constexpr double kDefaultTheta = 0.99;
+
+    explicit ZipfianGenerator(uint64_t item_count,
+                              double theta = kDefaultTheta,
+                              uint64_t seed = 42)
+        : item_count_(item_count), theta_(theta), random_(seed)
+    {
+        zeta_n_ = Zeta(item_count_, theta_);
+        double zeta_2 = Zeta(2, theta_);
+        alpha_ = 1.0 / (1.0 - theta_);
+        eta_ = (1 - std::pow(2.0 / item_count_, 1 - theta_)) /
+               (1 - zeta_2 / zeta_n_);
+    }
+
+    uint64_t Next()
+    {
+        double u = uniform_(random_);
+        double uz = u * zeta_n_;
+        uint64_t rank;
+        if (uz < 1.0)
+        {
+            rank = 0;
+        }
+        else if (uz < 1.0 + std::pow(0.5, theta_))
+        {
+            rank = 1;
+        }
+        else
+        {
+            rank = static_cast<uint64_t>(
+                item_count_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+        }
+        return Scatter(std::min(rank, item_count_ - 1));
+    }
+
+    /// uniform in [0, 1), from the same source, for choosing operations.
+    double NextUniform()
+    {
+        return uniform_(random_);
+    }
+
+private:
+    static double Zeta(uint64_t n, double theta)
+    {
+        double sum = 0;
+        for (uint64_t i = 1; i <= n; i++)
+        {
+            sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        }
+        return sum;
+    }
+
+    uint64_t Scatter(uint64_t rank) const
+    {
+        // FNV-1a of the rank, as YCSB's ScrambledZipfianGenerator.
+        uint64_t hash = 0xCBF29CE484222325ull;
+        for (int i = 0; i < 8; i++)
+        {
+            hash ^= (rank >> (i * 8)) & 0xFF;
+            hash *= 0x100000001B3ull;
+        }
+        return hash % item_count_;
+    }
+
+    uint64_t item_count_;
+    double theta_;
+    double zeta_n_;
+    double alpha_;
+    double eta_;
+    std::mt19937_64 random_;
+    std::uniform_real_distribution<double> uniform_;
+};
+
+/**
+ * One executor of type Executor over its own in-memory version db. A
+ * transaction is built with Begin, the data operations and Commit, all
+ * submitted up front as a client pipelining its session would; Drain runs
+ * the executor until every submitted transaction has been answered.
+ */
+template <typename Executor>
+class WorkloadDriver
+{
+public:
+    WorkloadDriver(const std::vector<TableName> &tables,
+                   uint32_t concurrent_txn_count,
+                   size_t capacity = 1 << 16)
+        : id_factory_(0, 0), requests_(capacity), next_session_id_(1)
+    {
+        for (const TableName &table : tables)
+        {
+            db_.CreateVersionTable(table);
+        }
+        executor_ = std::make_unique<Executor>(
+            0,
+            concurrent_txn_count,
+            id_factory_.GetTxnIDGenerator(0),
+            db_.MakeHandler(),
+            std::make_unique<transaction::LocalTimeProvider>(),
+            nullptr,
+            capacity);
+    }
+
+    ~WorkloadDriver()
+    {
+        ReleaseAll();
+    }
+
+    Executor &GetExecutor()
+    {
+        return *executor_;
+    }
+
+    /// type is a transaction::TxnType.
+    int64_t Begin(int type = transaction::ReadWriteTxn)
+    {
+        int64_t session_id = next_session_id_++;
+        transaction::OperationRequest *begin =
+            requests_.Acquire(session_id, transaction::Begin);
+        begin->type_ = type;
+        Submit(begin);
+        return session_id;
+    }
+
+    void Submit(int64_t session_id,
+                const TableName &table_name,
+                int64_t key,
+                int64_t value,
+                transaction::OperationType operation_type)
+    {
+        // copied into the key and record the recycled request kept.
+        key_.k = key;
+        record_.data = value;
+        Submit(requests_.Acquire(
+            session_id, table_name, key_, &record_, operation_type));
+    }
+
+    void Commit(int64_t session_id)
+    {
+        transaction::OperationRequest *commit =
+            requests_.Acquire(session_id, transaction::Commit);
+        // the result belongs to the execution, which moves on to another
+        // transaction right after answering, so it is read on completion.
+        commit->OnComplete([this](transaction::OperationRequest *request) {
+            committed_ += request->GetResult()->IsCommitted();
+        });
+        Submit(commit);
+    }
+
+    /// runs the executor until every submitted transaction is answered,
+    /// returns how many of them committed.
+    size_t Drain()
+    {
+        committed_ = 0;
+        executor_->Run();
+        ReleaseAll();
+        return committed_;
+    }
+
+private:
+    void Submit(transaction::OperationRequest *request)
+    {
+        executor_->AddRequest(request);
+        submitted_.push_back(request);
+    }
+
+    void ReleaseAll()
+    {
+        for (transaction::OperationRequest *request : submitted_)
+        {
+            request->Release();
+        }
+        submitted_.clear();
+    }
+
+    memory::InMemoryVersionDb db_;
+    transaction::EpochTxnIDGeneratorFactory id_factory_;
+    transaction::OperationRequestPool requests_;
+    std::unique_ptr<Executor> executor_;
+    std::vector<transaction::OperationRequest *> submitted_;
+    IntKey key_;
+    IntRecord record_ = IntRecord(0);
+    int64_t next_session_id_;
+    size_t committed_ = 0;
+};
+}  // namespace txservice::bench
+#endif  // TXSERVICE_BENCH_WORKLOAD_H_
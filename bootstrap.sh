@@ -16,6 +16,7 @@ vcpkg/vcpkg install protobuf[zlib]
 vcpkg/vcpkg install glog
 vcpkg/vcpkg install leveldb
 vcpkg/vcpkg install snappy
+vcpkg/vcpkg install benchmark
 
 mkdir build && cd build
 cmake ..
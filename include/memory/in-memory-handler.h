@@ -0,0 +1,179 @@
+#ifndef TXSERVICE_MEMORY_IN_MEMORY_HANDLER_H_
+#define TXSERVICE_MEMORY_IN_MEMORY_HANDLER_H_
+
+#include "memory/in-memory-versiondb.h"
+#include "versiondb/request/handler.h"
+
+namespace txservice::memory
+{
+/// iterates over a snapshot of keys copied out of a version table.
+class SnapshotKeyIterator : public txcheckpoint::KeyIterator
+{
+public:
+    SnapshotKeyIterator(std::vector<Key::Pointer> keys, void *key_deserializer)
+        : txcheckpoint::KeyIterator(key_deserializer), index_(0)
+    {
+        key_container = std::move(keys);
+    }
+
+    virtual bool HasNext() override
+    {
+        return index_ < key_container.size();
+    }
+
+    virtual Key &Next() override
+    {
+        return *key_container[index_++];
+    }
+
+private:
+    size_t index_;
+};
+
+/**
+ * Handler over an InMemoryVersionDb. Every request is served synchronously
+ * on the calling thread, the HandlerResult is finished before returning.
+ */
+class InMemoryHandler : public request::Handler
+{
+public:
+    explicit InMemoryHandler(InMemoryVersionDb *db) : db_(db)
+    {
+    }
+
+    virtual void UploadVersion(const TableName &table_name,
+                               const Key &key,
+                               VersionEntry &version_entry,
+                               EntryExtension *extension,
+                               request::HandlerResult<int64_t> &) override;
+
+    virtual void DeleteVersion(const TableName &table_name,
+                               const Key &key,
+                               int64_t version_key,
+                               EntryExtension *extension,
+                               request::HandlerResult<Void> &) override;
+
+    virtual void CleanStaleVersion(const TableName &table_name,
+                                   int64_t end_time,
+                                   request::HandlerResult<Void> &) override;
+
+    virtual void CleanStaleTxn(int64_t end_time,
+                               request::HandlerResult<Void> &) override;
+
+    virtual void InitVersionList(const TableName &table_name,
+                                 const Key &key,
+                                 VersionEntry &version_entry,
+                                 request::HandlerResult<bool> &) override;
+
+    virtual void CommitVersion(const TableName &table_name,
+                               const Key &key,
+                               int64_t version_key,
+                               int64_t expect_txn_id,
+                               int64_t target_begin_ts,
+                               int64_t target_end_ts,
+                               int64_t target_tx_id,
+                               EntryExtension *extension,
+                               request::HandlerResult<Void> &,
+                               Record *record = nullptr,
+                               bool commited = false) override;
+
+    virtual void UpdateMaxCommitTsAndReread(
+        const TableName &table_name,
+        const Key &key,
+        int64_t version_key,
+        int64_t max_commit_ts,
+        EntryExtension *extension,
+        request::HandlerResult<VersionEntry> &) override;
+
+    virtual void ReleaseReadCounter(const TableName &table_name,
+                                    const Key &key,
+                                    int64_t version_key,
+                                    EntryExtension *extension,
+                                    request::HandlerResult<Void> &) override;
+
+    virtual void GetVersionList(
+        const TableName &table_name,
+        const Key &key,
+        const int64_t time,
+        request::HandlerResult<std::vector<VersionEntry>> &,
+        void *) override;
+
+    virtual void GetTxn(int64_t txn_id,
+                        request::HandlerResult<TxnEntry> &) override;
+
+    virtual void NewTxn(TxnEntry &entry,
+                        int64_t local_time,
+                        int64_t max_txn_execution_time_ms,
+                        request::HandlerResult<Void> &) override;
+
+    virtual void SetCommitTimestamp(int64_t txn_id,
+                                    int64_t commit_ts,
+                                    EntryExtension *extension,
+                                    request::HandlerResult<int64_t> &) override;
+
+    virtual void UpdateCommitLowerBound(
+        int64_t txn_id,
+        int64_t commit_ts_lower_bound,
+        request::HandlerResult<TxnEntry> &) override;
+
+    virtual void UpdateTxnStatus(int64_t txn_id,
+                                 TxnStatus status,
+                                 EntryExtension *extension,
+                                 request::HandlerResult<Void> &) override;
+
+    using request::Handler::GetAllCurrentKeys;
+
+    virtual txcheckpoint::KeyIterator::Pointer GetAllCurrentKeys(
+        const TableName &, void *) override;
+
+    virtual txcheckpoint::KeyIterator::Pointer GetPartitionKeys(
+        const TableName &, int, void *) override;
+
+    virtual txcheckpoint::KeyIterator::Pointer GetCheckpointKeys(
+        TableName &, int, int64_t, void *) override;
+
+    virtual void CheckRemoveActEntry(TableName &,
+                                     int,
+                                     Key *,
+                                     int64_t,
+                                     request::HandlerResult<Void> &) override;
+
+    virtual void KickoutVersion(const TableName &,
+                                const Key *,
+                                int64_t,
+                                int64_t,
+                                int64_t,
+                                request::HandlerResult<bool> &) override;
+
+    virtual void GetVisibleVersionPromise(
+        const TableName &table_name,
+        const Key &key,
+        request::HandlerResult<VersionEntry> &,
+        void *) override;
+
+    virtual void GetSnapshotVersion(const TableName &table_name,
+                                    const Key &key,
+                                    int64_t read_ts,
+                                    request::HandlerResult<VersionEntry> &,
+                                    void *) override;
+
+    virtual size_t PartitionOf(const TableName &table_name,
+                               const Key &key) override;
+
+private:
+    // copies the version into the entry; the committed record is only
+    // copied when asked for, since the entries of a version list share the
+    // caller's record buffer.
+    static void CopyOut(const VersionCell &cell,
+                        VersionEntry &entry,
+                        bool with_record = false);
+    static void CopyOut(const TxnEntry &from, TxnEntry &to);
+    // makes the writer of a dirty version commit after read_ts, if it has
+    // not picked its commit timestamp yet; false if it picked one at or
+    // before read_ts, the outcome of which is still open.
+    bool PushWriterPast(int64_t txn_id, int64_t read_ts);
+
+    InMemoryVersionDb *db_;
+};
+}  // namespace txservice::memory
+#endif  // TXSERVICE_MEMORY_IN_MEMORY_HANDLER_H_
@@ -0,0 +1,198 @@
+#ifndef TXSERVICE_MEMORY_IN_MEMORY_VERSIONDB_H_
+#define TXSERVICE_MEMORY_IN_MEMORY_VERSIONDB_H_
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include "versiondb/versiondb.h"
+
+namespace txservice::memory
+{
+/// a single version of a key, owning a copy of its committed record.
+struct VersionCell
+{
+    VersionCell(int64_t version,
+                int64_t tx_id,
+                int64_t begin_ts,
+                int64_t end_ts,
+                bool is_deleted)
+        : version_(version),
+          tx_id_(tx_id),
+          begin_ts_(begin_ts),
+          end_ts_(end_ts),
+          max_commit_ts_(VersionEntry::kDefaultMaxTs),
+          is_deleted_(is_deleted),
+          record_(nullptr)
+    {
+    }
+
+    bool IsCommitted() const
+    {
+        return end_ts_ != VersionEntry::kDefaultEndTs;
+    }
+
+    int64_t version_;
+    int64_t tx_id_;
+    int64_t begin_ts_;
+    int64_t end_ts_;
+    int64_t max_commit_ts_;
+    bool is_deleted_;
+    Record::Pointer record_;
+};
+
+/// versions of one key, ordered by version number (oldest first).
+struct VersionList
+{
+    VersionCell *Find(int64_t version);
+    VersionCell *Latest();
+
+    /// owns the key the partition map is indexed by.
+    Key::Pointer key_;
+    std::deque<VersionCell> versions_;
+    int64_t read_count_ = 0;
+};
+
+struct KeyHash
+{
+    size_t operator()(const Key *key) const
+    {
+        return key->Hash();
+    }
+};
+
+struct KeyEqual
+{
+    bool operator()(const Key *lhs, const Key *rhs) const
+    {
+        return *lhs == *rhs;
+    }
+};
+
+/// one shard of a version table. Shards are aligned to a cache line so that
+/// executors hammering different shards never share a line of mutex state.
+struct alignas(Constant::CACHE_LINE_SIZE) VersionPartition
+{
+    VersionList *Find(const Key &key);
+    // creates the list holding only the initial pseudo version if absent.
+    VersionList &FindOrInit(const Key &key);
+
+    std::mutex mutex_;
+    std::unordered_map<const Key *, VersionList, KeyHash, KeyEqual> lists_;
+};
+
+class VersionTable
+{
+public:
+    using Pointer = std::unique_ptr<VersionTable>;
+
+    explicit VersionTable(size_t partition_count);
+
+    VersionPartition &GetPartition(const Key &key)
+    {
+        return partitions_[key.Hash() % partition_count_];
+    }
+
+    VersionPartition &GetPartition(size_t idx)
+    {
+        return partitions_[idx];
+    }
+
+    size_t GetPartitionCount() const
+    {
+        return partition_count_;
+    }
+
+    void Clear();
+
+private:
+    size_t partition_count_;
+    std::unique_ptr<VersionPartition[]> partitions_;
+};
+
+struct TxnCell
+{
+    TxnEntry entry_;
+    int64_t begin_time_;
+};
+
+struct alignas(Constant::CACHE_LINE_SIZE) TxnPartition
+{
+    std::mutex mutex_;
+    std::unordered_map<int64_t, TxnCell> txns_;
+};
+
+class TxnTable
+{
+public:
+    explicit TxnTable(size_t partition_count);
+
+    TxnPartition &GetPartition(int64_t txn_id)
+    {
+        return partitions_[static_cast<uint64_t>(txn_id) % partition_count_];
+    }
+
+    TxnPartition &GetPartition(size_t idx)
+    {
+        return partitions_[idx];
+    }
+
+    size_t GetPartitionCount() const
+    {
+        return partition_count_;
+    }
+
+    void Clear();
+
+private:
+    size_t partition_count_;
+    std::unique_ptr<TxnPartition[]> partitions_;
+};
+
+/**
+ * A process-local version db. All handlers made by it share the same
+ * partitioned version and transaction tables, so executors on different
+ * threads see each other's versions without any network round-trip.
+ */
+class InMemoryVersionDb : public VersionDb
+{
+public:
+    InMemoryVersionDb(
+        size_t partition_count = Constant::ACTIVE_SET_PARTITION);
+
+    virtual request::Handler::Pointer MakeHandler() override;
+
+    virtual bool CreateVersionTable(const TableName &table_name) override;
+
+    virtual bool DropVersionTable(const TableName &table_name) override;
+
+    virtual bool ClearTransactions() override;
+
+    virtual bool ClearVersions() override;
+
+    // walks every partition, keys and records counted at their serialized
+    // length.
+    virtual size_t VersionMemoryUsage() override;
+
+    // returns nullptr if the table has not been created. Tables are not
+    // expected to be dropped while transactions are running on them.
+    VersionTable *GetVersionTable(const TableName &table_name);
+
+    TxnTable &GetTxnTable()
+    {
+        return txn_table_;
+    }
+
+    size_t GetPartitionCount() const
+    {
+        return partition_count_;
+    }
+
+private:
+    size_t partition_count_;
+    std::shared_mutex table_mutex_;
+    std::unordered_map<TableName, VersionTable::Pointer> version_tables_;
+    TxnTable txn_table_;
+};
+}  // namespace txservice::memory
+#endif  // TXSERVICE_MEMORY_IN_MEMORY_VERSIONDB_H_
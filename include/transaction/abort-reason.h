@@ -0,0 +1,60 @@
+#ifndef TXSERVICE_TRANSACTION_ABORT_REASON_H_
+#define TXSERVICE_TRANSACTION_ABORT_REASON_H_
+
+#include <stddef.h>
+
+namespace txservice::transaction
+{
+/// why a transaction aborted; the first cause found wins.
+enum class AbortReason
+{
+    kNone,
+    // UploadVersion found a newer or uncommitted version of a written key.
+    kWriteWriteConflict,
+    // a read version could not be reread during validation.
+    kReadValidationFailed,
+    // a read version was overwritten before the commit timestamp.
+    kReadVersionOverwritten,
+    // the writer holding a read version committed before us, or could not be
+    // pushed past our commit timestamp.
+    kConflictTxnCommitted,
+    // the commit timestamp was rejected by the txn table.
+    kSetCommitTsFailed,
+    kClientAbort,
+    // a StepOperation protocol failed.
+    kProtocolFailure,
+    // NewTxn rejected the txn entry, e.g. its id is held by a live txn.
+    kNewTxnFailed,
+    kCount
+};
+
+constexpr size_t kAbortReasonCount = static_cast<size_t>(AbortReason::kCount);
+
+inline const char *AbortReasonName(AbortReason reason)
+{
+    switch (reason)
+    {
+    case AbortReason::kNone:
+        return "None";
+    case AbortReason::kWriteWriteConflict:
+        return "WriteWriteConflict";
+    case AbortReason::kReadValidationFailed:
+        return "ReadValidationFailed";
+    case AbortReason::kReadVersionOverwritten:
+        return "ReadVersionOverwritten";
+    case AbortReason::kConflictTxnCommitted:
+        return "ConflictTxnCommitted";
+    case AbortReason::kSetCommitTsFailed:
+        return "SetCommitTsFailed";
+    case AbortReason::kClientAbort:
+        return "ClientAbort";
+    case AbortReason::kProtocolFailure:
+        return "ProtocolFailure";
+    case AbortReason::kNewTxnFailed:
+        return "NewTxnFailed";
+    default:
+        return "Unknown";
+    }
+}
+}  // namespace txservice::transaction
+#endif  // TXSERVICE_TRANSACTION_ABORT_REASON_H_
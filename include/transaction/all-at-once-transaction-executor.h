@@ -1,6 +1,7 @@
 #ifndef TXSERVICE_TRANSACTION_ALL_AT_ONCE_TRANSACTION_EXECUTOR_H_
 #define TXSERVICE_TRANSACTION_ALL_AT_ONCE_TRANSACTION_EXECUTOR_H_
 
+#include "transaction/ready-queue.h"
 #include "transaction/time-provider.h"
 #include "transaction/transaction-execution.h"
 #include "transaction/transaction-executor.h"
@@ -21,22 +22,24 @@ public:
                         txlog::TxLog *tx_log,
                         size_t capacity);
     virtual void Run() override;
-    virtual void AddRequest(
-        std::shared_ptr<OperationRequest> operation_request) override;
+    virtual void Submit(OperationRequest *operation_request) override;
     void LaunchRequests();
     void Advance();
     virtual bool IsFinished() override;
     virtual void ShutDown() override;
-    virtual void Statistics(int &commit, int &abort) override;
+    virtual void SetCommitProtocol(
+        const StepOperation::Steps *protocol) override;
+    virtual void SetChangeFeed(txckpt::ChangeFeed *change_feed) override;
 
 public:
     uint32_t concurrent_txn_count_;
     std::vector<TransactionTask> active_txn_;
     int active_txn_number_;
-    std::vector<std::shared_ptr<OperationRequest>>
-        request_queue_pool_;
+    std::vector<OperationRequest *> request_queue_pool_;
     size_t push_index_;
-    size_t pop_index_;
+    size_t pop_index_;    // slots with progress to make, only these are run by Advance.
+    ReadyQueue ready_queue_;
+    std::vector<int32_t> ready_tasks_;
 };
 }  // namespace txservice::transaction
 #endif  // TXSERVICE_TRANSACTION_ALL_AT_ONCE_TRANSACTION_EXECUTOR_H_
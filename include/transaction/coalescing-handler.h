@@ -0,0 +1,223 @@
+#ifndef TXSERVICE_TRANSACTION_COALESCING_HANDLER_H_
+#define TXSERVICE_TRANSACTION_COALESCING_HANDLER_H_
+
+#include <atomic>
+#include <unordered_map>
+#include "versiondb/request/handler.h"
+
+namespace txservice::transaction
+{
+/**
+ * Sits between the transactions of one executor and its backend handler.
+ * Commit-path calls made during an Advance pass are held back until
+ * SendBatch. Uploads, rereads and version commits go out as one batched call
+ * per type, sorted so that the keys of a partition are next to each other.
+ * GetTxn and UpdateCommitLowerBound calls for the same transaction are
+ * merged into one call whose answer is copied to every caller. All other
+ * calls go straight through.
+ */
+class CoalescingHandler : public request::Handler
+{
+public:
+    explicit CoalescingHandler(request::Handler::Pointer handler);
+
+    request::Handler *GetBackend()
+    {
+        return handler_.get();
+    }
+
+    virtual void UploadVersion(const TableName &table_name,
+                               const Key &key,
+                               VersionEntry &version_entry,
+                               EntryExtension *extension,
+                               request::HandlerResult<int64_t> &) override;
+
+    virtual void DeleteVersion(const TableName &table_name,
+                               const Key &key,
+                               int64_t version_key,
+                               EntryExtension *extension,
+                               request::HandlerResult<Void> &) override;
+
+    virtual void CleanStaleVersion(const TableName &table_name,
+                                   int64_t end_time,
+                                   request::HandlerResult<Void> &) override;
+
+    virtual void CleanStaleTxn(int64_t end_time,
+                               request::HandlerResult<Void> &) override;
+
+    virtual void InitVersionList(const TableName &table_name,
+                                 const Key &key,
+                                 VersionEntry &version_entry,
+                                 request::HandlerResult<bool> &) override;
+
+    virtual void CommitVersion(const TableName &table_name,
+                               const Key &key,
+                               int64_t version_key,
+                               int64_t expect_txn_id,
+                               int64_t target_begin_ts,
+                               int64_t target_end_ts,
+                               int64_t target_tx_id,
+                               EntryExtension *extension,
+                               request::HandlerResult<Void> &,
+                               Record *record = nullptr,
+                               bool commited = false) override;
+
+    virtual void UpdateMaxCommitTsAndReread(
+        const TableName &table_name,
+        const Key &key,
+        int64_t version_key,
+        int64_t max_commit_ts,
+        EntryExtension *extension,
+        request::HandlerResult<VersionEntry> &) override;
+
+    virtual void ReleaseReadCounter(const TableName &table_name,
+                                    const Key &key,
+                                    int64_t version_key,
+                                    EntryExtension *extension,
+                                    request::HandlerResult<Void> &) override;
+
+    virtual void GetVersionList(
+        const TableName &table_name,
+        const Key &key,
+        const int64_t time,
+        request::HandlerResult<std::vector<VersionEntry>> &,
+        void *) override;
+
+    virtual void GetTxn(int64_t txn_id,
+                        request::HandlerResult<TxnEntry> &) override;
+
+    virtual void NewTxn(TxnEntry &entry,
+                        int64_t local_time,
+                        int64_t max_txn_execution_time_ms,
+                        request::HandlerResult<Void> &) override;
+
+    virtual void SetCommitTimestamp(int64_t txn_id,
+                                    int64_t commit_ts,
+                                    EntryExtension *extension,
+                                    request::HandlerResult<int64_t> &) override;
+
+    virtual void UpdateCommitLowerBound(
+        int64_t txn_id,
+        int64_t commit_ts_lower_bound,
+        request::HandlerResult<TxnEntry> &) override;
+
+    virtual void UpdateTxnStatus(int64_t txn_id,
+                                 TxnStatus status,
+                                 EntryExtension *extension,
+                                 request::HandlerResult<Void> &) override;
+
+    virtual void GetAllCurrentKeys(
+        int64_t txn_id,
+        const TableName &table_name,
+        request::HandlerResult<std::vector<StringKey>> &) override;
+
+    virtual txcheckpoint::KeyIterator::Pointer GetAllCurrentKeys(
+        const TableName &, void *) override;
+
+    virtual txcheckpoint::KeyIterator::Pointer GetPartitionKeys(
+        const TableName &, int, void *) override;
+
+    virtual void InsertRangeEntry(int64_t txn_id,
+                                  const TableName &table_name,
+                                  const std::string &range,
+                                  int64_t commit_ts,
+                                  request::HandlerResult<Void> &) override;
+
+    virtual void UpdateRangeEntry(int64_t txn_id,
+                                  int64_t commit_ts,
+                                  request::HandlerResult<Void> &) override;
+
+    virtual txcheckpoint::KeyIterator::Pointer GetCheckpointKeys(
+        TableName &, int, int64_t, void *) override;
+
+    virtual void CheckRemoveActEntry(TableName &,
+                                     int,
+                                     Key *,
+                                     int64_t,
+                                     request::HandlerResult<Void> &) override;
+
+    virtual void KickoutVersion(const TableName &,
+                                const Key *,
+                                int64_t,
+                                int64_t,
+                                int64_t,
+                                request::HandlerResult<bool> &) override;
+
+    virtual void GetVisibleVersionPromise(
+        const TableName &table_name,
+        const Key &key,
+        request::HandlerResult<VersionEntry> &,
+        void *) override;
+
+    virtual void GetSnapshotVersion(const TableName &table_name,
+                                    const Key &key,
+                                    int64_t read_ts,
+                                    request::HandlerResult<VersionEntry> &,
+                                    void *) override;
+
+    virtual size_t PartitionOf(const TableName &table_name,
+                               const Key &key) override;
+
+    virtual void MultiUploadVersion(
+        const std::vector<request::UploadVersionRequest> &requests) override;
+
+    virtual void MultiUpdateMaxCommitTsAndReread(
+        const std::vector<request::UpdateMaxCommitTsRequest> &requests)
+        override;
+
+    virtual void MultiCommitVersion(
+        const std::vector<request::CommitVersionRequest> &requests) override;
+
+    /// sends everything held back since the last call, then flushes the
+    /// backend.
+    virtual void SendBatch() override;
+
+private:
+    template <typename T>
+    struct Pending
+    {
+        size_t partition_;
+        T request_;
+    };
+
+    // one backend call answering every caller asking about txn_id_.
+    struct TxnLookup : public request::CompletionListener
+    {
+        virtual void OnCompletion() override;
+
+        int64_t txn_id_;
+        // UpdateCommitLowerBound to lower_bound_ rather than GetTxn.
+        bool push_lower_bound_;
+        int64_t lower_bound_;
+        std::vector<request::HandlerResult<TxnEntry> *> callers_;
+        request::HandlerResult<TxnEntry> result_;
+        std::atomic<bool> done_;
+    };
+
+    template <typename T>
+    static void SortByPartition(std::vector<Pending<T>> &pending,
+                                std::vector<T> &requests);
+
+    TxnLookup *FindOrAddLookup(
+        std::unordered_map<int64_t, TxnLookup *> &lookups,
+        int64_t txn_id,
+        bool push_lower_bound);
+    void ReclaimLookups();
+
+    request::Handler::Pointer handler_;
+    std::vector<Pending<request::UploadVersionRequest>> uploads_;
+    std::vector<Pending<request::UpdateMaxCommitTsRequest>> rereads_;
+    std::vector<Pending<request::CommitVersionRequest>> commits_;
+    std::vector<request::UploadVersionRequest> upload_batch_;
+    std::vector<request::UpdateMaxCommitTsRequest> reread_batch_;
+    std::vector<request::CommitVersionRequest> commit_batch_;
+    // lookups of the current pass, by transaction id.
+    std::unordered_map<int64_t, TxnLookup *> get_txn_lookups_;
+    std::unordered_map<int64_t, TxnLookup *> lower_bound_lookups_;
+    std::vector<std::unique_ptr<TxnLookup>> pending_lookups_;
+    // sent lookups, kept until their answer has been handed out.
+    std::vector<std::unique_ptr<TxnLookup>> sent_lookups_;
+    std::vector<std::unique_ptr<TxnLookup>> free_lookups_;
+};
+}  // namespace txservice::transaction
+#endif  // TXSERVICE_TRANSACTION_COALESCING_HANDLER_H_
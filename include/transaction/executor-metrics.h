@@ -0,0 +1,123 @@
+#ifndef TXSERVICE_TRANSACTION_EXECUTOR_METRICS_H_
+#define TXSERVICE_TRANSACTION_EXECUTOR_METRICS_H_
+
+#include <array>
+#include <atomic>
+#include "transaction/abort-reason.h"
+#include "transaction/hot-key-tracker.h"
+#include "utility/latency-histogram.h"
+
+namespace txservice::transaction
+{
+/// one per TransactionOperation subclass, plus kCommit for the whole commit.
+enum class OperationPhase
+{
+    kReadOutside,
+    kReadSnapshot,
+    kUpload,
+    kUploadVersionEntry,
+    kSetCommitTs,
+    kValidate,
+    kUpdateReadEntryMaxCommitTs,
+    kPushConflictTxnCommitTsLowerBound,
+    kWriteToLog,
+    kUpdateTxnStatusToCommit,
+    kPostProcessingAfterCommit,
+    kPostProcessingCommitEntryAfterCommit,
+    kPostProcessingAfterAbort,
+    kPostProcessingDeleteEntryAfterAbort,
+    kReleaseReadCounter,
+    kReleaseReadCounterForEachEntry,
+    kUpdateTxnStatusToAbort,
+    kInsert,
+    kUpdate,
+    kUpsert,
+    kDelete,
+    kInitTxn,
+    kReadDataStore,
+    kInsertRange,
+    kStep,
+    kCommit,
+    kCount
+};
+
+constexpr size_t kOperationPhaseCount =
+    static_cast<size_t>(OperationPhase::kCount);
+
+const char *PhaseName(OperationPhase phase);
+
+/// what an executor has counted so far; latencies are in CycleClock ticks.
+struct MetricsSnapshot
+{
+    int64_t commit_count_ = 0;
+    int64_t abort_count_ = 0;
+    std::array<int64_t, kAbortReasonCount> abort_reasons_{};
+    double nanos_per_tick_ = 1.0;
+    std::array<LatencyHistogram::Snapshot, kOperationPhaseCount> phases_;
+
+    const LatencyHistogram::Snapshot &Phase(OperationPhase phase) const
+    {
+        return phases_[static_cast<size_t>(phase)];
+    }
+
+    int64_t AbortCount(AbortReason reason) const
+    {
+        return abort_reasons_[static_cast<size_t>(reason)];
+    }
+
+    double ToMicros(uint64_t ticks) const
+    {
+        return ticks * nanos_per_tick_ / 1000;
+    }
+
+    void Merge(const MetricsSnapshot &that);
+};
+
+/**
+ * Counters and per-phase latency histograms of one executor. Written by the
+ * executor thread only; Snapshot may be called from any thread while it
+ * runs.
+ */
+class ExecutorMetrics
+{
+public:
+    void RecordPhase(OperationPhase phase, uint64_t ticks)
+    {
+        phases_[static_cast<size_t>(phase)].Record(ticks);
+    }
+
+    void RecordCommit(uint64_t ticks)
+    {
+        commit_count_.fetch_add(1, std::memory_order_relaxed);
+        RecordPhase(OperationPhase::kCommit, ticks);
+    }
+
+    void RecordAbort(AbortReason reason)
+    {
+        abort_count_.fetch_add(1, std::memory_order_relaxed);
+        abort_reasons_[static_cast<size_t>(reason)].fetch_add(
+            1, std::memory_order_relaxed);
+    }
+
+    /// key is one the transaction conflicted on.
+    void RecordAbortKey(const LocalState::SetKey &key, AbortReason reason)
+    {
+        hot_keys_.Record(key, reason);
+    }
+
+    void Snapshot(MetricsSnapshot &snapshot) const;
+
+    void HotKeys(std::vector<HotKey> &keys) const
+    {
+        hot_keys_.TopKeys(keys);
+    }
+
+private:
+    std::atomic<int64_t> commit_count_ = 0;
+    std::atomic<int64_t> abort_count_ = 0;
+    std::array<std::atomic<int64_t>, kAbortReasonCount> abort_reasons_{};
+    std::array<LatencyHistogram, kOperationPhaseCount> phases_;
+    HotKeyTracker hot_keys_;
+};
+}  // namespace txservice::transaction
+#endif  // TXSERVICE_TRANSACTION_EXECUTOR_METRICS_H_
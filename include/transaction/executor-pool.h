@@ -0,0 +1,72 @@
+#ifndef TXSERVICE_TRANSACTION_EXECUTOR_POOL_H_
+#define TXSERVICE_TRANSACTION_EXECUTOR_POOL_H_
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "transaction/runtime-transaction-executor.h"
+#include "transaction/txn-id-generator-factory.h"
+#include "versiondb/versiondb.h"
+
+namespace txservice::transaction
+{
+/**
+ * Owns a fixed set of RuntimeTransactionExecutors, each driven by its own
+ * thread pinned to a core. Requests are routed by session id, so every
+ * operation of a session lands in the same executor queue and keeps its
+ * order. An executor that finds nothing to do for EXECUTOR_IDLE_PASSES
+ * passes parks on its request queue for up to EXECUTOR_PARK_TIMEOUT_US.
+ */
+class ExecutorPool
+{
+public:
+    using Pointer = std::unique_ptr<ExecutorPool>;
+
+    /// executor i gets its handler from version_db and its txn id generator
+    /// from id_factory, and is pinned to core (first_core + i) when
+    /// pin_to_core is set.
+    ExecutorPool(uint32_t executor_count,
+                 uint32_t concurrent_txn_count,
+                 TxnIDGeneratorFactory *id_factory,
+                 VersionDb *version_db,
+                 txlog::TxLog *tx_log,
+                 size_t capacity,
+                 bool pin_to_core = true,
+                 uint32_t first_core = 0);
+    ~ExecutorPool();
+
+    ExecutorPool(const ExecutorPool &) = delete;
+    ExecutorPool &operator=(const ExecutorPool &) = delete;
+
+    void Start();
+    /// waits until every queued request has been served, aborts the
+    /// transactions of sessions still left open, then stops the executor
+    /// threads. Clients must have stopped submitting.
+    void ShutDown();
+    void AddRequest(OperationRequest *operation_request);
+    void AddRequest(std::shared_ptr<OperationRequest> operation_request);
+    /// metrics merged over all executors.
+    MetricsSnapshot Metrics() const;
+
+    size_t ExecutorIndex(int64_t session_id) const;
+    size_t ExecutorCount() const
+    {
+        return executors_.size();
+    }
+    RuntimeTransactionExecutor *GetExecutor(size_t idx)
+    {
+        return executors_[idx].get();
+    }
+
+private:
+    void RunExecutor(size_t idx);
+    void PinToCore(std::thread &thread, uint32_t core);
+
+    std::vector<std::unique_ptr<RuntimeTransactionExecutor>> executors_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stopping_;
+    bool pin_to_core_;
+    uint32_t first_core_;
+};
+}  // namespace txservice::transaction
+#endif  // TXSERVICE_TRANSACTION_EXECUTOR_POOL_H_
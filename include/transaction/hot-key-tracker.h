@@ -0,0 +1,57 @@
+#ifndef TXSERVICE_TRANSACTION_HOT_KEY_TRACKER_H_
+#define TXSERVICE_TRANSACTION_HOT_KEY_TRACKER_H_
+
+#include <mutex>
+#include <vector>
+#include "transaction/abort-reason.h"
+#include "transaction/local-state.h"
+#include "utility/count-min-sketch.h"
+
+namespace txservice::transaction
+{
+struct HotKey
+{
+    TableName table_name_;
+    Key::Pointer key_;
+    // estimated, recent aborts weigh more than old ones.
+    uint64_t aborts_;
+    AbortReason last_reason_;
+};
+
+/**
+ * Finds the keys that cause the most aborts. Every conflicting key is counted
+ * in a count-min sketch over SetKey::Hash(), and the top-K keys by estimate
+ * are kept with a copy of the key. Record is called on the abort path only,
+ * so the tracker is guarded by a mutex rather than made lock-free.
+ */
+class HotKeyTracker
+{
+public:
+    explicit HotKeyTracker(size_t top_k = Constant::HOT_KEY_TOP_K,
+                           size_t sketch_width = Constant::HOT_KEY_SKETCH_WIDTH);
+
+    void Record(const LocalState::SetKey &key, AbortReason reason);
+
+    /// the tracked keys, most aborts first.
+    void TopKeys(std::vector<HotKey> &keys) const;
+
+private:
+    struct Entry
+    {
+        size_t hash_;
+        uint32_t count_;
+        TableName table_name_;
+        Key::Pointer key_;
+        AbortReason last_reason_;
+    };
+
+    void Decay();
+
+    mutable std::mutex mutex_;
+    CountMinSketch sketch_;
+    std::vector<Entry> top_;
+    size_t top_k_;
+    size_t records_;
+};
+}  // namespace txservice::transaction
+#endif  // TXSERVICE_TRANSACTION_HOT_KEY_TRACKER_H_
@@ -2,8 +2,11 @@
 #define TXSERVICE_TRANSACTION_LOCAL_STATE_H_
 
 #include <assert.h>
+#include <stdint.h>
+#include <algorithm>
 #include <vector>
 #include <iostream>
+#include "utility/slab-vector.h"
 #include "versiondb/key.h"
 #include "versiondb/record.h"
 #include "versiondb/read-set-entry.h"
@@ -90,103 +93,221 @@ public:
         Key *key;
     };
 
-    struct KeyReadSetEntry
+    /**
+     * Open-addressing index from SetKey to its position in a set pool. It is
+     * filled lazily from the entries appended since the last lookup, and
+     * always points at the newest entry of duplicated keys, which is what the
+     * backwards linear scan finds as well.
+     */
+    struct SetKeyIndex
     {
-        using Pointer = std::unique_ptr<KeyReadSetEntry>;
+        static constexpr size_t kNotFound = SIZE_MAX;
 
-        KeyReadSetEntry(SetKey::Pointer key, ReadSetEntry::Pointer entry)
-            : key_(std::move(key)), entry_(std::move(entry))
+        static size_t Hash(const TableName &table_name, const Key &key)
         {
+            return key.Hash() * 23 + std::hash<TableName>()(table_name);
         }
 
-        Pointer Copy() const
+        // index entries [indexed_count_, size), stopping at entries whose key
+        // has not been filled in yet.
+        template <typename GetKey>
+        void CatchUp(size_t size, GetKey get_key)
+        {
+            for (; indexed_count_ < size; indexed_count_++)
+            {
+                const SetKey *set_key = get_key(indexed_count_);
+                if (set_key->key == nullptr)
+                {
+                    break;
+                }
+                if ((indexed_count_ + 1) * 2 > slots_.size())
+                {
+                    Grow(get_key);
+                }
+                Insert(set_key->Hash(), indexed_count_, get_key);
+            }
+        }
+
+        template <typename GetKey>
+        size_t Find(const TableName &table_name,
+                    const Key &key,
+                    GetKey get_key) const
+        {
+            if (slots_.empty())
+            {
+                return kNotFound;
+            }
+            size_t hash = Hash(table_name, key);
+            size_t mask = slots_.size() - 1;
+            for (size_t i = hash & mask; slots_[i].pos_ != kNotFound;
+                 i = (i + 1) & mask)
+            {
+                if (slots_[i].hash_ == hash)
+                {
+                    const SetKey *set_key = get_key(slots_[i].pos_);
+                    if (table_name == *(set_key->table_name) &&
+                        key == *(set_key->key))
+                    {
+                        return slots_[i].pos_;
+                    }
+                }
+            }
+            return kNotFound;
+        }
+
+        // entries at or above size are gone, drop the index if it covered
+        // any of them; it is rebuilt on the next lookup.
+        void Truncate(size_t size)
+        {
+            if (indexed_count_ > size)
+            {
+                Clear();
+            }
+        }
+
+        void Clear()
+        {
+            if (indexed_count_ > 0)
+            {
+                std::fill(slots_.begin(), slots_.end(), Slot());
+                indexed_count_ = 0;
+            }
+        }
+
+    private:
+        struct Slot
+        {
+            size_t hash_ = 0;
+            size_t pos_ = kNotFound;
+        };
+
+        template <typename GetKey>
+        void Insert(size_t hash, size_t pos, GetKey get_key)
+        {
+            size_t mask = slots_.size() - 1;
+            size_t i = hash & mask;
+            for (; slots_[i].pos_ != kNotFound; i = (i + 1) & mask)
+            {
+                if (slots_[i].hash_ == hash &&
+                    *get_key(slots_[i].pos_) == *get_key(pos))
+                {
+                    break;
+                }
+            }
+            slots_[i].hash_ = hash;
+            slots_[i].pos_ = pos;
+        }
+
+        template <typename GetKey>
+        void Grow(GetKey get_key)
         {
-            return std::make_unique<KeyReadSetEntry>(std::move(key_->Copy()),
-                                                     std::move(entry_->Copy()));
+            size_t capacity =
+                slots_.empty() ? 4 * Constant::LOCAL_STATE_INDEX_THRESHOLD
+                               : 2 * slots_.size();
+            slots_.assign(capacity, Slot());
+            for (size_t pos = 0; pos < indexed_count_; pos++)
+            {
+                Insert(get_key(pos)->Hash(), pos, get_key);
+            }
+        }
+
+        std::vector<Slot> slots_;
+        size_t indexed_count_ = 0;
+    };
+
+    struct KeyReadSetEntry
+    {
+        void CopyFrom(const KeyReadSetEntry &that)
+        {
+            key_ = that.key_;
+            entry_.Reset(that.entry_.version_,
+                         that.entry_.tx_id_,
+                         that.entry_.begin_ts_,
+                         that.entry_.end_ts_,
+                         that.entry_.is_deleted_,
+                         that.entry_.record_,
+                         CopyPtr(that.entry_.extension_),
+                         that.entry_.need_post_processing_,
+                         that.entry_.need_release_,
+                         that.entry_.is_updated_);
+            if (that.entry_.pool_ != nullptr &&
+                that.entry_.record_ == that.entry_.pool_.get())
+            {
+                entry_.KeepRecord(that.entry_.record_);
+            }
         }
 
-        SetKey::Pointer key_;
-        ReadSetEntry::Pointer entry_;
+        SetKey key_;
+        ReadSetEntry entry_;
     };
 
+    using ReadSet = SlabVector<KeyReadSetEntry>;
+
     struct KeyReadSetEntryPool
     {
     public:
         using Pointer = std::unique_ptr<KeyReadSetEntryPool>;
 
         KeyReadSetEntryPool(size_t capacity)
+            : key_read_set_entry_pool_(capacity), pop_index_(0)
         {
-            capacity_ = capacity;
-            pop_index_ = 0;
-
-            for (size_t i = 0; i < capacity; i++)
-            {
-                SetKey::Pointer key = std::make_unique<SetKey>();
-                ReadSetEntry::Pointer read_set_entry =
-                    std::make_unique<ReadSetEntry>();
-                KeyReadSetEntry::Pointer key_read_set_entry =
-                    std::make_unique<KeyReadSetEntry>(
-                        std::move(key), std::move(read_set_entry));
-                key_read_set_entry_pool_.push_back(
-                    std::move(key_read_set_entry));
-            }
         }
 
         KeyReadSetEntryPool(const KeyReadSetEntryPool &that)
+            : key_read_set_entry_pool_(
+                  that.key_read_set_entry_pool_.Capacity()),
+              pop_index_(that.pop_index_)
         {
-            capacity_ = that.capacity_;
-            pop_index_ = that.pop_index_;
-            for (size_t i = 0; i < capacity_; i++)
+            for (size_t i = 0; i < pop_index_; i++)
             {
-                KeyReadSetEntry::Pointer key_read_set_entry =
-                    std::move(that.key_read_set_entry_pool_[i]->Copy());
-                key_read_set_entry_pool_.push_back(
-                    std::move(key_read_set_entry));
+                key_read_set_entry_pool_[i].CopyFrom(
+                    that.key_read_set_entry_pool_[i]);
             }
         }
 
         KeyReadSetEntry *NewReadSetEntry()
         {
-            if (pop_index_ == capacity_)
+            if (pop_index_ == key_read_set_entry_pool_.Capacity())
             {
                 Resize();
             }
             KeyReadSetEntry *key_read_set_entry =
-                key_read_set_entry_pool_[pop_index_].get();
+                &key_read_set_entry_pool_[pop_index_];
+            // the key is filled in once the read returns.
+            key_read_set_entry->key_.Reset(nullptr, nullptr);
             pop_index_++;
             return key_read_set_entry;
         }
 
         void Resize()
         {
-            size_t new_capacity = 1 + capacity_;
-            for (size_t i = capacity_; i < new_capacity; i++)
-            {
-                SetKey::Pointer key = std::make_unique<SetKey>();
-                ReadSetEntry::Pointer read_set_entry =
-                    std::make_unique<ReadSetEntry>();
-                KeyReadSetEntry::Pointer key_read_set_entry =
-                    std::make_unique<KeyReadSetEntry>(
-                        std::move(key), std::move(read_set_entry));
-                key_read_set_entry_pool_.push_back(
-                    std::move(key_read_set_entry));
-            }
-            capacity_ = new_capacity;
+            key_read_set_entry_pool_.Grow();
         }
 
         ReadSetEntry *FindInReadSet(const TableName &table_name,
                                     const Key &key) const
         {
+            if (pop_index_ > Constant::LOCAL_STATE_INDEX_THRESHOLD)
+            {
+                auto get_key = [this](size_t pos) {
+                    return &key_read_set_entry_pool_[pos].key_;
+                };
+                index_.CatchUp(pop_index_, get_key);
+                size_t pos = index_.Find(table_name, key, get_key);
+                return pos == SetKeyIndex::kNotFound
+                           ? nullptr
+                           : const_cast<ReadSetEntry *>(
+                                 &key_read_set_entry_pool_[pos].entry_);
+            }
             for (int i = pop_index_ - 1; i >= 0; i--)
             {
-                KeyReadSetEntry *entry = key_read_set_entry_pool_[i].get();
-                assert(entry->key_ != nullptr);
-                assert(entry->key_->table_name != nullptr);
-                assert(entry->key_->key != nullptr);
-                if (table_name == *(entry->key_->table_name) &&
-                    key == *(entry->key_->key))
+                const KeyReadSetEntry &entry = key_read_set_entry_pool_[i];
+                assert(entry.key_.table_name != nullptr);
+                assert(entry.key_.key != nullptr);
+                if (table_name == *(entry.key_.table_name) &&
+                    key == *(entry.key_.key))
                 {
-                    return entry->entry_.get();
+                    return const_cast<ReadSetEntry *>(&entry.entry_);
                 }
             }
             return nullptr;
@@ -195,79 +316,68 @@ public:
         void Release()
         {
             pop_index_--;
+            index_.Truncate(pop_index_);
         }
 
         void Reset()
         {
             pop_index_ = 0;
+            index_.Clear();
         }
         size_t GetSize() const
         {
             return pop_index_;
         }
 
-        const std::vector<KeyReadSetEntry::Pointer> *GetAllReadSet() const
+        ReadSet *GetAllReadSet()
         {
             return &key_read_set_entry_pool_;
         }
 
     private:
-        std::vector<KeyReadSetEntry::Pointer> key_read_set_entry_pool_;
-        size_t capacity_;
+        ReadSet key_read_set_entry_pool_;
         size_t pop_index_;
+        mutable SetKeyIndex index_;
     };
 
     struct KeyWriteSetEntry
     {
-        using Pointer = std::unique_ptr<KeyWriteSetEntry>;
-
-        KeyWriteSetEntry(SetKey::Pointer key, WriteSetEntry::Pointer entry)
-            : key_(std::move(key)), entry_(std::move(entry))
-        {
-        }
-        Pointer Copy() const
+        void CopyFrom(const KeyWriteSetEntry &that)
         {
-            return std::make_unique<KeyWriteSetEntry>(
-                std::move(key_->Copy()), std::move(entry_->Copy()));
+            key_ = that.key_;
+            entry_.Reset(that.entry_.version_,
+                         that.entry_.is_deleted_,
+                         that.entry_.record_,
+                         that.entry_.read_entry_,
+                         that.entry_.need_post_processing_);
+            entry_.extension_ = CopyPtr(that.entry_.extension_);
         }
 
-        SetKey::Pointer key_;
-        WriteSetEntry::Pointer entry_;
+        SetKey key_;
+        WriteSetEntry entry_;
     };
 
+    using WriteSet = SlabVector<KeyWriteSetEntry>;
+
     struct KeyWriteSetEntryPool
     {
     public:
         using Pointer = std::unique_ptr<KeyWriteSetEntryPool>;
 
         KeyWriteSetEntryPool(size_t capacity)
+            : key_write_set_entry_pool_(capacity), pop_index_(0)
         {
-            capacity_ = capacity;
-            pop_index_ = 0;
-
-            for (size_t i = 0; i < capacity; i++)
-            {
-                SetKey::Pointer key = std::make_unique<SetKey>();
-                WriteSetEntry::Pointer write_set_entry =
-                    std::make_unique<WriteSetEntry>();
-                KeyWriteSetEntry::Pointer key_write_set_entry =
-                    std::make_unique<KeyWriteSetEntry>(
-                        std::move(key), std::move(write_set_entry));
-                key_write_set_entry_pool_.push_back(
-                    std::move(key_write_set_entry));
-            }
         }
 
         KeyWriteSetEntryPool(const KeyWriteSetEntryPool &that)
+            : key_write_set_entry_pool_(
+                  that.key_write_set_entry_pool_.Capacity()),
+              pop_index_(that.pop_index_)
         {
-            capacity_ = that.capacity_;
-            pop_index_ = that.pop_index_;
-            for (size_t i = 0; i < capacity_; i++)
+            for (size_t i = 0; i < pop_index_; i++)
             {
-                KeyWriteSetEntry::Pointer key_write_set_entry =
-                    std::move(that.key_write_set_entry_pool_[i]->Copy());
-                key_write_set_entry_pool_.push_back(
-                    std::move(key_write_set_entry));
+                key_write_set_entry_pool_[i].CopyFrom(
+                    that.key_write_set_entry_pool_[i]);
             }
         }
 
@@ -279,14 +389,14 @@ public:
                                            ReadSetEntry *read_entry,
                                            bool need_post_processing = false)
         {
-            if (pop_index_ == capacity_)
+            if (pop_index_ == key_write_set_entry_pool_.Capacity())
             {
                 Resize();
             }
             KeyWriteSetEntry *key_write_set_entry =
-                key_write_set_entry_pool_[pop_index_].get();
-            key_write_set_entry->key_->Reset(table_name, key);
-            key_write_set_entry->entry_->Reset(
+                &key_write_set_entry_pool_[pop_index_];
+            key_write_set_entry->key_.Reset(table_name, key);
+            key_write_set_entry->entry_.Reset(
                 version, is_deleted, record, read_entry, need_post_processing);
             pop_index_++;
             return key_write_set_entry;
@@ -294,34 +404,33 @@ public:
 
         void Resize()
         {
-            size_t new_capacity = 1 + capacity_;
-            for (size_t i = capacity_; i < new_capacity; i++)
-            {
-                SetKey::Pointer key = std::make_unique<SetKey>();
-                WriteSetEntry::Pointer write_set_entry =
-                    std::make_unique<WriteSetEntry>();
-                KeyWriteSetEntry::Pointer key_write_set_entry =
-                    std::make_unique<KeyWriteSetEntry>(
-                        std::move(key), std::move(write_set_entry));
-                key_write_set_entry_pool_.push_back(
-                    std::move(key_write_set_entry));
-            }
-            capacity_ = new_capacity;
+            key_write_set_entry_pool_.Grow();
         }
 
         WriteSetEntry *FindInWriteSet(const TableName &table_name,
                                       const Key &key) const
         {
+            if (pop_index_ > Constant::LOCAL_STATE_INDEX_THRESHOLD)
+            {
+                auto get_key = [this](size_t pos) {
+                    return &key_write_set_entry_pool_[pos].key_;
+                };
+                index_.CatchUp(pop_index_, get_key);
+                size_t pos = index_.Find(table_name, key, get_key);
+                return pos == SetKeyIndex::kNotFound
+                           ? nullptr
+                           : const_cast<WriteSetEntry *>(
+                                 &key_write_set_entry_pool_[pos].entry_);
+            }
             for (int i = pop_index_ - 1; i >= 0; i--)
             {
-                KeyWriteSetEntry *entry = key_write_set_entry_pool_[i].get();
-                assert(entry->key_ != nullptr);
-                assert(entry->key_->table_name != nullptr);
-                assert(entry->key_->key != nullptr);
-                if (table_name == *(entry->key_->table_name) &&
-                    key == *(entry->key_->key))
+                const KeyWriteSetEntry &entry = key_write_set_entry_pool_[i];
+                assert(entry.key_.table_name != nullptr);
+                assert(entry.key_.key != nullptr);
+                if (table_name == *(entry.key_.table_name) &&
+                    key == *(entry.key_.key))
                 {
-                    return entry->entry_.get();
+                    return const_cast<WriteSetEntry *>(&entry.entry_);
                 }
             }
             return nullptr;
@@ -330,11 +439,13 @@ public:
         void Release()
         {
             pop_index_--;
+            index_.Truncate(pop_index_);
         }
 
         void Reset()
         {
             pop_index_ = 0;
+            index_.Clear();
         }
 
         size_t GetSize() const
@@ -342,15 +453,15 @@ public:
             return pop_index_;
         }
 
-        const std::vector<KeyWriteSetEntry::Pointer> *GetAllWriteSet() const
+        WriteSet *GetAllWriteSet()
         {
             return &key_write_set_entry_pool_;
         }
 
     private:
-        std::vector<KeyWriteSetEntry::Pointer> key_write_set_entry_pool_;
-        size_t capacity_;
+        WriteSet key_write_set_entry_pool_;
         size_t pop_index_;
+        mutable SetKeyIndex index_;
     };
 
     LocalState(size_t capacity);
@@ -373,11 +484,11 @@ public:
     ReadSetEntry *FindInReadSet(const TableName &table_name,
                                 const Key &key) const;
 
-    const std::vector<KeyReadSetEntry::Pointer> *GetAllReadSet() const;
+    ReadSet *GetAllReadSet();
 
     size_t GetReadSetSize() const;
 
-    const std::vector<KeyWriteSetEntry::Pointer> *GetAllWriteSet() const;
+    WriteSet *GetAllWriteSet();
 
     size_t GetWriteSetSize() const;
 
@@ -0,0 +1,56 @@
+#ifndef TXSERVICE_TRANSACTION_OPERATION_REQUEST_POOL_H_
+#define TXSERVICE_TRANSACTION_OPERATION_REQUEST_POOL_H_
+
+#include <folly/MPMCQueue.h>
+#include "transaction/operation-request.h"
+
+namespace txservice::transaction
+{
+/**
+ * Recycles OperationRequests, together with their cached Result, key and
+ * record, so that submitting an operation does not allocate once the pool
+ * is warm. Acquire and Recycle may be called from any thread. The pool must
+ * outlive every request acquired from it.
+ */
+class OperationRequestPool
+{
+public:
+    explicit OperationRequestPool(size_t capacity);
+    ~OperationRequestPool();
+
+    OperationRequestPool(const OperationRequestPool &) = delete;
+    OperationRequestPool &operator=(const OperationRequestPool &) = delete;
+
+    /// returns a request holding one reference for the caller, who gives it
+    /// up with Release once done reading the result.
+    OperationRequest *Acquire(int64_t session_id, OperationType operation_type);
+
+    OperationRequest *Acquire(int64_t session_id,
+                              const TableName &table_name,
+                              Key::Pointer key,
+                              Record::Pointer record,
+                              OperationType operation_type,
+                              void *callback_deserializer = nullptr);
+
+    /**
+     * Same, copying key and record into the ones the recycled request kept
+     * when they are of the same types, so a warm pool does not allocate. A
+     * null record drops the kept one; a Read needs a record of the type it
+     * reads into.
+     */
+    OperationRequest *Acquire(int64_t session_id,
+                              const TableName &table_name,
+                              const Key &key,
+                              const Record *record,
+                              OperationType operation_type,
+                              void *callback_deserializer = nullptr);
+
+    /// called by OperationRequest::Release once the last reference is gone.
+    void Recycle(OperationRequest *request);
+
+private:
+    // free requests; once it is full, recycled requests are deleted.
+    folly::MPMCQueue<OperationRequest *> free_requests_;
+};
+}  // namespace txservice::transaction
+#endif  // TXSERVICE_TRANSACTION_OPERATION_REQUEST_POOL_H_
@@ -1,10 +1,10 @@
 #ifndef TXSERVICE_TRANSACTION_OPERATION_REQUEST_H_
 #define TXSERVICE_TRANSACTION_OPERATION_REQUEST_H_
 
-#include <condition_variable>
-#include <functional>
-#include <mutex>
+#include <atomic>
 #include "transaction/result.h"
+#include "utility/completion.h"
+#include "utility/inline-function.h"
 #include "versiondb/key.h"
 #include "versiondb/record.h"
 namespace txservice::transaction
@@ -23,7 +23,18 @@ enum OperationType
     Abort
 };
 
+/// type_ of a Begin request.
+enum TxnType
+{
+    ReadWriteTxn = 0,
+    // only reads, each of the version of its key committed as of the
+    // timestamp it begins at, and commits without a txn entry or
+    // validation.
+    ReadOnlyTxn = 1
+};
+
 class OperationRequest;
+class OperationRequestPool;
 
 class RequestProcess
 {
@@ -41,6 +52,9 @@ class OperationRequest
 {
 public:
     using Pointer = std::shared_ptr<OperationRequest>;
+    /// continuation of OnComplete, kept inside the request.
+    using Continuation =
+        InlineFunction<void(OperationRequest *), 6 * sizeof(void *)>;
 
     OperationRequest(
         int64_t session_id,
@@ -58,7 +72,6 @@ public:
           request_processor_(std::move(request_processor)),
           cache_(nullptr),
           result_(nullptr),
-          is_finished_(false),
 		  callback_deserializer_(callback_deserializer)
     {
         cache_ = std::make_unique<Result>();
@@ -68,8 +81,7 @@ public:
         : session_id_(session_id),
           operation_type_(operation_type),
           cache_(nullptr),
-          result_(nullptr),
-          is_finished_(false)
+          result_(nullptr)
     {
         cache_ = std::make_unique<Result>();
     }
@@ -78,6 +90,26 @@ public:
     {
     }
 
+    /**
+     * Requests are reference counted intrusively: the executor takes a
+     * reference for as long as it uses the request. The last Release hands a
+     * pooled request back to its pool and drops the self reference of one
+     * that came in as a shared_ptr (see Adopt). A plain request stays owned
+     * by whoever created it.
+     */
+    void AddRef()
+    {
+        ref_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Release();
+
+    /// raw handle of a shared request, kept alive until the last Release.
+    static OperationRequest *Adopt(std::shared_ptr<OperationRequest> request);
+
+    /// prepares a recycled request, see OperationRequestPool::Acquire.
+    void Reset(int64_t session_id, OperationType operation_type);
+
     void SetResult(txservice::transaction::Result *result);
 
     Result *GetResult() const;
@@ -88,10 +120,24 @@ public:
 
     void PullResult();
 
+    /// blocks until the executor has answered the request.
     void Wait();
 
     void Notify();
 
+    bool IsFinished() const
+    {
+        return completion_.IsSet();
+    }
+
+    /**
+     * Runs fn once the request is answered, on the thread answering it, or
+     * right away if it already is. Lets a client keep many operations in
+     * flight instead of waiting on each. fn must not block the executor, and
+     * its captures must fit in Continuation.
+     */
+    void OnComplete(Continuation fn);
+
     int type_ = 0;
     int64_t session_id_;
     TableName table_name_;
@@ -103,11 +149,22 @@ public:
     std::vector<OperationRequest *> dependent_request_;
     std::unique_ptr<RequestProcess> request_processor_;
     void *callback_deserializer_;
-    std::mutex mutex_;
-    std::condition_variable cv_;
-    bool is_finished_;
     // this is only used in read data store.
     bool need_to_read_outside_;
+
+private:
+    friend class OperationRequestPool;
+
+    static constexpr uint32_t kContinuationSet = 1;
+    static constexpr uint32_t kNotified = 2;
+
+    Completion completion_;
+    Continuation continuation_;
+    // whichever of OnComplete and Notify comes second runs the continuation.
+    std::atomic<uint32_t> continuation_state_ = 0;
+    std::atomic<int32_t> ref_count_ = 0;
+    OperationRequestPool *pool_ = nullptr;
+    std::shared_ptr<OperationRequest> owner_;
 };
 }  // namespace txservice::transaction
 #endif  // TXSERVICE_TRANSACTION_OPERATION_REQUEST_H_
\ No newline at end of file
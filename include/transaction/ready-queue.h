@@ -0,0 +1,41 @@
+#ifndef TXSERVICE_TRANSACTION_READY_QUEUE_H_
+#define TXSERVICE_TRANSACTION_READY_QUEUE_H_
+
+#include <folly/MPMCQueue.h>
+#include <vector>
+
+namespace txservice::transaction
+{
+/**
+ * Slots of an executor whose transaction can make progress. A slot is pushed
+ * at most once until the executor pops it (see TransactionExecution::
+ * MarkReady), so a queue as large as the slot count never blocks. Pushes may
+ * come from whichever thread finishes a handler request.
+ */
+class ReadyQueue
+{
+public:
+    explicit ReadyQueue(size_t capacity) : queue_(capacity)
+    {
+    }
+
+    void Push(int32_t task_index)
+    {
+        queue_.write(task_index);
+    }
+
+    /// moves every slot queued so far into tasks.
+    void Drain(std::vector<int32_t> &tasks)
+    {
+        int32_t task_index;
+        while (queue_.read(task_index))
+        {
+            tasks.push_back(task_index);
+        }
+    }
+
+private:
+    folly::MPMCQueue<int32_t> queue_;
+};
+}  // namespace txservice::transaction
+#endif  // TXSERVICE_TRANSACTION_READY_QUEUE_H_
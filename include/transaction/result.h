@@ -2,6 +2,7 @@
 #define TXSERVICE_TRANSACTION_RESULT_H_
 #include <atomic>
 #include <iostream>
+#include "transaction/abort-reason.h"
 #include "versiondb/record.h"
 #include "versiondb/tx-entry.h"
 namespace txservice::transaction
@@ -19,6 +20,7 @@ struct Result
         is_error_ = false;
         operation_request_ = nullptr;
         status_ = TxnStatus::kOngoing;
+        abort_reason_ = AbortReason::kNone;
     }
 
     Result(const Result &that)
@@ -29,6 +31,7 @@ struct Result
         is_error_ = that.is_error_;
         operation_request_ = that.operation_request_;
         status_ = that.status_;
+        abort_reason_ = that.abort_reason_;
     }
 
     void Reset(Record *record, OperationRequest *operation_request);
@@ -75,6 +78,12 @@ struct Result
         SetFinished();
     }
 
+    /// set ahead of the kAborted status.
+    void SetAbortReason(AbortReason reason)
+    {
+        abort_reason_ = reason;
+    }
+
     void SetFinished();
 
     bool IsDeleted()
@@ -102,6 +111,11 @@ struct Result
         return status_ == TxnStatus::kAborted;
     }
 
+    AbortReason GetAbortReason()
+    {
+        return abort_reason_;
+    }
+
     Record *GetRecord()
     {
         return record_;
@@ -113,6 +127,7 @@ struct Result
     bool is_null_;
     bool is_error_;
     TxnStatus status_;
+    AbortReason abort_reason_;
 };
 }  // namespace txservice::transaction
 #endif  // TXSERVICE_TRANSACTION_RESULT_H_
@@ -1,8 +1,11 @@
 #ifndef TXSERVICE_TRANSACTION_RUNTIME_TRANSACTION_EXECUTOR_H_
 #define TXSERVICE_TRANSACTION_RUNTIME_TRANSACTION_EXECUTOR_H_
 
+#include <chrono>
 #include <memory>
+#include <unordered_map>
 #include <folly/MPMCQueue.h>
+#include "transaction/ready-queue.h"
 #include "transaction/transaction-executor.h"
 #include "transaction/transaction-task.h"
 
@@ -19,20 +22,41 @@ public:
                         txlog::TxLog *tx_log,
                         size_t capacity);
     virtual void Run() override;
-    virtual void AddRequest(
-        std::shared_ptr<OperationRequest> operation_request) override;
-    void LaunchRequests();
+    virtual void Submit(OperationRequest *operation_request) override;
+    /// one pass of Run; false if it found no request to launch and no task
+    /// to advance.
+    bool RunOnce();
+    /// blocks until a request arrives or timeout_us has passed.
+    void Park(int64_t timeout_us);
+    /// aborts the transactions of sessions that wait for their client's
+    /// next operation, so that the executor can finish.
+    void AbortOpenSessions();
+    bool LaunchRequests();
     void Advance();
+    /// slot of the session's running transaction, kNoTask if none.
+    int32_t FindSessionTask(int64_t session_id);
+    int32_t AcquireTask(int64_t session_id);
+    void ReleaseTask(int32_t index);
     virtual bool IsFinished() override;
-    virtual void Statistics(int &commit, int &abort) override;
+    virtual void SetCommitProtocol(
+        const StepOperation::Steps *protocol) override;
+    virtual void SetChangeFeed(txckpt::ChangeFeed *change_feed) override;
     virtual void ShutDown() override;
 
 public:
     uint32_t concurrent_txn_count_;
     std::vector<TransactionTask> active_txn_;
     int active_txn_number_;
-    folly::MPMCQueue<std::shared_ptr<OperationRequest>> request_queue_pool_;
-    std::shared_ptr<OperationRequest> current_request_;
+    folly::MPMCQueue<OperationRequest *> request_queue_pool_;
+    OperationRequest *current_request_;
+    // session id -> index in active_txn_, for every in-use task.
+    std::unordered_map<int64_t, int32_t> session_task_;
+    // head of the free list threaded through the idle tasks.
+    int32_t free_task_head_;    // slots with progress to make, only these are run by Advance.
+    ReadyQueue ready_queue_;
+    std::vector<int32_t> ready_tasks_;
+    // abort requests of AbortOpenSessions, one per task.
+    std::vector<std::unique_ptr<OperationRequest>> abort_requests_;
 };
 }  // namespace txservice::transaction
 #endif  // TXSERVICE_TRANSACTION_RUNTIME_TRANSACTION_EXECUTOR_H_
\ No newline at end of file
@@ -1,17 +1,20 @@
 #ifndef TXSERVICE_TRANSACTION_TRANSACTION_EXECUTION_H_
 #define TXSERVICE_TRANSACTION_TRANSACTION_EXECUTION_H_
 
+#include <atomic>
 #include "data-store/data-store.h"
 #include "transaction/local-state.h"
 #include "transaction/operation-request.h"
+#include "transaction/ready-queue.h"
 #include "transaction/time-provider.h"
 #include "transaction/transaction-operation.h"
 #include "transaction/txn-id-generator.h"
+#include "txcheckpoint/change-feed.h"
 #include "txlog/txlog.h"
 
 namespace txservice::transaction
 {
-class TransactionExecution
+class TransactionExecution : public request::CompletionListener
 {
 public:
     static constexpr int64_t kMaxTxnExecutionTimeMS = 100000;
@@ -43,11 +46,9 @@ public:
                         Record *record,
                         ReadSetEntry *read_entry,
                         bool need_post_processing = false);
-    const std::vector<LocalState::KeyReadSetEntry::Pointer> *GetAllReadSet()
-        const;
+    LocalState::ReadSet *GetAllReadSet();
     size_t GetReadSetSize() const;
-    const std::vector<LocalState::KeyWriteSetEntry::Pointer> *GetAllWriteSet()
-        const;
+    LocalState::WriteSet *GetAllWriteSet();
     size_t GetWriteSetSize() const;
     void ReleaseReadSet();
     void ReleaseWriteSet();
@@ -58,14 +59,24 @@ public:
     int64_t GetCommitTs();
     void WriteLog(
         int64_t commit_timestamp,
-        const std::vector<transaction::LocalState::KeyWriteSetEntry::Pointer>
-            *write_entry,
+        const LocalState::WriteSet *write_entry,
         const size_t size,
         const TxnEntry *txn_entry,
         std::atomic<bool> *is_finish,
-        bool sync = true);
+        bool sync = true,
+        request::CompletionListener *listener = nullptr);
     void Abort(std::string msg);
-    void Recover(std::string msg);
+    /// redoes outcome, kCommitted or kAborted, after a failed post
+    /// processing request; throws if that fails as well.
+    void Recover(TxnStatus outcome, std::string msg);
+    /// retry the DeleteVersion, and ReleaseReadCounter, of abort post
+    /// processing that failed; throw if they keep failing.
+    void RecoverDeleteVersion(const LocalState::SetKey &key,
+                              const WriteSetEntry &entry,
+                              std::string msg);
+    void RecoverReleaseReadCounter(const LocalState::SetKey &key,
+                                   const ReadSetEntry &entry,
+                                   std::string msg);
     Result *Begin(int type);
     Result *Insert(TableName *table_name, Key *key, Record *record, void *);
     Result *Read(TableName *table_name, Key *key, Record *record, void *);
@@ -85,12 +96,41 @@ public:
     Result *Delete(TableName *table_name, Key *key);
     Result *Commit();
     Result *Abort();
+    bool IsReadOnly() const
+    {
+        return read_only_;
+    }
+    /// the timestamp every read of a read-only txn is at, fixed by Begin.
+    int64_t ReadTs() const
+    {
+        return read_ts_;
+    }
+    /// whether NewTxn has added the txn entry of this txn yet; it is
+    /// deferred to the first upload batch unless a commit protocol is set.
+    bool IsTxnEntryCreated() const
+    {
+        return txn_entry_created_;
+    }
+    void SetTxnEntryCreated()
+    {
+        txn_entry_created_ = true;
+    }
+    /// commits through protocol instead of the built-in operation chain;
+    /// nullptr restores the built-in one.
+    void SetCommitProtocol(const StepOperation::Steps *protocol);
     bool IsFinished();
     void SetFinished();
     TxnStatus GetTxnStatus();
     void SetTxnStatus(TxnStatus status);
     void PrepareAbort();
     void WaitForAbort();
+    /// keeps the first reason given; key, if any, is counted as a hot key.
+    void SetAbortReason(AbortReason reason,
+                        const LocalState::SetKey *key = nullptr);
+    AbortReason GetAbortReason() const
+    {
+        return abort_reason_;
+    }
     bool IsAborting();
     bool IsWaitForAborting();
     void Init();
@@ -98,14 +138,43 @@ public:
     void ResetTxnIDAndTime();
     void ResetTime();
 
-    inline void SetCurrentRequest(std::shared_ptr<OperationRequest> request)
+    /// where the latencies of the execution's operations are recorded.
+    void SetMetrics(ExecutorMetrics *metrics);
+    /// where the keys the execution commits are recorded for incremental
+    /// checkpoints; nullptr records none.
+    void SetChangeFeed(txckpt::ChangeFeed *change_feed);
+    /// set_key has been committed at the commit timestamp.
+    void RecordChange(const LocalState::SetKey &set_key);
+    void RecordPhase(OperationPhase phase, uint64_t begin_ticks);
+    uint64_t GetCommitBeginTicks() const
+    {
+        return commit_begin_ticks_;
+    }
+
+    /// the queue the execution is pushed onto, as slot task_index, when it
+    /// can make progress again.
+    void SetReadyQueue(ReadyQueue *ready_queue, int32_t task_index);
+    /// a watched handler request is about to be issued.
+    void ExpectCompletion();
+    virtual void OnCompletion() override;
+    /// queues the execution unless it is queued already.
+    void MarkReady();
+    /// called by the executor when it pops the execution.
+    void ClearReady();
+    /// true while a watched handler request has not finished, the execution
+    /// will be queued again by its completion.
+    bool IsWaiting() const;
+    /// no operation is in progress.
+    bool IsIdle() const;
+
+    inline void SetCurrentRequest(OperationRequest *request)
     {
         current_request_ = request;
     }
 
     inline OperationRequest *GetCurrentRequest() const
     {
-        return current_request_.get();
+        return current_request_;
     }
 
 public:
@@ -131,7 +200,9 @@ public:
         post_processing_delete_entry_after_abort_operation_vector;
     UpdateTxnStatusToAbort update_txn_status_to_abort_operation;
     ReadOutsideOperation read_outside_operation;
+    ReadSnapshotOperation read_snapshot_operation;
     InitTxnOperation init_txn_operation;
+    StepOperation step_operation;
     InsertOperation insert_operation;
     UpsertOperation upsert_operation;
     UpdateOperation update_operation;
@@ -143,18 +214,40 @@ public:
     Result result_;
 
 private:
+    bool RedoCommit();
+    bool RedoAbort();
+    // answers a read of a key from the write set, else the read set of the
+    // txn; false if the key has to be read from the handler.
+    bool ReadLocally(const TableName &table_name, const Key &key);
+    // answers a write of a read-only txn with an error.
+    Result *RejectWrite();
+    // read-only txns finish locally, there is no txn entry to update.
+    Result *FinishReadOnly(TxnStatus status);
+
     std::vector<TransactionOperation *> operation_vector_;
     LocalState local_state_;
     int64_t max_commit_timestamp_of_writers_ = -1;
     int64_t commit_timestamp_;
     bool is_transaction_finished_;
     TxnStatus status_;
+    bool read_only_ = false;
+    int64_t read_ts_ = 0;
+    bool txn_entry_created_ = false;
+    AbortReason abort_reason_ = AbortReason::kNone;
     TxnIDGenerator *txn_id_generator_;
     TimeProvider *time_provider_;
     txlog::TxLog *tx_log_;
+    const StepOperation::Steps *commit_protocol_ = nullptr;
     int64_t count = 0;
     int executor_id_;
-    std::shared_ptr<OperationRequest> current_request_;
+    OperationRequest *current_request_;
+    ExecutorMetrics *metrics_ = nullptr;
+    txckpt::ChangeFeed *change_feed_ = nullptr;
+    uint64_t commit_begin_ticks_ = 0;
+    ReadyQueue *ready_queue_ = nullptr;
+    int32_t task_index_ = -1;
+    std::atomic<int32_t> pending_completions_ = 0;
+    std::atomic<bool> is_ready_ = false;
 };
 }  // namespace txservice::transaction
 #endif  // TXSERVICE_TRANSACTION_TRANSACTION_EXECUTION_H_
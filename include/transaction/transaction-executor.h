@@ -1,6 +1,9 @@
 #ifndef TXSERVICE_TRANSACTION_TRANSACTION_EXECUTOR_H_
 #define TXSERVICE_TRANSACTION_TRANSACTION_EXECUTOR_H_
 
+#include <atomic>
+#include "transaction/coalescing-handler.h"
+#include "transaction/executor-metrics.h"
 #include "transaction/transaction-execution.h"
 #include "transaction/transaction-request.h"
 
@@ -18,15 +21,45 @@ public:
     txlog::TxLog *tx_log)
     : executor_id_(executor_id),
       txn_id_generator_(std::move(txn_id_generator)),
-      handler_(std::move(handler)),
+      handler_(std::make_unique<CoalescingHandler>(std::move(handler))),
       time_provider_(std::move(time_provider)),
       tx_log_(tx_log){}
     virtual void Run() = 0;
-    virtual void AddRequest(
-        std::shared_ptr<OperationRequest> operation_request) = 0;
+    /// queues a request; the executor holds a reference to it until the
+    /// transaction is done with it.
+    void AddRequest(OperationRequest *operation_request)
+    {
+        operation_request->AddRef();
+        Submit(operation_request);
+    }
+    /// compatibility path for callers holding requests by shared_ptr.
+    void AddRequest(std::shared_ptr<OperationRequest> operation_request)
+    {
+        Submit(OperationRequest::Adopt(std::move(operation_request)));
+    }
+    /// queues a request, taking over a reference the caller holds.
+    virtual void Submit(OperationRequest *operation_request) = 0;
     virtual bool IsFinished() = 0;
     virtual void ShutDown() = 0;
-    virtual void Statistics(int &commit, int &abort) = 0;
+    /// commit and abort counts and per-phase latencies so far, safe to call
+    /// from any thread while the executor runs.
+    MetricsSnapshot Metrics() const
+    {
+        MetricsSnapshot snapshot;
+        metrics_.Snapshot(snapshot);
+        return snapshot;
+    }
+    /// the keys that caused the most aborts on this executor.
+    void HotKeys(std::vector<HotKey> &keys) const
+    {
+        metrics_.HotKeys(keys);
+    }
+    /// every transaction of the executor commits through protocol, see
+    /// TransactionExecution::SetCommitProtocol.
+    virtual void SetCommitProtocol(const StepOperation::Steps *protocol) = 0;
+    /// every transaction of the executor records the keys it commits in
+    /// change_feed, see txckpt::CheckpointCoordinator::IncrementalCheckpoint.
+    virtual void SetChangeFeed(txckpt::ChangeFeed *change_feed) = 0;
 public:
     std::unique_ptr<DataStore> datastore_driver;
     virtual ~TransactionExecutor() = default;
@@ -35,8 +68,7 @@ public:
     std::unique_ptr<TxnIDGenerator> txn_id_generator_;
     txlog::TxLog *tx_log_;
     int executor_id_;
-    int commit_count_ = 0;
-    int abort_count_ = 0;
+    ExecutorMetrics metrics_;
 };
 }  // namespace txservice::transaction
 #endif  // TXSERVICE_TRANSACTION_TRANSACTION_EXECUTOR_H_
\ No newline at end of file
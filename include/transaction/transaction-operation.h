@@ -1,7 +1,12 @@
 #ifndef TXSERVICE_TRANSACTION_TRANSACTION_OPERATION_H_
 #define TXSERVICE_TRANSACTION_TRANSACTION_OPERATION_H_
 
+#include <deque>
+#include <functional>
+#include <typeindex>
+#include <unordered_map>
 #include "data-store/data-store.h"
+#include "transaction/executor-metrics.h"
 #include "transaction/local-state.h"
 #include "transaction/result.h"
 #include "versiondb/request/handler.h"
@@ -17,28 +22,53 @@ struct TransactionOperation
 
     void Call();
 
+    /// like Call, but the request is left to the parent operation, which
+    /// sends those of all its children in one batch.
+    void Defer();
+
     virtual void CallImpl() = 0;
 
     TransactionOperation *Next();
 
     virtual TransactionOperation *NextImpl() = 0;
 
-    TransactionOperation *PrepareAbort();
+    /// gives up the commit once sibling operations are done; key is the one
+    /// that conflicted, if any.
+    TransactionOperation *PrepareAbort(
+        AbortReason reason, const LocalState::SetKey *key = nullptr);
 
+    /// aborts for the reason recorded by a child operation.
     TransactionOperation *Abort();
 
+    TransactionOperation *Abort(AbortReason reason);
+
     virtual bool IsFinished() const = 0;
 
     virtual bool IsCascadeFinished() const = 0;
 
+    /// the histogram the operation's latency, from Call to Next, goes to.
+    virtual OperationPhase GetPhase() const = 0;
+
     void Init(TransactionExecution *execution);
 
     virtual ~TransactionOperation() = default;
 
 protected:
+    // wakes the execution up once the handler finishes the result; call it
+    // right before handing the result to the handler.
+    template <typename T>
+    void Watch(request::HandlerResult<T> &result)
+    {
+        result.SetListener(ExpectCompletion());
+    }
+
+    request::CompletionListener *ExpectCompletion();
+
+
     TransactionExecution *execution_;
     bool move_to_next_ = false;
     bool has_next_ = false;
+    uint64_t begin_ticks_ = 0;
 };
 
 struct ReadOutsideOperation : TransactionOperation
@@ -54,6 +84,11 @@ struct ReadOutsideOperation : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kReadOutside;
+    }
+
     void InternalRead();
 
     static VersionEntry *InternalPickVisibleVersion(VersionEntry &v1,
@@ -72,6 +107,33 @@ private:
         result_of_get_version_list_;
 };
 
+/// read of a read-only txn: the version of the key committed as of its
+/// read timestamp, with no read set entry and nothing to validate or
+/// release.
+struct ReadSnapshotOperation : TransactionOperation
+{
+    void Reset(TableName *table_name, Key *key, Record *record, void *);
+
+    virtual void CallImpl() override;
+
+    virtual TransactionOperation *NextImpl() override;
+
+    virtual bool IsFinished() const override;
+
+    virtual bool IsCascadeFinished() const override;
+
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kReadSnapshot;
+    }
+
+private:
+    TableName *table_name_;
+    Key *key_;
+    void *callback_deserializer_;
+    request::HandlerResult<VersionEntry> result_of_get_visible_version_;
+};
+
 struct Upload : TransactionOperation
 {
     virtual void CallImpl() override;
@@ -82,11 +144,20 @@ struct Upload : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kUpload;
+    }
+
     void Reset();
 
 private:
-    const std::vector<LocalState::KeyWriteSetEntry::Pointer> *key_write_set_;
+    LocalState::WriteSet *key_write_set_;
     size_t size_;
+    std::vector<request::UploadVersionRequest> upload_requests_;
+    // NewTxn is sent ahead of the versions when the txn has no entry yet.
+    bool new_txn_ = false;
+    request::HandlerResult<Void> result_of_new_txn_;
 };
 
 struct UploadVersionEntry : TransactionOperation
@@ -99,9 +170,16 @@ struct UploadVersionEntry : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kUploadVersionEntry;
+    }
+
     void Reset(WriteSetEntry *write_set_entry,
             const LocalState::SetKey *set_key);
 
+    request::UploadVersionRequest MakeRequest();
+
 private:
     WriteSetEntry *write_set_entry_;
     const LocalState::SetKey *set_key_;
@@ -119,6 +197,11 @@ struct SetCommitTsOperation : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kSetCommitTs;
+    }
+
     void Reset();
 
 private:
@@ -135,11 +218,17 @@ struct Validate : TransactionOperation
 
     bool IsCascadeFinished() const override;
 
+    OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kValidate;
+    }
+
     void Reset();
 
 private:
-    const std::vector<LocalState::KeyReadSetEntry::Pointer> *key_read_set_;
+    LocalState::ReadSet *key_read_set_;
     std::vector<size_t> read_index_;
+    std::vector<request::UpdateMaxCommitTsRequest> update_requests_;
 };
 
 struct UpdateReadEntryMaxCommitTs : TransactionOperation
@@ -152,9 +241,16 @@ struct UpdateReadEntryMaxCommitTs : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kUpdateReadEntryMaxCommitTs;
+    }
+
     void Reset(ReadSetEntry *read_set_entry, const LocalState::SetKey *set_key,
             size_t index);
 
+    request::UpdateMaxCommitTsRequest MakeRequest();
+
 private:
     ReadSetEntry *read_set_entry_;
     const LocalState::SetKey *set_key_;
@@ -172,11 +268,17 @@ struct PushConflictTxnCommitTsLowerBound : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
-    void Reset(int64_t txn_id);
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kPushConflictTxnCommitTsLowerBound;
+    }
+
+    void Reset(int64_t txn_id, const LocalState::SetKey *set_key);
 
 private:
     request::HandlerResult<TxnEntry> result_of_update_commit_lower_bound_;
     int64_t txn_id_;
+    const LocalState::SetKey *set_key_;
 };
 
 struct WriteToLog : TransactionOperation
@@ -193,6 +295,11 @@ struct WriteToLog : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kWriteToLog;
+    }
+
 private:
     std::atomic<bool> is_finished_ = false;
 };
@@ -207,6 +314,11 @@ struct UpdateTxnStatusToCommit : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kUpdateTxnStatusToCommit;
+    }
+
     void Reset();
 
 private:
@@ -223,11 +335,17 @@ struct PostProcessingAfterCommit : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kPostProcessingAfterCommit;
+    }
+
     void Reset();
 
 private:
-    const std::vector<LocalState::KeyWriteSetEntry::Pointer> *key_write_set_;
+    LocalState::WriteSet *key_write_set_;
     std::vector<size_t> post_process_index_;
+    std::vector<request::CommitVersionRequest> commit_requests_;
 };
 
 struct PostProcessingCommitEntryAfterCommit : TransactionOperation
@@ -240,9 +358,16 @@ struct PostProcessingCommitEntryAfterCommit : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kPostProcessingCommitEntryAfterCommit;
+    }
+
     void Reset(WriteSetEntry *write_set_entry,
             const LocalState::SetKey *set_key);
 
+    request::CommitVersionRequest MakeRequest();
+
 private:
     WriteSetEntry *entry_;
     const LocalState::SetKey *set_key_;
@@ -260,10 +385,15 @@ struct PostProcessingAfterAbort : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kPostProcessingAfterAbort;
+    }
+
     void Reset();
 
 private:
-    const std::vector<LocalState::KeyWriteSetEntry::Pointer> *key_write_set_;
+    LocalState::WriteSet *key_write_set_;
     std::vector<size_t> post_process_index_;
 };
 
@@ -277,6 +407,11 @@ struct PostProcessingDeleteEntryAfterAbort : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kPostProcessingDeleteEntryAfterAbort;
+    }
+
     void Reset(const WriteSetEntry *entry, const LocalState::SetKey *set_key);
 
 private:
@@ -296,10 +431,15 @@ struct ReleaseReadCounter : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kReleaseReadCounter;
+    }
+
     void Reset();
 
 private:
-    const std::vector<LocalState::KeyReadSetEntry::Pointer> *key_read_set_;
+    LocalState::ReadSet *key_read_set_;
     std::vector<size_t> release_index_;
 };
 
@@ -313,6 +453,11 @@ struct ReleaseReadCounterForEachEntry : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kReleaseReadCounterForEachEntry;
+    }
+
     void Reset(ReadSetEntry *read_set_entry, const LocalState::SetKey *key);
 
 private:
@@ -333,6 +478,11 @@ struct UpdateTxnStatusToAbort : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kUpdateTxnStatusToAbort;
+    }
+
 private:
     request::HandlerResult<Void> result_of_update_txn_status_to_abort_;
 };
@@ -347,6 +497,11 @@ struct InsertOperation : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kInsert;
+    }
+
     void Reset(TableName *table_name, Key *key, Record *record, void *);
 
 private:
@@ -354,6 +509,8 @@ private:
     Key *key_;
     Record *record_;
     void *callback_deserializer_;
+    // the key is in the read set already and is not read again.
+    bool read_locally_ = false;
 };
 
 struct UpdateOperation : TransactionOperation
@@ -366,6 +523,11 @@ struct UpdateOperation : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kUpdate;
+    }
+
     void Reset(TableName *table_name, Key *key, Record *record);
 
 private:
@@ -384,6 +546,11 @@ struct UpsertOperation : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kUpsert;
+    }
+
     void Reset(TableName *table_name, Key *key, Record *record, void *);
 
 private:
@@ -391,6 +558,8 @@ private:
     Key *key_;
     Record *record_;
     void *callback_deserializer_;
+    // the key is in the read set already and is not read again.
+    bool read_locally_ = false;
 };
 
 struct DeleteOperation : TransactionOperation
@@ -403,6 +572,11 @@ struct DeleteOperation : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kDelete;
+    }
+
     void Reset(TableName *table_name, Key *key);
 
 private:
@@ -421,6 +595,11 @@ struct InitTxnOperation : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kInitTxn;
+    }
+
 private:
     request::HandlerResult<Void> result_of_new_txn_;
 };
@@ -438,6 +617,11 @@ struct ReadDataStoreOperation : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kReadDataStore;
+    }
+
 private:
     TableName *table_name_;
     Key *key_;
@@ -459,6 +643,11 @@ struct InsertRangeOperation : TransactionOperation
 
     virtual bool IsCascadeFinished() const override;
 
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kInsertRange;
+    }
+
     void Reset(TableName *table_name, const std::string &range_template);
 
 private:
@@ -466,5 +655,96 @@ private:
     std::string range_template_;
 };
 
+/**
+ * Runs a multi-step protocol written as a list of steps instead of one
+ * operation struct per step. A step passes the results of its handler calls
+ * through Await and returns; the next step runs once all of them have
+ * finished, so each step boundary plays the part of a co_await. A step
+ * returns false to stop early, calls Fail to abort the transaction, or names
+ * the operation to continue with through Then.
+ */
+struct StepOperation : TransactionOperation
+{
+    using Step = std::function<bool(StepOperation &)>;
+    using Steps = std::vector<Step>;
+
+    /// steps must outlive the operation, so that a protocol is built once and
+    /// shared by all the transactions running it.
+    void Reset(const Steps *steps);
+
+    virtual void CallImpl() override;
+
+    virtual TransactionOperation *NextImpl() override;
+
+    virtual bool IsFinished() const override;
+
+    virtual bool IsCascadeFinished() const override;
+
+    virtual OperationPhase GetPhase() const override
+    {
+        return OperationPhase::kStep;
+    }
+
+    template <typename T>
+    request::HandlerResult<T> &Await(request::HandlerResult<T> &result)
+    {
+        result.Reset();
+        awaited_.push_back(&result.is_finished_);
+        Watch(result);
+        return result;
+    }
+
+    /// result number index of type T owned by this operation, where steps
+    /// keep what their handler calls answer.
+    template <typename T>
+    request::HandlerResult<T> &Slot(size_t index = 0)
+    {
+        std::unique_ptr<SlotsBase> &slots = slots_[std::type_index(typeid(T))];
+        if (slots == nullptr)
+        {
+            slots = std::make_unique<Slots<T>>();
+        }
+        std::deque<request::HandlerResult<T>> &results =
+            static_cast<Slots<T> *>(slots.get())->results_;
+        if (results.size() <= index)
+        {
+            results.resize(index + 1);
+        }
+        return results[index];
+    }
+
+    void Fail(AbortReason reason = AbortReason::kProtocolFailure);
+
+    void Then(TransactionOperation *operation);
+
+    TransactionExecution *GetExecution() const
+    {
+        return execution_;
+    }
+
+private:
+    struct SlotsBase
+    {
+        virtual ~SlotsBase() = default;
+    };
+
+    template <typename T>
+    struct Slots : SlotsBase
+    {
+        // a deque, so that growing it keeps awaited results in place.
+        std::deque<request::HandlerResult<T>> results_;
+    };
+
+    const Steps *steps_;
+    size_t next_step_;
+    bool stopped_;
+    bool failed_;
+    AbortReason fail_reason_;
+    TransactionOperation *then_;
+    // is_finished_ of every result awaited by the current step.
+    std::vector<const bool *> awaited_;
+    std::unordered_map<std::type_index, std::unique_ptr<SlotsBase>> slots_;
+};
+
 } // namespace txservice::transaction
 #endif  // TXSERVICE_TRANSACTION_TRANSACTION_OPERATION_H_
\ No newline at end of file
@@ -12,11 +12,14 @@ public:
     using Pointer = std::unique_ptr<TransactionRequest>;
     TransactionRequest();
     TransactionRequest(const TransactionRequest &that);
-    void PushRequest(std::shared_ptr<OperationRequest> operation_request);
-    std::shared_ptr<OperationRequest> CurrentRequest();
+    /// takes over a reference to the request, given up again by Reset.
+    void PushRequest(OperationRequest *operation_request);
+    OperationRequest *CurrentRequest();
+    /// a pushed request has not been taken by CurrentRequest yet.
+    bool HasRequest() const;
     void Reset();
 
-    std::vector<std::shared_ptr<OperationRequest>> operation_request_queue_;
+    std::vector<OperationRequest *> operation_request_queue_;
     int current_ = 0;
 };
 }  // namespace txservice::transaction
@@ -13,7 +13,8 @@ public:
         : transaction_execution_(),
           transaction_request_(),
           in_use_(false),
-          session_id_(0)
+          session_id_(0),
+          next_free_(kNoTask)
     {
     }
 
@@ -22,7 +23,8 @@ public:
         : transaction_execution_(transaction_execution),
           transaction_request_(transaction_request),
           in_use_(false),
-          session_id_(0)
+          session_id_(0),
+          next_free_(kNoTask)
     {
     }
 
@@ -46,6 +48,8 @@ public:
 
     inline void Release()
     {
+        transaction_execution_.SetCurrentRequest(nullptr);
+        transaction_request_.Reset();
         in_use_ = false;
     }
 
@@ -59,11 +63,37 @@ public:
         return session_id_;
     }
 
+    /// queues the task again unless it waits for a handler request or for
+    /// the next operation of its session.
+    inline void Reschedule()
+    {
+        if (!transaction_execution_.IsWaiting() &&
+            (!transaction_execution_.IsIdle() ||
+             transaction_request_.HasRequest()))
+        {
+            transaction_execution_.MarkReady();
+        }
+    }
+
+    /// link of the executor's free list, only meaningful while not in use.
+    inline int32_t GetNextFree()
+    {
+        return next_free_;
+    }
+
+    inline void SetNextFree(int32_t next_free)
+    {
+        next_free_ = next_free;
+    }
+
+    static constexpr int32_t kNoTask = -1;
+
 private:
     TransactionExecution transaction_execution_;
     TransactionRequest transaction_request_;
     bool in_use_;
     int64_t session_id_;
+    int32_t next_free_;
 };
 }  // namespace txservice::transaction
 #endif  // TXSERVICE_TRANSACTION_TRANSACTION_TASK_H_
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define TXSERVICE_TRANSACTION_TXN_ID_GENERATOR_FACTORY_H_
 
 #include <memory>
+#include <string>
 #include "transaction/txn-id-generator.h"
 
 namespace txservice::transaction
@@ -29,5 +30,35 @@ private:
     int count_;
     int64_t interval_;
 };
+
+/// hands out EpochTxnIDGenerators of one node and boot, which must not
+/// outlive the factory.
+class EpochTxnIDGeneratorFactory : public TxnIDGeneratorFactory
+{
+public:
+    EpochTxnIDGeneratorFactory(int node_id, int64_t boot_epoch)
+        : node_id_(node_id), epochs_(boot_epoch)
+    {
+    }
+
+    /// the epochs of the node are kept in the file at epoch_path.
+    EpochTxnIDGeneratorFactory(int node_id, const std::string &epoch_path)
+        : node_id_(node_id), epochs_(epoch_path)
+    {
+    }
+
+    std::unique_ptr<TxnIDGenerator> GetTxnIDGenerator(
+        int executor_id) override;
+
+    /// the epoch of this boot, until an executor rolls over to a new one.
+    int64_t CurrentEpoch()
+    {
+        return epochs_.Current();
+    }
+
+private:
+    int node_id_;
+    BootEpoch epochs_;
+};
 }// namespace txservice::transaction
 #endif  // TXSERVICE_TRANSACTION_TXN_ID_GENERATOR_FACTORY_H_
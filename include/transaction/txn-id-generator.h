@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <cstdlib>
 #include <ctime>
+#include <mutex>
+#include <string>
 
 namespace txservice::transaction
 {
@@ -30,5 +32,70 @@ private:
     int64_t start_;
     int64_t end_;
 };
+
+/**
+ * The epochs of a node: the one of this boot, then a fresh one each time an
+ * executor runs out of sequence numbers. Kept in a file, e.g. next to the
+ * log, every epoch is durable before it is handed out, so a later boot
+ * never reuses one. Epochs wrap around after 2^kBits.
+ */
+class BootEpoch
+{
+public:
+    static constexpr int kBits = 7;
+
+    /// epochs from boot_epoch on, the caller keeping boots apart.
+    explicit BootEpoch(int64_t boot_epoch);
+
+    /// the epoch after the last one in the file at path, which is created
+    /// if it does not exist.
+    explicit BootEpoch(const std::string &path);
+
+    int64_t Current();
+
+    /// a fresh epoch, durable before it is returned. Thread safe.
+    int64_t Next();
+
+private:
+    // writes epoch into path_ and makes it durable.
+    void Persist(int64_t epoch);
+
+    const std::string path_;
+    std::mutex mutex_;
+    int64_t epoch_;
+};
+
+/**
+ * Packs node id, executor id, epoch and a monotonic sequence number into a
+ * positive 64-bit id, so ids of different nodes, executors and boots never
+ * collide. The sequence never wraps: after 2^40 - 1 ids the executor moves
+ * on to a fresh epoch of the node and starts its sequence over.
+ */
+class EpochTxnIDGenerator : public TxnIDGenerator
+{
+public:
+    static constexpr int kSequenceBits = 40;
+    static constexpr int kEpochBits = BootEpoch::kBits;
+    static constexpr int kExecutorBits = 8;
+    static constexpr int kNodeBits = 8;
+
+    /// starts at the current epoch of epochs, after sequence; epochs must
+    /// outlive the generator.
+    EpochTxnIDGenerator(int node_id,
+                        int executor_id,
+                        BootEpoch *epochs,
+                        int64_t sequence = 0);
+
+    int64_t GenerateID() override;
+
+private:
+    void SetEpoch(int64_t epoch);
+
+    const int64_t node_id_;
+    const int64_t executor_id_;
+    BootEpoch *epochs_;
+    int64_t prefix_;
+    int64_t sequence_;
+};
 }// namespace txservice::transaction
 #endif  // TXSERVICE_TRANSACTION_TXN_ID_GENERATOR_H_
\ No newline at end of file
@@ -0,0 +1,120 @@
+#ifndef TXSERVICE_TXCHECKPOINT_CHANGE_FEED_H_
+#define TXSERVICE_TXCHECKPOINT_CHANGE_FEED_H_
+
+#include <stdint.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "txcheckpoint/key-iterator.h"
+#include "utility/configuration.h"
+#include "utility/types.h"
+
+namespace txservice::txckpt
+{
+/**
+ * Keys committed since the last checkpoint, per handler partition, fed by
+ * the commit post processing of the executors it is set on. A key is kept
+ * once with its latest commit timestamp, so a checkpoint reads every
+ * changed key once however often it was written.
+ *
+ * The keys a checkpoint drains are held as pending until it is durable:
+ * Commit then drops them, and Rollback, for a checkpoint that failed, puts
+ * them back so that the next one reads them again.
+ */
+class ChangeFeed
+{
+public:
+    explicit ChangeFeed(size_t partition_count);
+
+    /// key of table_name, in partition of the handler, committed at
+    /// commit_ts.
+    void Append(const TableName &table_name,
+                size_t partition,
+                const Key &key,
+                int64_t commit_ts);
+
+    /**
+     * Moves the keys of table_name in partition last committed at or before
+     * checkpoint_ts to the pending ones and returns copies of them. Keys
+     * committed again later stay, the log keeps their latest commit.
+     */
+    std::vector<Key::Pointer> Drain(const TableName &table_name,
+                                    size_t partition,
+                                    int64_t checkpoint_ts);
+
+    /// drops the pending keys, once the checkpoint they were drained for is
+    /// durable.
+    void Commit();
+
+    /// puts the pending keys back, the checkpoint they were drained for
+    /// having failed.
+    void Rollback();
+
+    /// keys currently held, over all tables and partitions, pending ones
+    /// excluded.
+    size_t Size();
+
+private:
+    struct KeyPtrHash
+    {
+        size_t operator()(const Key *key) const
+        {
+            return key->Hash();
+        }
+    };
+
+    struct KeyPtrEqual
+    {
+        bool operator()(const Key *lhs, const Key *rhs) const
+        {
+            return lhs->Equals(*rhs);
+        }
+    };
+
+    struct Dirty
+    {
+        Key::Pointer key_;
+        int64_t commit_ts_;
+    };
+
+    using DirtyKeys =
+        std::unordered_map<const Key *, Dirty, KeyPtrHash, KeyPtrEqual>;
+
+    struct alignas(Constant::CACHE_LINE_SIZE) Partition
+    {
+        std::mutex mutex_;
+        std::unordered_map<TableName, DirtyKeys> tables_;
+        std::unordered_map<TableName, DirtyKeys> pending_;
+    };
+
+    std::vector<Partition> partitions_;
+};
+
+/// iterates the keys drained from a ChangeFeed.
+class ChangeFeedKeyIterator : public txcheckpoint::KeyIterator
+{
+public:
+    ChangeFeedKeyIterator(std::vector<Key::Pointer> keys,
+                          void *key_deserializer)
+        : txcheckpoint::KeyIterator(key_deserializer), index_(0)
+    {
+        key_container = std::move(keys);
+    }
+
+    virtual bool HasNext() override
+    {
+        return index_ < key_container.size();
+    }
+
+    virtual Key &Next() override
+    {
+        return *key_container[index_++];
+    }
+
+private:
+    size_t index_;
+};
+}  // namespace txservice::txckpt
+#endif  // TXSERVICE_TXCHECKPOINT_CHANGE_FEED_H_
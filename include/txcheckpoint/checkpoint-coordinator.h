@@ -0,0 +1,105 @@
+#ifndef TXSERVICE_TXCHECKPOINT_CHECKPOINT_COORDINATOR_H_
+#define TXSERVICE_TXCHECKPOINT_CHECKPOINT_COORDINATOR_H_
+
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "txcheckpoint/tx-checkpoint.h"
+#include "versiondb/versiondb.h"
+
+namespace txservice::txckpt
+{
+/**
+ * Takes checkpoints of a set of tables into a directory, one snapshot file
+ * per table partition. The partitions are checkpointed by a pool of threads,
+ * each running a TxCheckpoint with its own handler and keeping
+ * pipeline_depth payload reads outstanding. A checkpoint is written into
+ * checkpoint.<ts>.tmp and renamed to checkpoint.<ts> once every snapshot
+ * file of it is durable; only then is the log truncated before the
+ * checkpoint timestamp and older checkpoints removed.
+ *
+ * With a ChangeFeed set on the executors, incremental checkpoints read and
+ * write only the keys committed since the checkpoint before, deleted ones
+ * as tombstones, into delta.<ts>. CheckpointRestore reads them back. The
+ * keys a checkpoint drains from the feed are dropped once it is published,
+ * and put back if it fails.
+ */
+class CheckpointCoordinator
+{
+public:
+    struct Stats
+    {
+        size_t partitions_ = 0;
+        size_t entries_ = 0;
+        size_t raw_bytes_ = 0;
+        size_t file_bytes_ = 0;
+    };
+
+    /// tx_log may be null, the log is then not truncated. change_feed is
+    /// the one set on the executors, if any.
+    CheckpointCoordinator(const std::string &directory,
+                          VersionDb *version_db,
+                          txlog::TxLog *tx_log,
+                          size_t thread_count =
+                              std::thread::hardware_concurrency(),
+                          int pipeline_depth =
+                              Constant::CHECKPOINT_PIPELINE_DEPTH,
+                          ChangeFeed *change_feed = nullptr);
+
+    /// infant is the record payloads of table_name are read into.
+    void AddTable(const TableName &table_name,
+                  int partition_count,
+                  const Record &infant,
+                  void *record_deserializer = nullptr,
+                  void *key_deserializer = nullptr);
+
+    /**
+     * Writes the checkpoint at checkpoint_ts. Every txn committed before
+     * checkpoint_ts must have finished its post processing, as the log
+     * holding its commit may be truncated.
+     */
+    Stats Checkpoint(int64_t checkpoint_ts);
+
+    /**
+     * Writes the keys changed since the last checkpoint, under the same
+     * condition as Checkpoint. There must be a full checkpoint taken while
+     * the change feed was already set on every executor.
+     */
+    Stats IncrementalCheckpoint(int64_t checkpoint_ts);
+
+    static constexpr int64_t kNoCheckpoint = -1;
+
+    /// timestamp of the last complete checkpoint in the directory, full or
+    /// incremental, kNoCheckpoint if there is none.
+    int64_t LastCheckpointTs() const;
+
+private:
+    struct Table
+    {
+        TableName table_name_;
+        int partition_count_;
+        Record::Pointer infant_;
+        void *record_deserializer_;
+        void *key_deserializer_;
+    };
+
+    // writes and publishes the checkpoint, then settles the keys drained
+    // from the change feed and truncates the log.
+    Stats Write(int64_t checkpoint_ts,
+                const std::string &path,
+                bool incremental);
+    Stats WriteFiles(int64_t checkpoint_ts,
+                     const std::string &path,
+                     bool incremental);
+
+    const std::string directory_;
+    VersionDb *version_db_;
+    txlog::TxLog *tx_log_;
+    const size_t thread_count_;
+    const int pipeline_depth_;
+    ChangeFeed *change_feed_;
+    std::vector<Table> tables_;
+};
+}  // namespace txservice::txckpt
+#endif  // TXSERVICE_TXCHECKPOINT_CHECKPOINT_COORDINATOR_H_
@@ -0,0 +1,68 @@
+#ifndef TXSERVICE_TXCHECKPOINT_CHECKPOINT_RESTORE_H_
+#define TXSERVICE_TXCHECKPOINT_CHECKPOINT_RESTORE_H_
+
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "versiondb/record.h"
+#include "versiondb/versiondb.h"
+
+namespace txservice::txckpt
+{
+/**
+ * Brings an empty VersionDb back to the state of the last checkpoint in a
+ * directory written by CheckpointCoordinator: the last full checkpoint with
+ * the incremental ones after it applied in order. The snapshot files of a
+ * partition are merged on their key order, the newest file holding a key
+ * giving its payload, so a partition is restored in one pass without
+ * holding it in memory. Partitions are restored by a pool of threads.
+ *
+ * Recovery runs Run, then LogReplay over the log, which skips the versions
+ * the checkpoint already holds and redoes the later ones on top of it. The
+ * time provider of the executors must then be set past both checkpoint_ts_
+ * and the max_commit_ts_ of the replay.
+ */
+class CheckpointRestore
+{
+public:
+    struct Stats
+    {
+        // snapshot files read, full and incremental
+        size_t files_ = 0;
+        size_t entries_ = 0;
+        // keys restored, tombstones included
+        size_t keys_ = 0;
+        int64_t checkpoint_ts_ = -1;
+    };
+
+    CheckpointRestore(const std::string &directory,
+                      VersionDb *version_db,
+                      size_t thread_count =
+                          std::thread::hardware_concurrency());
+
+    /// keys and records of table_name are read into copies of key and
+    /// record; partition_count as given to CheckpointCoordinator::AddTable.
+    void AddTable(const TableName &table_name,
+                  int partition_count,
+                  const Key &key,
+                  const Record &record);
+
+    /// checkpoint_ts_ of the stats is -1 if there is no checkpoint.
+    Stats Run();
+
+private:
+    struct Schema
+    {
+        int partition_count_;
+        Key::Pointer key_;
+        Record::Pointer record_;
+    };
+
+    const std::string directory_;
+    VersionDb *version_db_;
+    const size_t thread_count_;
+    std::unordered_map<TableName, Schema> tables_;
+};
+}  // namespace txservice::txckpt
+#endif  // TXSERVICE_TXCHECKPOINT_CHECKPOINT_RESTORE_H_
@@ -0,0 +1,99 @@
+#ifndef TXSERVICE_TXCHECKPOINT_KICKOUT_SERVICE_H_
+#define TXSERVICE_TXCHECKPOINT_KICKOUT_SERVICE_H_
+
+#include <stdint.h>
+#include <thread>
+#include <vector>
+#include "txcheckpoint/checkpoint-coordinator.h"
+#include "txcheckpoint/kickout.h"
+#include "versiondb/versiondb.h"
+
+namespace txservice::kickout
+{
+/**
+ * Evicts versions of a set of tables, every table partition by a Kickout
+ * with its own handler on a pool of threads, each keeping window
+ * KickoutVersion calls outstanding.
+ *
+ * After each round the LRU interval is adapted against memory_budget bytes
+ * of VersionDb::VersionMemoryUsage: halved while over the budget, doubled
+ * back up to TXN_EXPIRE_INTERVAL / 2 while below three quarters of it. Under
+ * the budget, a table whose last round kicked nothing out is skipped for
+ * twice as many rounds each time, up to 8. Cold keys are only dropped once
+ * in a durable checkpoint, so rounds are best run right after one. The
+ * in-memory backend keeps every key, and trims instead the versions
+ * superseded more than the LRU interval ago.
+ */
+class KickoutService
+{
+public:
+    struct Stats
+    {
+        size_t tables_ = 0;
+        size_t total_num_ = 0;
+        size_t kickout_num_ = 0;
+        size_t memory_usage_ = 0;
+        int64_t lru_interval_ = 0;
+
+        double KickoutRate() const
+        {
+            return total_num_ == 0
+                       ? 0.0
+                       : static_cast<double>(kickout_num_) / total_num_;
+        }
+    };
+
+    /// memory_budget 0 keeps the LRU interval fixed.
+    KickoutService(VersionDb *version_db,
+                   size_t memory_budget,
+                   size_t thread_count = std::thread::hardware_concurrency(),
+                   int window = Constant::KICKOUT_PIPELINE_DEPTH);
+
+    void AddTable(const TableName &table_name,
+                  int partition_count,
+                  void *key_deserializer = nullptr);
+
+    /**
+     * One round over the tables, dropping what is expired at kickout_ts and
+     * what is cold at kickout_ts and in the checkpoint at checkpoint_ts,
+     * then adapts the LRU interval. checkpoint_ts is the last durable one,
+     * as of CheckpointCoordinator::LastCheckpointTs; with kNoCheckpoint no
+     * key is dropped as a whole.
+     */
+    Stats Round(int64_t kickout_ts, int64_t checkpoint_ts);
+
+    int64_t LruInterval() const
+    {
+        return lru_interval_;
+    }
+
+    static constexpr int64_t kNoCheckpoint =
+        txckpt::CheckpointCoordinator::kNoCheckpoint;
+
+private:
+    struct Table
+    {
+        TableName table_name_;
+        int partition_count_;
+        void *key_deserializer_;
+        // rounds to skip before the next scan, and the length of the next
+        // skip if it is idle again.
+        int skip_ = 0;
+        int backoff_ = 1;
+    };
+
+    static constexpr int kMaxBackoff = 8;
+
+    static constexpr int64_t kMaxLruInterval =
+        Constant::TXN_EXPIRE_INTERVAL / 2;
+
+    VersionDb *version_db_;
+    const size_t memory_budget_;
+    const size_t thread_count_;
+    const int window_;
+    int64_t lru_interval_;
+    bool over_budget_ = false;
+    std::vector<Table> tables_;
+};
+}  // namespace txservice::kickout
+#endif  // TXSERVICE_TXCHECKPOINT_KICKOUT_SERVICE_H_
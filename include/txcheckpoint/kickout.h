@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <vector>
 #include "txcheckpoint/key-iterator.h"
 #include "versiondb/request/handler.h"
 
@@ -15,19 +17,56 @@ public:
           table_name_(table_name),
           key_deserializer_(key_deserializer){};
 
+    /// kicks out the keys of one partition of the handler only, keeping up
+    /// to window KickoutVersion calls outstanding in Run.
+    Kickout(request::Handler::Pointer handler,
+            const TableName &table_name,
+            int partition,
+            int window,
+            void *key_deserializer)
+        : handler_(std::move(handler)),
+          table_name_(table_name),
+          key_deserializer_(key_deserializer),
+          partition_(partition),
+          slots_(std::max(1, window))
+    {
+    }
+
     void NewKickout(int64_t kickout_ts)
     {
-        this->key_iterator = this->handler_->GetAllCurrentKeys(
-            this->table_name_, this->key_deserializer_);
-        this->checkpoint_ts = kickout_ts;
-        this->lru_ts = kickout_ts - txservice::Constant::TXN_EXPIRE_INTERVAL / 2;
+        NewKickout(kickout_ts,
+                   txservice::Constant::TXN_EXPIRE_INTERVAL / 2,
+                   kickout_ts);
+    }
+
+    // keys not accessed within lru_interval before kickout_ts are cold, and
+    // only dropped if their latest version is in the checkpoint at
+    // checkpoint_ts.
+    void NewKickout(int64_t kickout_ts,
+                    int64_t lru_interval,
+                    int64_t checkpoint_ts)
+    {
+        if (this->partition_ < 0)
+        {
+            this->key_iterator = this->handler_->GetAllCurrentKeys(
+                this->table_name_, this->key_deserializer_);
+        }
+        else
+        {
+            this->key_iterator = this->handler_->GetPartitionKeys(
+                this->table_name_, this->partition_, this->key_deserializer_);
+        }
+        this->checkpoint_ts = checkpoint_ts;
+        this->lru_ts = kickout_ts - lru_interval;
         this->expire_ts = kickout_ts - txservice::Constant::TXN_EXPIRE_INTERVAL;
+        this->total_num = 0;
+        this->kickout_num = 0;
     }
 
-    // do a round of scan-kick in that table; singleton thread for now.
+    // step through a round of scan-kick one key at a time.
     bool HasNext()
     {
-        return this->key_iterator->HasNext();
+        return this->key_iterator != nullptr && this->key_iterator->HasNext();
     }
 
     void MoveNext(txservice::request::HandlerResult<bool> &handler_result)
@@ -40,6 +79,16 @@ public:
                                             handler_result);
     }
 
+    // do the whole round, filling total_num and kickout_num. Throws if a
+    // KickoutVersion call fails.
+    void Run();
+
+    double KickoutRate() const
+    {
+        return total_num == 0 ? 0.0
+                              : static_cast<double>(kickout_num) / total_num;
+    }
+
     request::Handler::Pointer handler_;
     const TableName table_name_;
     txcheckpoint::KeyIterator::Pointer key_iterator;
@@ -48,11 +97,25 @@ public:
     // calculated after a round of kickout on the table.
     // it depends on upper layers to decide what to do corresponding to the
     // rate.
-    int total_num;
-    int kickout_num;
+    int total_num = 0;
+    int kickout_num = 0;
 
     int64_t checkpoint_ts;
     int64_t expire_ts;
     int64_t lru_ts;
+
+private:
+    struct Slot
+    {
+        Key::Pointer key_;
+        request::HandlerResult<bool> result_;
+    };
+
+    void Finish(Slot &slot);
+
+    // -1 for the whole table.
+    const int partition_ = -1;
+    // ring of the outstanding calls of Run.
+    std::vector<Slot> slots_ = std::vector<Slot>(1);
 };
 }  // namespace txservice::kickout
\ No newline at end of file
@@ -0,0 +1,199 @@
+#ifndef TXSERVICE_TXCHECKPOINT_SNAPSHOT_FILE_H_
+#define TXSERVICE_TXCHECKPOINT_SNAPSHOT_FILE_H_
+
+#include <stdint.h>
+#include <folly/compression/Compression.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "txcheckpoint/tx-checkpoint.h"
+
+namespace txservice::txckpt
+{
+/**
+ * Snapshot of one partition of a table at a checkpoint. The entries are
+ * sorted by their serialized key and stored in blocks of about
+ * SNAPSHOT_BLOCK_SIZE, each compressed on its own. The file ends with an
+ * index holding, for each block, its offset, sizes, checksum and first key,
+ * and a fixed size footer locating the index.
+ *
+ * An entry is its key length and key, is_deleted, version and commit
+ * timestamp, then its record length and record, all in their
+ * SerializeToBuffer format.
+ */
+struct SnapshotFooter
+{
+    static constexpr uint32_t kMagic = 0x46534e50;
+
+    uint64_t index_offset_;
+    uint64_t index_length_;
+    uint64_t entry_count_;
+    int64_t checkpoint_ts_;
+    uint32_t block_count_;
+    uint32_t codec_;
+    uint32_t index_checksum_;
+    uint32_t magic_;
+};
+
+/**
+ * Writes a snapshot file from entries added in any order. Up to run_size
+ * bytes of entries are held in memory; past that they are sorted and
+ * spilled to a run file next to the snapshot, and Finish merges the runs.
+ * A writer thus holds about run_size, plus SNAPSHOT_RUN_BUFFER_SIZE per run
+ * while merging, whatever the size of the partition.
+ */
+class SnapshotWriter
+{
+public:
+    /// the file is written as path.tmp and renamed to path by Finish.
+    SnapshotWriter(const std::string &path,
+                   int64_t checkpoint_ts,
+                   size_t run_size = Constant::SNAPSHOT_RUN_SIZE);
+    ~SnapshotWriter();
+
+    void Add(const CheckpointEntry &entry);
+
+    /// sorts, or merges, compresses and writes out the entries, then makes
+    /// the file durable under its final name.
+    void Finish();
+
+    size_t EntryCount() const
+    {
+        return entry_count_;
+    }
+
+    /// bytes of the entries before and after compression.
+    size_t RawBytes() const
+    {
+        return raw_bytes_;
+    }
+    size_t FileBytes() const
+    {
+        return file_bytes_;
+    }
+
+    /// the best codec folly has been built with.
+    static folly::io::CodecType PickCodec();
+
+private:
+    struct EntryRef
+    {
+        uint64_t offset_;
+        uint32_t length_;
+        uint32_t key_length_;
+    };
+
+    void SortEntries();
+    // writes the entries held, sorted, to a new run file.
+    void SpillRun();
+    void MergeRuns();
+    std::string RunPath(size_t run) const;
+    // appends a serialized entry to the block being built, writing out the
+    // block first if the entry does not fit.
+    void AddToBlock(const char *entry, uint32_t length, std::string_view key);
+    void FlushBlock();
+    void WriteBlock(const std::string &raw, const char *first_key,
+                    uint32_t first_key_length, uint32_t entry_count);
+    void Write(const char *data, size_t length);
+
+    const std::string path_;
+    const int64_t checkpoint_ts_;
+    const size_t run_size_;
+    std::unique_ptr<folly::io::Codec> codec_;
+    int fd_;
+    // serialized entries held, in the order they were added
+    std::string arena_;
+    std::vector<EntryRef> entries_;
+    size_t run_count_;
+    std::string block_;
+    std::string block_first_key_;
+    uint32_t block_entries_;
+    std::string index_;
+    size_t entry_count_;
+    uint32_t block_count_;
+    size_t raw_bytes_;
+    size_t file_bytes_;
+};
+
+/// reads back the entries of a snapshot file, in key order.
+class SnapshotReader
+{
+public:
+    /// keys and records are read into copies of key and record.
+    SnapshotReader(const std::string &path,
+                   const Key &key,
+                   const Record &record);
+    ~SnapshotReader();
+
+    bool MoveNext();
+
+    /// valid until the next MoveNext.
+    CheckpointEntry Current();
+
+    /// the serialized key of Current, which orders the entries; valid until
+    /// the next MoveNext.
+    std::string_view CurrentKey() const
+    {
+        return std::string_view(block_.data() + key_offset_, key_length_);
+    }
+
+    int64_t CheckpointTs() const
+    {
+        return footer_.checkpoint_ts_;
+    }
+    uint64_t EntryCount() const
+    {
+        return footer_.entry_count_;
+    }
+
+private:
+    struct BlockHandle
+    {
+        uint64_t offset_;
+        uint32_t length_;
+        uint32_t raw_length_;
+        uint32_t checksum_;
+    };
+
+    void Read(void *data, size_t length, uint64_t offset);
+
+    const std::string path_;
+    int fd_;
+    SnapshotFooter footer_;
+    std::unique_ptr<folly::io::Codec> codec_;
+    std::vector<BlockHandle> blocks_;
+    size_t next_block_;
+    std::string block_;
+    size_t block_offset_;
+    Key::Pointer key_;
+    Record::Pointer record_;
+    bool is_deleted_;
+    int64_t version_;
+    int64_t commit_ts_;
+    size_t key_offset_;
+    uint32_t key_length_;
+};
+
+/// directory of the snapshot files of the checkpoint at checkpoint_ts.
+std::string CheckpointPath(const std::string &directory,
+                           int64_t checkpoint_ts);
+
+/// directory of the snapshot files of the incremental checkpoint at
+/// checkpoint_ts, holding the keys changed since the checkpoint before it.
+std::string DeltaPath(const std::string &directory, int64_t checkpoint_ts);
+
+/// snapshot file of partition of table_name in checkpoint_path.
+std::string SnapshotPath(const std::string &checkpoint_path,
+                         const TableName &table_name,
+                         int partition);
+
+/// timestamps of the complete full checkpoints in directory, ascending.
+std::vector<int64_t> ListCheckpoints(const std::string &directory);
+
+/// timestamps of the complete incremental checkpoints in directory,
+/// ascending. The state at the last one is the last full checkpoint with the
+/// incremental ones after it applied in order.
+std::vector<int64_t> ListDeltas(const std::string &directory);
+}  // namespace txservice::txckpt
+#endif  // TXSERVICE_TXCHECKPOINT_SNAPSHOT_FILE_H_
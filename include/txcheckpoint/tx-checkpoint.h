@@ -1,8 +1,10 @@
 #ifndef TXSERVICE_TXCHECKPOINT_TX_CHECKPOINT_H_
 #define TXSERVICE_TXCHECKPOINT_TX_CHECKPOINT_H_
 
+#include "txcheckpoint/change-feed.h"
 #include "txcheckpoint/key-iterator.h"
 #include "txlog/txlog.h"
+#include "versiondb/record.h"
 #include "versiondb/request/handler.h"
 
 namespace txservice::txckpt
@@ -12,11 +14,32 @@ struct CheckpointEntry
     Key *key_;
     Record *record_;
     bool is_deleted_;
-    CheckpointEntry(Key *key, Record *record, bool is_deleted)
-        : key_(key), record_(record), is_deleted_(is_deleted)
+    // the version of the payload and its commit timestamp, which the log
+    // replayed after a restore goes on from.
+    int64_t version_;
+    int64_t commit_ts_;
+    CheckpointEntry(Key *key,
+                    Record *record,
+                    bool is_deleted,
+                    int64_t version,
+                    int64_t commit_ts)
+        : key_(key),
+          record_(record),
+          is_deleted_(is_deleted),
+          version_(version),
+          commit_ts_(commit_ts)
     {
     }
 };
+
+/**
+ * Iterates the latest committed payload of every key of one partition of a
+ * table that has a commit at or before the checkpoint timestamp. The payloads
+ * are read batch_size ahead: up to batch_size ReadPayload calls are kept
+ * outstanding on the handler, and MoveNext only waits for the oldest one.
+ * A key committed again after the checkpoint timestamp is read at its newer
+ * payload, which the log replays over idempotently.
+ */
 class TxCheckpoint
 {
 public:
@@ -28,25 +51,7 @@ public:
                  Record *infant,
                  void *record_deserializer = nullptr,
                  void *key_deserializer = nullptr,
-                 int batch_size = 1)
-        : batch_size_(batch_size)
-    {
-        this->table_name_ = table_name;
-        this->partition_ = partition;
-        this->tx_log_ = std::move(tx_log);
-        this->handler_ = std::move(handler);
-        this->key_deserializer_ = key_deserializer;
-        this->record_deserailizer_ = record_deserializer;
-        for (int idx = 0; idx < batch_size; idx++)
-        {
-            this->changes[0].push_back(std::move(infant->Copy()));
-            this->changes[1].push_back(std::move(infant->Copy()));
-            this->read_results.push_back(std::make_pair(
-                nullptr, request::HandlerResult<VersionEntry>()));
-            this->read_results[idx].second.result_.read_record_ =
-                changes[0][idx].get();
-        }
-    }
+                 int batch_size = 1);
 
     virtual ~TxCheckpoint() {};
 
@@ -59,14 +64,34 @@ public:
                                                   this->partition_,
                                                   this->checkpoint_ts_,
                                                   this->key_deserializer_));
+        this->issued_ = 0;
+        this->consumed_ = 0;
+        this->has_current_ = false;
     }
+
+    // start an iteration over only the keys of the partition committed
+    // since the last checkpoint, as recorded in change_feed.
+    virtual void NewIncrementalCheckpoint(int64_t checkpoint_ts,
+                                          ChangeFeed &change_feed)
+    {
+        this->checkpoint_ts_ = checkpoint_ts;
+        this->key_iterator_ = std::make_unique<ChangeFeedKeyIterator>(
+            change_feed.Drain(this->table_name_,
+                              this->partition_,
+                              this->checkpoint_ts_),
+            this->key_deserializer_);
+        this->issued_ = 0;
+        this->consumed_ = 0;
+        this->has_current_ = false;
+    }
+
     // go to the next change in this iteration.
     // Returns true if there is one, false otherwise indicating the end.
-    virtual bool MoveNext() = 0;
+    virtual bool MoveNext();
 
     // return the current data. Note it shouldn't be called twice without
     // MoveNext()
-    virtual CheckpointEntry Current() = 0;
+    virtual CheckpointEntry Current();
 
     virtual void Flush()
     {
@@ -74,8 +99,12 @@ public:
 
     virtual void DeleteActiveEntry(Key *key)
     {
-        handler_->CheckRemoveActEntry(
-            this->table_name_, this->partition_, key, this->checkpoint_ts_);
+        delete_result_.Reset();
+        handler_->CheckRemoveActEntry(this->table_name_,
+                                      this->partition_,
+                                      key,
+                                      this->checkpoint_ts_,
+                                      delete_result_);
     }
 
     void TruncateLog(int64_t truncate_ts)
@@ -84,22 +113,24 @@ public:
     }
 
 public:
-    void ReadPayload(int idx, Key &key)
+    struct Slot
     {
-        this->read_results[idx].first = &key;
-        this->handler_->GetVersionList(this->table_name_,
-                                       key,
-                                       this->read_results[idx].second,
-                                       this->record_deserailizer_);
-    }
+        Key::Pointer key_;
+        Record::Pointer record_;
+        request::HandlerResult<VersionEntry> result_;
+    };
+
+    void ReadPayload(int idx, Key &key);
 
     const int batch_size_;
-    std::vector<Record::Pointer> changes[2];
-    std::vector<
-        std::pair<Key *, request::HandlerResult<VersionEntry>>>
-        read_results;
+    // ring of the outstanding reads, slot i % batch_size_ holds the i-th key.
+    std::vector<Slot> slots_;
+    size_t issued_ = 0;
+    size_t consumed_ = 0;
+    bool has_current_ = false;
+    request::HandlerResult<Void> delete_result_;
 
-    KeyIterator::Pointer key_iterator_;
+    txcheckpoint::KeyIterator::Pointer key_iterator_;
 
     TableName table_name_;
     int partition_;
@@ -108,6 +139,6 @@ public:
     request::Handler::Pointer handler_;
     void *key_deserializer_;
     void *record_deserailizer_;
-}; 
+};
 }  // namespace txservice::txckpt
-#endif  // TXSERVICE_TXCHECKPOINT_KEY_ITERATOR_H_
\ No newline at end of file
+#endif  // TXSERVICE_TXCHECKPOINT_TX_CHECKPOINT_H_
@@ -0,0 +1,109 @@
+#ifndef TXSERVICE_TXLOG_FILE_TX_LOG_H_
+#define TXSERVICE_TXLOG_FILE_TX_LOG_H_
+
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "txlog/log-record.h"
+#include "txlog/txlog.h"
+
+namespace txservice::txlog
+{
+/**
+ * Write-ahead log in a directory of segment files, txlog.<n>. Executors
+ * serialize their commits into per-executor buffers; a flusher thread swaps
+ * the buffers out, writes them with one writev and makes the batch durable
+ * with one fdatasync, then finishes everyone waiting on it. While a sync is
+ * in flight the next batch builds up, so under load the batch window is the
+ * sync itself, and an idle log flushes at least every group commit window.
+ */
+class FileTxLog : public TxLog
+{
+public:
+    FileTxLog(const std::string &directory,
+              int executor_count,
+              int64_t group_commit_window_us =
+                  Constant::TX_LOG_GROUP_COMMIT_WINDOW_US,
+              size_t segment_size = Constant::TX_LOG_SEGMENT_SIZE);
+
+    ~FileTxLog();
+
+    virtual void Append(int executor_id,
+                        const transaction::LocalState::WriteSet *write_entry,
+                        const size_t size,
+                        const TxnEntry *txn_entry,
+                        bool sync = true) override;
+
+    virtual void AsyncAppend(
+        int executor_id,
+        const transaction::LocalState::WriteSet *write_entry,
+        const size_t size,
+        const TxnEntry *txn_entry,
+        std::atomic<bool> *is_finish,
+        bool sync = true,
+        request::CompletionListener *listener = nullptr) override;
+
+    virtual void AsyncAppend() override;
+
+    /// removes the segments holding only commits before timestamp.
+    virtual void CleanBefore(int64_t timestamp) override;
+
+    virtual void MarkReplayed(int64_t max_commit_ts) override;
+
+    virtual void Close() override;
+
+    /// paths of the segment files, oldest first.
+    std::vector<std::string> Segments();
+
+private:
+    struct Waiter
+    {
+        std::atomic<bool> *is_finish_;
+        request::CompletionListener *listener_;
+    };
+
+    struct alignas(Constant::CACHE_LINE_SIZE) ExecutorBuffer
+    {
+        std::mutex mutex_;
+        std::vector<char> data_;
+        std::vector<Waiter> waiters_;
+        int64_t max_commit_ts_ = -1;
+    };
+
+    void Serialize(ExecutorBuffer &buffer,
+                   const transaction::LocalState::WriteSet *write_entry,
+                   size_t size,
+                   const TxnEntry *txn_entry);
+    void FlushLoop();
+    // writes out and syncs one batch, returns whether there was any.
+    bool Flush();
+    void OpenSegment(uint64_t sequence);
+
+    const std::string directory_;
+    const int64_t group_commit_window_us_;
+    const size_t segment_size_;
+    std::vector<ExecutorBuffer> buffers_;
+
+    // flusher side: the swapped out buffers of the batch being written.
+    std::vector<std::vector<char>> batch_data_;
+    std::vector<Waiter> batch_waiters_;
+    int fd_;
+    size_t segment_bytes_;
+
+    // segments, the last one being written; guarded by segment_mutex_.
+    std::mutex segment_mutex_;
+    std::deque<LogSegment> segments_;
+
+    std::mutex flush_mutex_;
+    std::condition_variable flush_cv_;
+    bool kicked_;
+    bool stopping_;
+    bool closed_;
+    std::thread flusher_;
+};
+}  // namespace txservice::txlog
+#endif  // TXSERVICE_TXLOG_FILE_TX_LOG_H_
@@ -0,0 +1,103 @@
+#ifndef TXSERVICE_TXLOG_LOG_RECORD_H_
+#define TXSERVICE_TXLOG_LOG_RECORD_H_
+
+#include <assert.h>
+#include <stdint.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "transaction/local-state.h"
+#include "versiondb/tx-entry.h"
+
+namespace txservice::txlog
+{
+/**
+ * Header in front of every log record. The body is the TxnEntry, the number
+ * of write set entries, then each entry as its SetKey followed by its
+ * WriteSetEntry, all in their SerializeToBuffer format. checksum_ covers the
+ * body, so a record torn by a crash is recognised at replay.
+ */
+struct LogRecordHeader
+{
+    uint32_t length_;
+    uint32_t checksum_;
+
+    static uint32_t Checksum(const char *body, size_t length)
+    {
+        // FNV-1a
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; i++)
+        {
+            hash ^= static_cast<uint8_t>(body[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+};
+
+struct LogRecord
+{
+    /// bytes of the record, header included.
+    static size_t Length(const transaction::LocalState::WriteSet *write_entry,
+                         size_t size,
+                         const TxnEntry *txn_entry)
+    {
+        size_t length = sizeof(LogRecordHeader) +
+                        txn_entry->Serialize_Length() + Constant::INT_LENGTH;
+        for (size_t i = 0; i < size; i++)
+        {
+            const auto &entry = (*write_entry)[i];
+            length +=
+                entry.key_.Serialize_Length() + entry.entry_.Serialize_Length();
+        }
+        return length;
+    }
+
+    /// writes the record of Length bytes to buffer.
+    static void Serialize(char *buffer,
+                          size_t length,
+                          const transaction::LocalState::WriteSet *write_entry,
+                          size_t size,
+                          const TxnEntry *txn_entry)
+    {
+        char *body = buffer + sizeof(LogRecordHeader);
+        size_t body_length = length - sizeof(LogRecordHeader);
+        size_t offset = 0;
+        int entry_count = size;
+        txn_entry->SerializeToBuffer(body, offset);
+        memcpy(body + offset, &entry_count, Constant::INT_LENGTH);
+        offset += Constant::INT_LENGTH;
+        for (size_t i = 0; i < size; i++)
+        {
+            const auto &entry = (*write_entry)[i];
+            entry.key_.SerializeToBuffer(body, offset);
+            entry.entry_.SerializeToBuffer(body, offset);
+        }
+        assert(offset == body_length);
+
+        LogRecordHeader header{static_cast<uint32_t>(body_length),
+                               LogRecordHeader::Checksum(body, body_length)};
+        memcpy(buffer, &header, sizeof(header));
+    }
+};
+
+/// a segment file, with the newest commit it holds; INT64_MAX for segments
+/// of an earlier run, whose content is not known.
+struct LogSegment
+{
+    uint64_t sequence_;
+    int64_t max_commit_ts_;
+};
+
+/// logs keep their records in segment files txlog.<sequence> of a directory.
+std::string SegmentPath(const std::string &directory, uint64_t sequence);
+
+/// sequences of the segments in directory, ascending; creates the directory
+/// if it does not exist.
+std::vector<uint64_t> ListSegments(const std::string &directory);
+
+/// makes the files created in directory durable, so that a segment does not
+/// vanish in a crash together with the records acknowledged in it.
+void SyncDirectory(const std::string &directory);
+}  // namespace txservice::txlog
+#endif  // TXSERVICE_TXLOG_LOG_RECORD_H_
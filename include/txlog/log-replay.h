@@ -0,0 +1,127 @@
+#ifndef TXSERVICE_TXLOG_LOG_REPLAY_H_
+#define TXSERVICE_TXLOG_LOG_REPLAY_H_
+
+#include <stdint.h>
+#include <thread>
+#include <string>
+#include <unordered_map>
+#include "versiondb/record.h"
+#include "versiondb/versiondb.h"
+
+namespace txservice::txlog
+{
+/**
+ * Brings a VersionDb back to the committed state recorded in a log
+ * directory, as written by FileTxLog or UringTxLog. Every logged txn is
+ * marked committed, and every logged version is committed at its txn's
+ * commit timestamp: versions still dirty are committed in place, versions
+ * the store lost are uploaded again first. A segment is read up to its first
+ * torn record.
+ *
+ * Segments are scanned by a pool of threads, which bucket the versions by
+ * key; the buckets are then applied in parallel, each in commit order, so the
+ * versions of a key are redone oldest first by one thread.
+ *
+ * Once Run returns the time provider of the executors must be set past
+ * max_commit_ts_, and the log told with TxLog::MarkReplayed.
+ */
+class LogReplay
+{
+public:
+    struct Stats
+    {
+        size_t segments_ = 0;
+        // segments ending in a record torn by the crash
+        size_t torn_segments_ = 0;
+        size_t records_ = 0;
+        size_t versions_ = 0;
+        // versions superseded in the store, or of tables not added
+        size_t skipped_versions_ = 0;
+        int64_t max_commit_ts_ = -1;
+    };
+
+    LogReplay(const std::string &directory,
+              VersionDb *version_db,
+              size_t thread_count = std::thread::hardware_concurrency());
+
+    /// keys and records of table_name are read into copies of key and record.
+    void AddTable(const TableName &table_name,
+                  const Key &key,
+                  const Record &record);
+
+    Stats Run();
+
+    /**
+     * Redoes the commit of version of key by txn_id at commit_ts, waiting on
+     * handler. Commits the version if it is still dirty and uploads it
+     * first if the handler lost it.
+     *
+     * The Redo functions throw if a request of handler does not finish
+     * within Constant::RECOVERY_WAIT_TIMEOUT_US, and give up on a failing
+     * request after Constant::RECOVERY_RETRY_COUNT attempts.
+     * @return false if the version cannot be brought back, such as when a
+     *         later version of the key exists already.
+     */
+    static bool RedoVersion(request::Handler &handler,
+                            const TableName &table_name,
+                            const Key &key,
+                            int64_t version,
+                            bool is_deleted,
+                            Record *record,
+                            int64_t txn_id,
+                            int64_t commit_ts);
+
+    /**
+     * Puts back version of key, committed at commit_ts, as read from a
+     * checkpoint, waiting on handler. The log replayed afterwards goes on
+     * from it.
+     * @return false if the store holds key already.
+     */
+    static bool RestoreVersion(request::Handler &handler,
+                               const TableName &table_name,
+                               const Key &key,
+                               int64_t version,
+                               bool is_deleted,
+                               Record *record,
+                               int64_t commit_ts);
+
+    /// sets the status of txn_id, waiting on handler.
+    static bool RedoTxnStatus(request::Handler &handler,
+                              int64_t txn_id,
+                              TxnStatus status);
+
+    /// deletes the dirty version of an aborted txn, waiting on handler.
+    static bool RedoDeleteVersion(request::Handler &handler,
+                                  const TableName &table_name,
+                                  const Key &key,
+                                  int64_t version,
+                                  EntryExtension *extension);
+
+    /// gives back the read counter taken on version of key, waiting on
+    /// handler.
+    static bool RedoReleaseReadCounter(request::Handler &handler,
+                                       const TableName &table_name,
+                                       const Key &key,
+                                       int64_t version,
+                                       EntryExtension *extension);
+
+private:
+    struct Schema
+    {
+        Key::Pointer key_;
+        Record::Pointer record_;
+    };
+
+    struct Version;
+    struct Txn;
+    struct Scan;
+
+    void ScanSegment(uint64_t sequence, Scan &scan);
+
+    const std::string directory_;
+    VersionDb *version_db_;
+    const size_t thread_count_;
+    std::unordered_map<TableName, Schema> tables_;
+};
+}  // namespace txservice::txlog
+#endif  // TXSERVICE_TXLOG_LOG_REPLAY_H_
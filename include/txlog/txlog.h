@@ -1,7 +1,9 @@
 #ifndef TXSERVICE_TXLOG_TXLOG_H_
 #define TXSERVICE_TXLOG_TXLOG_H_
 
+#include <atomic>
 #include "transaction/local-state.h"
+#include "versiondb/request/handler-result.h"
 #include "versiondb/tx-entry.h"
 namespace txservice::txlog
 {
@@ -14,25 +16,40 @@ public:
 
     virtual void Append(
         int executor_id,
-        const std::vector<transaction::LocalState::KeyWriteSetEntry::Pointer>
-            *write_entry,
+        const transaction::LocalState::WriteSet *write_entry,
         const size_t size,
         const TxnEntry *txn_entry,
         bool sync = true) = 0;
 
+    // sets is_finish, then notifies listener if given, once the entry is
+    // durable, or right away when sync is false.
     virtual void AsyncAppend(
         int executor_id,
-        const std::vector<transaction::LocalState::KeyWriteSetEntry::Pointer>
-            *write_entry,
+        const transaction::LocalState::WriteSet *write_entry,
         const size_t size,
         const TxnEntry *txn_entry,
         std::atomic<bool> *is_finish,
-        bool sync = true) = 0;
+        bool sync = true,
+        request::CompletionListener *listener = nullptr) = 0;
 
+    // pushes out whatever has been appended so far without waiting for the
+    // batch window to close.
     virtual void AsyncAppend() = 0;
 
+    // called by executor executor_id on every pass of its loop; logs that
+    // submit and complete entries on the executor thread do it here.
+    virtual void Poll(int executor_id)
+    {
+    }
+
     virtual void CleanBefore(int64_t timestamp) = 0;
 
+    // the segments of an earlier run have been replayed, see LogReplay, and
+    // hold no commit after max_commit_ts; CleanBefore may remove them now.
+    virtual void MarkReplayed(int64_t max_commit_ts)
+    {
+    }
+
     virtual void Close() = 0;
 };
 }  // namespace txservice::txlog
@@ -0,0 +1,103 @@
+#ifndef TXSERVICE_TXLOG_URING_TX_LOG_H_
+#define TXSERVICE_TXLOG_URING_TX_LOG_H_
+
+#include <stdint.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "txlog/log-record.h"
+#include "txlog/txlog.h"
+
+namespace txservice::txlog
+{
+/**
+ * Write-ahead log that keeps persistence off the executor threads. Every
+ * executor serializes its commits into its own registered buffers and, from
+ * Poll in its loop, submits the filled buffer to its io_uring as a fixed
+ * write linked to an fdatasync, and finishes the entries of the buffers whose
+ * sync has completed. Writes are drained in order, so a finished entry never
+ * sits behind an unwritten one. Each executor writes its own segment files,
+ * in the same format and naming as FileTxLog; a full segment is swapped for
+ * a new one at once, and closed when its last buffer in flight completes.
+ *
+ * Where io_uring is unavailable the buffers go to one writer thread instead,
+ * which writes them with pwritev and syncs each file once per batch.
+ */
+class UringTxLog : public TxLog
+{
+public:
+    UringTxLog(const std::string &directory,
+               int executor_count,
+               size_t segment_size = Constant::TX_LOG_SEGMENT_SIZE,
+               bool use_uring = true);
+
+    ~UringTxLog();
+
+    /// blocks until the entry is durable, polling the executor's log.
+    virtual void Append(int executor_id,
+                        const transaction::LocalState::WriteSet *write_entry,
+                        const size_t size,
+                        const TxnEntry *txn_entry,
+                        bool sync = true) override;
+
+    virtual void AsyncAppend(
+        int executor_id,
+        const transaction::LocalState::WriteSet *write_entry,
+        const size_t size,
+        const TxnEntry *txn_entry,
+        std::atomic<bool> *is_finish,
+        bool sync = true,
+        request::CompletionListener *listener = nullptr) override;
+
+    /// entries are submitted by Poll, on the executor thread.
+    virtual void AsyncAppend() override
+    {
+    }
+
+    virtual void Poll(int executor_id) override;
+
+    virtual void CleanBefore(int64_t timestamp) override;
+
+    virtual void MarkReplayed(int64_t max_commit_ts) override;
+
+    /// waits for every submitted entry; call it once the executors stopped.
+    virtual void Close() override;
+
+    /// whether the log runs on io_uring rather than the writer thread.
+    bool UsesUring() const
+    {
+        return use_uring_;
+    }
+
+    /// paths of the segment files, oldest first.
+    std::vector<std::string> Segments();
+
+private:
+    struct Writer;
+
+    uint64_t NextSequence();
+    void WriterLoop();
+
+    const std::string directory_;
+    const size_t segment_size_;
+    bool use_uring_;
+    std::vector<std::unique_ptr<Writer>> writers_;
+
+    std::mutex sequence_mutex_;
+    uint64_t next_sequence_;
+    // segments of an earlier run, kept for replay.
+    std::vector<LogSegment> old_segments_;
+
+    // fallback writer thread and the buffers submitted to it
+    std::mutex writer_mutex_;
+    std::vector<std::pair<Writer *, size_t>> writes_;
+    std::condition_variable writer_cv_;
+    bool stopping_;
+    bool closed_;
+    std::thread writer_thread_;
+};
+}  // namespace txservice::txlog
+#endif  // TXSERVICE_TXLOG_URING_TX_LOG_H_
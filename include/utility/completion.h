@@ -0,0 +1,122 @@
+#ifndef TXSERVICE_UTILITY_COMPLETION_H_
+#define TXSERVICE_UTILITY_COMPLETION_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <climits>
+#include <thread>
+#include "utility/configuration.h"
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace txservice
+{
+/**
+ * One-shot completion flag. Wait spins for a while, then yields, and only
+ * then sleeps on a futex, so a waiter for a short operation never pays for a
+ * kernel round-trip and one for a long operation does not burn its core.
+ */
+class Completion
+{
+public:
+    void Reset()
+    {
+        state_.store(kPending, std::memory_order_relaxed);
+    }
+
+    bool IsSet() const
+    {
+        return state_.load(std::memory_order_acquire) == kDone;
+    }
+
+    void Set()
+    {
+        if (state_.exchange(kDone, std::memory_order_acq_rel) == kSleeping)
+        {
+            Wake();
+        }
+    }
+
+    void Wait()
+    {
+        for (size_t i = 0; i < Constant::COMPLETION_SPIN_COUNT; i++)
+        {
+            if (IsSet())
+            {
+                return;
+            }
+            Pause();
+        }
+        for (size_t i = 0; i < Constant::COMPLETION_YIELD_COUNT; i++)
+        {
+            if (IsSet())
+            {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        uint32_t state = state_.load(std::memory_order_acquire);
+        while (state != kDone)
+        {
+            // announce the sleeper so that Set knows to wake it up.
+            if (state == kSleeping ||
+                state_.compare_exchange_weak(state,
+                                             kSleeping,
+                                             std::memory_order_acq_rel))
+            {
+                Sleep();
+            }
+            state = state_.load(std::memory_order_acquire);
+        }
+    }
+
+private:
+    static constexpr uint32_t kPending = 0;
+    static constexpr uint32_t kSleeping = 1;
+    static constexpr uint32_t kDone = 2;
+
+    static void Pause()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    void Sleep()
+    {
+#ifdef __linux__
+        syscall(SYS_futex,
+                reinterpret_cast<uint32_t *>(&state_),
+                FUTEX_WAIT_PRIVATE,
+                kSleeping,
+                nullptr,
+                nullptr,
+                0);
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    void Wake()
+    {
+#ifdef __linux__
+        syscall(SYS_futex,
+                reinterpret_cast<uint32_t *>(&state_),
+                FUTEX_WAKE_PRIVATE,
+                INT_MAX,
+                nullptr,
+                nullptr,
+                0);
+#endif
+    }
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+    std::atomic<uint32_t> state_ = kPending;
+};
+}  // namespace txservice
+#endif  // TXSERVICE_UTILITY_COMPLETION_H_
@@ -14,7 +14,7 @@ struct Constant
     static constexpr size_t FLOAT_LENGTH = sizeof(float);
     static constexpr size_t BOOL_LENGTH = sizeof(bool);
     static constexpr size_t TX_LOG_MAX_BATCH_THREAD_LOCAL_POOL = 1500;
-    static constexpr bool ENABLE_LOG = false;
+    static constexpr bool ENABLE_LOG = true;
     static constexpr bool LOG_SYNC_BUFFER = true;
     static constexpr size_t MAX_TXN_TIME_MS = 10;
     static constexpr size_t MAX_TIME_SKEW_MS = 0;
@@ -25,6 +25,47 @@ struct Constant
     static constexpr size_t TPCC_STRING_MIDDLE = 48;
     static constexpr size_t TPCC_STRING_LARGE = 100;
     static constexpr size_t ACTIVE_SET_PARTITION = 32;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    // ExecutorPool: empty passes of an executor before it parks on its
+    // request queue, and longest time it stays parked.
+    static constexpr size_t EXECUTOR_IDLE_PASSES = 1024;
+    static constexpr int64_t EXECUTOR_PARK_TIMEOUT_US = 1000;
+    // OperationRequest::Wait spins, then yields, before sleeping.
+    static constexpr size_t COMPLETION_SPIN_COUNT = 2000;
+    static constexpr size_t COMPLETION_YIELD_COUNT = 16;
+    // keys kept, and count-min sketch width, of the per-executor tracker of
+    // keys causing aborts; its counts are halved every decay interval.
+    static constexpr size_t HOT_KEY_TOP_K = 16;
+    static constexpr size_t HOT_KEY_SKETCH_WIDTH = 4096;
+    static constexpr size_t HOT_KEY_DECAY_INTERVAL = 1 << 16;
+    // FileTxLog: longest wait of an appended entry for its group commit when
+    // the log is idle, and size at which a new segment file is started.
+    static constexpr int64_t TX_LOG_GROUP_COMMIT_WINDOW_US = 200;
+    static constexpr size_t TX_LOG_SEGMENT_SIZE = 64 << 20;
+    static constexpr size_t TX_LOG_BUFFER_SIZE = 1 << 20;
+    // UringTxLog: registered buffers per executor, each of TX_LOG_BUFFER_SIZE;
+    // one is filled while the others are written.
+    static constexpr size_t TX_LOG_URING_BUFFER_COUNT = 4;
+    // LogReplay: key buckets per thread, so that skewed buckets even out.
+    static constexpr size_t LOG_REPLAY_BUCKETS_PER_THREAD = 8;
+    // recovery of a txn or a replayed log: attempts at a failed handler
+    // request, and longest wait on one, before giving up with an exception.
+    static constexpr int RECOVERY_RETRY_COUNT = 8;
+    static constexpr int64_t RECOVERY_WAIT_TIMEOUT_US = 10000000;
+    // CheckpointCoordinator: payload reads kept outstanding per partition,
+    // and size of the uncompressed blocks of the snapshot files.
+    static constexpr int CHECKPOINT_PIPELINE_DEPTH = 256;
+    static constexpr size_t SNAPSHOT_BLOCK_SIZE = 64 << 10;
+    // SnapshotWriter: entries held in memory before they are spilled as a
+    // sorted run, and read buffer per run when the runs are merged.
+    static constexpr size_t SNAPSHOT_RUN_SIZE = 64 << 20;
+    static constexpr size_t SNAPSHOT_RUN_BUFFER_SIZE = 1 << 20;
+    // KickoutService: KickoutVersion calls kept outstanding per partition,
+    // and the shortest LRU interval it adapts down to.
+    static constexpr int KICKOUT_PIPELINE_DEPTH = 256;
+    static constexpr int64_t KICKOUT_MIN_LRU_INTERVAL = 100000;
+    // read/write sets larger than this are looked up through a hash index.
+    static constexpr size_t LOCAL_STATE_INDEX_THRESHOLD = 16;
     // 10 seconds as expire time.
     static constexpr size_t TXN_EXPIRE_INTERVAL = 10000000; 
     // whether to use local cache for data store.
@@ -0,0 +1,83 @@
+#ifndef TXSERVICE_UTILITY_COUNT_MIN_SKETCH_H_
+#define TXSERVICE_UTILITY_COUNT_MIN_SKETCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+namespace txservice
+{
+/**
+ * Count-min sketch over 64-bit hashes: kDepth rows of width counters, each
+ * row indexed by a differently mixed hash. Estimates never undercount and
+ * overcount by about total / width with high probability. Not thread safe.
+ */
+class CountMinSketch
+{
+public:
+    static constexpr size_t kDepth = 4;
+
+    /// width is rounded up to a power of two.
+    explicit CountMinSketch(size_t width)
+    {
+        width_ = 1;
+        while (width_ < width)
+        {
+            width_ <<= 1;
+        }
+        counters_.assign(kDepth * width_, 0);
+    }
+
+    /// adds one occurrence of hash and returns its new estimate.
+    uint32_t Add(uint64_t hash)
+    {
+        uint32_t estimate = UINT32_MAX;
+        for (size_t row = 0; row < kDepth; row++)
+        {
+            uint32_t &counter = counters_[row * width_ + Column(hash, row)];
+            if (counter < UINT32_MAX)
+            {
+                counter++;
+            }
+            estimate = std::min(estimate, counter);
+        }
+        return estimate;
+    }
+
+    uint32_t Estimate(uint64_t hash) const
+    {
+        uint32_t estimate = UINT32_MAX;
+        for (size_t row = 0; row < kDepth; row++)
+        {
+            estimate =
+                std::min(estimate, counters_[row * width_ + Column(hash, row)]);
+        }
+        return estimate;
+    }
+
+    /// halves every counter, so that old occurrences fade out.
+    void Decay()
+    {
+        for (uint32_t &counter : counters_)
+        {
+            counter >>= 1;
+        }
+    }
+
+private:
+    size_t Column(uint64_t hash, size_t row) const
+    {
+        static constexpr uint64_t kSeeds[kDepth] = {0x9E3779B97F4A7C15ull,
+                                                    0xC2B2AE3D27D4EB4Full,
+                                                    0x165667B19E3779F9ull,
+                                                    0xD6E8FEB86659FD93ull};
+        uint64_t mixed = (hash ^ (hash >> 31)) * kSeeds[row];
+        return (mixed >> 32) & (width_ - 1);
+    }
+
+    size_t width_;
+    std::vector<uint32_t> counters_;
+};
+}  // namespace txservice
+#endif  // TXSERVICE_UTILITY_COUNT_MIN_SKETCH_H_
@@ -0,0 +1,60 @@
+#ifndef TXSERVICE_UTILITY_CYCLE_CLOCK_H_
+#define TXSERVICE_UTILITY_CYCLE_CLOCK_H_
+
+#include <stdint.h>
+#include <chrono>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace txservice
+{
+/**
+ * Cheap timestamps for latency measurement. On x86 Now reads the TSC, which
+ * costs a few nanoseconds and needs no system call; elsewhere it falls back
+ * to steady_clock nanoseconds. Ticks are turned into time only when metrics
+ * are read, through NanosPerTick.
+ */
+class CycleClock
+{
+public:
+    static uint64_t Now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+#endif
+    }
+
+    /// measured against steady_clock on first use, which takes ~10ms.
+    static double NanosPerTick()
+    {
+        static const double nanos_per_tick = Calibrate();
+        return nanos_per_tick;
+    }
+
+private:
+    static double Calibrate()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        auto begin_time = std::chrono::steady_clock::now();
+        uint64_t begin_ticks = Now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t end_ticks = Now();
+        auto end_time = std::chrono::steady_clock::now();
+        double nanos = std::chrono::duration<double, std::nano>(end_time -
+                                                                begin_time)
+                           .count();
+        return end_ticks > begin_ticks ? nanos / (end_ticks - begin_ticks)
+                                       : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+};
+}  // namespace txservice
+#endif  // TXSERVICE_UTILITY_CYCLE_CLOCK_H_
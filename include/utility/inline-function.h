@@ -0,0 +1,122 @@
+#ifndef TXSERVICE_UTILITY_INLINE_FUNCTION_H_
+#define TXSERVICE_UTILITY_INLINE_FUNCTION_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace txservice
+{
+template <typename Signature, size_t Capacity>
+class InlineFunction;
+
+/**
+ * Move-only callable kept in Capacity bytes inside the object, never on the
+ * heap. A callable that does not fit is rejected at compile time, so a
+ * lambda capturing a few references or pointers is fine and one capturing
+ * a std::string is not.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity>
+{
+public:
+    InlineFunction() = default;
+
+    InlineFunction(std::nullptr_t)
+    {
+    }
+
+    template <typename F,
+              typename = std::enable_if_t<
+                  !std::is_same_v<std::decay_t<F>, InlineFunction>>>
+    InlineFunction(F &&fn)
+    {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= Capacity,
+                      "callable too large for InlineFunction");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t),
+                      "callable over-aligned for InlineFunction");
+        new (storage_) Fn(std::forward<F>(fn));
+        invoke_ = [](void *storage, Args... args) -> R {
+            return (*static_cast<Fn *>(storage))(std::forward<Args>(args)...);
+        };
+        manage_ = [](void *to, void *from) {
+            if (to != nullptr)
+            {
+                new (to) Fn(std::move(*static_cast<Fn *>(from)));
+            }
+            static_cast<Fn *>(from)->~Fn();
+        };
+    }
+
+    InlineFunction(InlineFunction &&that) noexcept
+    {
+        MoveFrom(that);
+    }
+
+    InlineFunction &operator=(InlineFunction &&that) noexcept
+    {
+        if (this != &that)
+        {
+            Clear();
+            MoveFrom(that);
+        }
+        return *this;
+    }
+
+    InlineFunction &operator=(std::nullptr_t)
+    {
+        Clear();
+        return *this;
+    }
+
+    InlineFunction(const InlineFunction &) = delete;
+    InlineFunction &operator=(const InlineFunction &) = delete;
+
+    ~InlineFunction()
+    {
+        Clear();
+    }
+
+    explicit operator bool() const
+    {
+        return invoke_ != nullptr;
+    }
+
+    R operator()(Args... args)
+    {
+        return invoke_(storage_, std::forward<Args>(args)...);
+    }
+
+private:
+    void MoveFrom(InlineFunction &that)
+    {
+        if (that.invoke_ != nullptr)
+        {
+            that.manage_(storage_, that.storage_);
+            invoke_ = that.invoke_;
+            manage_ = that.manage_;
+            that.invoke_ = nullptr;
+            that.manage_ = nullptr;
+        }
+    }
+
+    void Clear()
+    {
+        if (invoke_ != nullptr)
+        {
+            manage_(nullptr, storage_);
+            invoke_ = nullptr;
+            manage_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[Capacity];
+    R (*invoke_)(void *, Args...) = nullptr;
+    // moves the callable from the second storage into the first, or only
+    // destroys it when the first is null.
+    void (*manage_)(void *, void *) = nullptr;
+};
+}  // namespace txservice
+#endif  // TXSERVICE_UTILITY_INLINE_FUNCTION_H_
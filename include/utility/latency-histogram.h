@@ -0,0 +1,140 @@
+#ifndef TXSERVICE_UTILITY_LATENCY_HISTOGRAM_H_
+#define TXSERVICE_UTILITY_LATENCY_HISTOGRAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+namespace txservice
+{
+/**
+ * Log-linear histogram in the style of HdrHistogram: every power of two is
+ * split into kSubBuckets linear buckets, so a recorded value is known to
+ * within 1/kSubBuckets of itself. Values of 2^kMaxMagnitude and more land in
+ * the last bucket.
+ *
+ * There is one writer, the executor thread, which updates the counters with
+ * plain relaxed stores. Readers on any thread take a Snapshot without
+ * stopping it; a snapshot may miss the values being recorded meanwhile.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr size_t kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr size_t kMaxMagnitude = 40;
+    static constexpr size_t kBucketCount =
+        (kMaxMagnitude - kSubBucketBits + 1) * kSubBuckets;
+
+    struct Snapshot
+    {
+        uint64_t count_ = 0;
+        uint64_t sum_ = 0;
+        uint64_t max_ = 0;
+        std::array<uint64_t, kBucketCount> buckets_{};
+
+        void Merge(const Snapshot &that)
+        {
+            count_ += that.count_;
+            sum_ += that.sum_;
+            max_ = std::max(max_, that.max_);
+            for (size_t i = 0; i < kBucketCount; i++)
+            {
+                buckets_[i] += that.buckets_[i];
+            }
+        }
+
+        double Mean() const
+        {
+            return count_ == 0 ? 0 : static_cast<double>(sum_) / count_;
+        }
+
+        /// upper bound of the bucket holding the q-quantile, q in [0, 1].
+        uint64_t Percentile(double q) const
+        {
+            if (count_ == 0)
+            {
+                return 0;
+            }
+            uint64_t rank = std::max<uint64_t>(1, q * count_ + 0.5);
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBucketCount; i++)
+            {
+                seen += buckets_[i];
+                if (seen >= rank)
+                {
+                    return i == kBucketCount - 1
+                               ? max_
+                               : std::min(BucketUpperBound(i), max_);
+                }
+            }
+            return max_;
+        }
+    };
+
+    void Record(uint64_t value)
+    {
+        Increment(buckets_[BucketIndex(value)], 1);
+        Increment(sum_, value);
+        if (value > max_.load(std::memory_order_relaxed))
+        {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    void TakeSnapshot(Snapshot &snapshot) const
+    {
+        snapshot.count_ = 0;
+        for (size_t i = 0; i < kBucketCount; i++)
+        {
+            snapshot.buckets_[i] = buckets_[i].load(std::memory_order_relaxed);
+            snapshot.count_ += snapshot.buckets_[i];
+        }
+        snapshot.sum_ = sum_.load(std::memory_order_relaxed);
+        snapshot.max_ = max_.load(std::memory_order_relaxed);
+    }
+
+    static size_t BucketIndex(uint64_t value)
+    {
+        if (value < kSubBuckets)
+        {
+            return value;
+        }
+        size_t magnitude = 63 - __builtin_clzll(value);
+        if (magnitude >= kMaxMagnitude)
+        {
+            return kBucketCount - 1;
+        }
+        size_t sub_bucket =
+            (value >> (magnitude - kSubBucketBits)) & (kSubBuckets - 1);
+        return (magnitude - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+    }
+
+    static uint64_t BucketUpperBound(size_t index)
+    {
+        if (index < kSubBuckets)
+        {
+            return index;
+        }
+        size_t magnitude = index / kSubBuckets + kSubBucketBits - 1;
+        uint64_t sub_bucket = index % kSubBuckets;
+        size_t shift = magnitude - kSubBucketBits;
+        return ((kSubBuckets + sub_bucket + 1) << shift) - 1;
+    }
+
+private:
+    // single writer, so a load and a store do not lose updates.
+    static void Increment(std::atomic<uint64_t> &counter, uint64_t delta)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + delta,
+                      std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> sum_ = 0;
+    std::atomic<uint64_t> max_ = 0;
+};
+}  // namespace txservice
+#endif  // TXSERVICE_UTILITY_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,60 @@
+#ifndef TXSERVICE_UTILITY_PARALLEL_FOR_H_
+#define TXSERVICE_UTILITY_PARALLEL_FOR_H_
+
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace txservice
+{
+/**
+ * Runs work(i) for every i in [0, count) on up to thread_count threads, the
+ * calling one included, handing out the indexes one at a time. The first
+ * exception thrown by work stops the handing out and is rethrown once every
+ * thread has returned.
+ */
+template <typename Work>
+void ParallelFor(size_t thread_count, size_t count, Work work)
+{
+    std::atomic<size_t> next{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto loop = [&]() {
+        try
+        {
+            for (size_t i = next++; i < count; i = next++)
+            {
+                work(i);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (error == nullptr)
+            {
+                error = std::current_exception();
+            }
+            next = count;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < std::min(thread_count, count); t++)
+    {
+        threads.emplace_back(loop);
+    }
+    loop();
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    if (error != nullptr)
+    {
+        std::rethrow_exception(error);
+    }
+}
+}  // namespace txservice
+#endif  // TXSERVICE_UTILITY_PARALLEL_FOR_H_
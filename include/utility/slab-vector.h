@@ -0,0 +1,83 @@
+#ifndef TXSERVICE_UTILITY_SLAB_VECTOR_H_
+#define TXSERVICE_UTILITY_SLAB_VECTOR_H_
+
+#include <stddef.h>
+#include <memory>
+#include <vector>
+
+namespace txservice
+{
+/**
+ * Indexable storage made of contiguous slabs, each one twice as large as the
+ * previous. Growing never moves existing elements, so pointers into it stay
+ * valid for the lifetime of the container, and N elements take O(log N)
+ * allocations.
+ */
+template <typename T>
+class SlabVector
+{
+public:
+    explicit SlabVector(size_t first_slab_size) : capacity_(0)
+    {
+        first_shift_ = 0;
+        while ((size_t(1) << first_shift_) < first_slab_size)
+        {
+            first_shift_++;
+        }
+        Grow();
+    }
+
+    SlabVector(const SlabVector &) = delete;
+    SlabVector &operator=(const SlabVector &) = delete;
+
+    T &operator[](size_t idx)
+    {
+        // slab k covers [(2^k - 1) << shift, (2^(k+1) - 1) << shift)
+        size_t slab = Log2((idx >> first_shift_) + 1);
+        size_t offset = idx - (((size_t(1) << slab) - 1) << first_shift_);
+        return slabs_[slab][offset];
+    }
+
+    const T &operator[](size_t idx) const
+    {
+        return const_cast<SlabVector *>(this)->operator[](idx);
+    }
+
+    size_t Capacity() const
+    {
+        return capacity_;
+    }
+
+    size_t SlabCount() const
+    {
+        return slabs_.size();
+    }
+
+    // append a slab, doubling the capacity.
+    void Grow()
+    {
+        size_t slab_size = size_t(1) << (first_shift_ + slabs_.size());
+        slabs_.push_back(std::make_unique<T[]>(slab_size));
+        capacity_ += slab_size;
+    }
+
+    void Reserve(size_t capacity)
+    {
+        while (capacity_ < capacity)
+        {
+            Grow();
+        }
+    }
+
+private:
+    static size_t Log2(size_t v)
+    {
+        return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(v);
+    }
+
+    size_t first_shift_;
+    size_t capacity_;
+    std::vector<std::unique_ptr<T[]>> slabs_;
+};
+}  // namespace txservice
+#endif  // TXSERVICE_UTILITY_SLAB_VECTOR_H_
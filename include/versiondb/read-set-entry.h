@@ -48,16 +48,29 @@ struct ReadSetEntry : Copyable<ReadSetEntry>
 
     Pointer Copy() const
     {
-        return std::make_unique<ReadSetEntry>(version_,
-                                              tx_id_,
-                                              begin_ts_,
-                                              end_ts_,
-                                              is_deleted_,
-                                              record_,
-                                              CopyPtr(extension_),
-                                              need_post_processing_,
-                                              need_release_,
-                                              is_updated_);
+        Pointer copy = std::make_unique<ReadSetEntry>(version_,
+                                                      tx_id_,
+                                                      begin_ts_,
+                                                      end_ts_,
+                                                      is_deleted_,
+                                                      record_,
+                                                      CopyPtr(extension_),
+                                                      need_post_processing_,
+                                                      need_release_,
+                                                      is_updated_);
+        if (pool_ != nullptr && record_ == pool_.get())
+        {
+            copy->KeepRecord(record_);
+        }
+        return copy;
+    }
+
+    /// makes record_ a copy of record owned by the entry, so that it does
+    /// not change with the buffer it was read into.
+    void KeepRecord(const Record *record)
+    {
+        pool_ = record == nullptr ? nullptr : record->Copy();
+        record_ = pool_.get();
     }
 
     void Reset(int64_t version,
@@ -90,6 +103,8 @@ struct ReadSetEntry : Copyable<ReadSetEntry>
     bool is_deleted_;
     bool is_updated_;
     Record* record_;
+    // payload record_ points to when kept by KeepRecord.
+    Record::Pointer pool_;
     bool need_post_processing_;
     bool need_release_;
     EntryExtension::Pointer extension_;
@@ -3,6 +3,14 @@
 
 namespace txservice::request
 {
+/// told when a HandlerResult it listens to has finished.
+class CompletionListener
+{
+public:
+    virtual ~CompletionListener() = default;
+    virtual void OnCompletion() = 0;
+};
+
 template <typename T>
 class HandlerResult
 {
@@ -23,6 +31,10 @@ public:
     void SetFinished()
     {
         is_finished_ = true;
+        if (listener_ != nullptr)
+        {
+            listener_->OnCompletion();
+        }
     }
 
     void SetError()
@@ -42,10 +54,16 @@ public:
         is_error_ = false;
     }
 
+    void SetListener(CompletionListener *listener)
+    {
+        listener_ = listener;
+    }
+
     T result_;
     bool is_finished_;
     bool is_error_;
     int ref_cnt;
+    CompletionListener *listener_ = nullptr;
 };
 }  // namespace txservice::request
 #endif  // TXSERVICE_VERSIONDB_REQUEST_HANDLER_RESULT_H_
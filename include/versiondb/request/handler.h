@@ -12,6 +12,43 @@
 
 namespace txservice::request
 {
+/// one key of a MultiUploadVersion, arguments as in UploadVersion.
+struct UploadVersionRequest
+{
+    const TableName *table_name_;
+    const Key *key_;
+    VersionEntry *version_entry_;
+    EntryExtension *extension_;
+    HandlerResult<int64_t> *result_;
+};
+
+/// one key of a MultiUpdateMaxCommitTsAndReread.
+struct UpdateMaxCommitTsRequest
+{
+    const TableName *table_name_;
+    const Key *key_;
+    int64_t version_key_;
+    int64_t max_commit_ts_;
+    EntryExtension *extension_;
+    HandlerResult<VersionEntry> *result_;
+};
+
+/// one key of a MultiCommitVersion.
+struct CommitVersionRequest
+{
+    const TableName *table_name_;
+    const Key *key_;
+    int64_t version_key_;
+    int64_t expect_txn_id_;
+    int64_t target_begin_ts_;
+    int64_t target_end_ts_;
+    int64_t target_tx_id_;
+    EntryExtension *extension_;
+    HandlerResult<Void> *result_;
+    Record *record_;
+    bool commited_;
+};
+
 class Handler
 {
 public:
@@ -162,6 +199,21 @@ public:
     virtual txcheckpoint::KeyIterator::Pointer GetAllCurrentKeys(
         const TableName &, void *) = 0;
 
+    /**
+     * Keys held for table_name in one partition of the backend, see
+     * PartitionOf. Backends that are not partitioned return every key for
+     * partition 0 and nullptr for the others.
+     */
+    virtual txcheckpoint::KeyIterator::Pointer GetPartitionKeys(
+        const TableName &table_name, int partition, void *key_deserializer)
+    {
+        if (partition != 0)
+        {
+            return nullptr;
+        }
+        return GetAllCurrentKeys(table_name, key_deserializer);
+    }
+
     virtual void InsertRangeEntry(int64_t txn_id,
                                   const TableName &table_name,
                                   const std::string &range,
@@ -194,6 +246,80 @@ public:
                              HandlerResult<VersionEntry> &,
                              void *) = 0;
 
+    /**
+     * The version of the key a read-only txn reading at read_ts sees: the
+     * committed one with begin_ts <= read_ts < end_ts. Writers yet to pick
+     * a commit timestamp are pushed past read_ts; the result is an error if
+     * one that picked an earlier one has not finished, or if the version
+     * has been evicted.
+     */
+    virtual void GetSnapshotVersion(const TableName &table_name,
+                                    const Key &key,
+                                    int64_t read_ts,
+                                    HandlerResult<VersionEntry> &,
+                                    void *) = 0;
+
+    /**
+     * Partition of the backend holding the key, used to send the requests of
+     * a partition together. Backends that are not partitioned keep 0.
+     */
+    virtual size_t PartitionOf(const TableName &table_name, const Key &key)
+    {
+        return 0;
+    }
+
+    /**
+     * Batched forms of the per-key calls above, issued for all the keys of a
+     * commit phase at once. Every request finishes its own result. The
+     * defaults issue one per-key call each; backends that can pipeline
+     * should override them.
+     */
+    virtual void MultiUploadVersion(
+        const std::vector<UploadVersionRequest> &requests)
+    {
+        for (const UploadVersionRequest &request : requests)
+        {
+            UploadVersion(*request.table_name_,
+                          *request.key_,
+                          *request.version_entry_,
+                          request.extension_,
+                          *request.result_);
+        }
+    }
+
+    virtual void MultiUpdateMaxCommitTsAndReread(
+        const std::vector<UpdateMaxCommitTsRequest> &requests)
+    {
+        for (const UpdateMaxCommitTsRequest &request : requests)
+        {
+            UpdateMaxCommitTsAndReread(*request.table_name_,
+                                       *request.key_,
+                                       request.version_key_,
+                                       request.max_commit_ts_,
+                                       request.extension_,
+                                       *request.result_);
+        }
+    }
+
+    virtual void MultiCommitVersion(
+        const std::vector<CommitVersionRequest> &requests)
+    {
+        for (const CommitVersionRequest &request : requests)
+        {
+            CommitVersion(*request.table_name_,
+                          *request.key_,
+                          request.version_key_,
+                          request.expect_txn_id_,
+                          request.target_begin_ts_,
+                          request.target_end_ts_,
+                          request.target_tx_id_,
+                          request.extension_,
+                          *request.result_,
+                          request.record_,
+                          request.commited_);
+        }
+    }
+
     virtual void SendBatch()
     {
     }
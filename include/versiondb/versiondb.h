@@ -23,6 +23,12 @@ public:
     {
         return true;
     }
+    // approximate bytes held by the versions of all tables, 0 if the backend
+    // does not account for it.
+    virtual size_t VersionMemoryUsage()
+    {
+        return 0;
+    }
 
     virtual ~VersionDb() = default;
 };
@@ -60,9 +60,13 @@ struct WriteSetEntry : Copyable<WriteSetEntry>
     size_t Serialize_Length() const
     {
         size_t length = 0;
-        length += Constant::INT_LENGTH;
+        length += Constant::INT64_T_LENGTH;
         length += Constant::BOOL_LENGTH;
-        length += record_->Serialize_Length();
+        // deleted entries carry no record.
+        if (!is_deleted_)
+        {
+            length += record_->Serialize_Length();
+        }
         return length;
     }
 
@@ -72,7 +76,10 @@ struct WriteSetEntry : Copyable<WriteSetEntry>
         offset += Constant::INT64_T_LENGTH;
         memcpy(buffer + offset, &is_deleted_, Constant::BOOL_LENGTH);
         offset += Constant::BOOL_LENGTH;
-        record_->SerializeToBuffer(buffer, offset);
+        if (!is_deleted_)
+        {
+            record_->SerializeToBuffer(buffer, offset);
+        }
     }
 
     int64_t version_;
@@ -0,0 +1,701 @@
+#include "memory/in-memory-handler.h"
+
+namespace txservice::memory
+{
+void InMemoryHandler::CopyOut(const VersionCell &cell,
+                              VersionEntry &entry,
+                              bool with_record)
+{
+    entry.version_ = cell.version_;
+    entry.tx_id_ = cell.tx_id_;
+    entry.begin_ts_ = cell.begin_ts_;
+    entry.end_ts_ = cell.end_ts_;
+    entry.max_commit_ts_ = cell.max_commit_ts_;
+    entry.is_deleted_ = cell.is_deleted_;
+    if (!with_record || cell.record_ == nullptr)
+    {
+        return;
+    }
+    if (entry.read_record_ != nullptr)
+    {
+        entry.read_record_->CopyFrom(*cell.record_);
+    }
+    else
+    {
+        entry.pool_ = cell.record_->Copy();
+        entry.read_record_ = entry.pool_.get();
+    }
+}
+
+void InMemoryHandler::CopyOut(const TxnEntry &from, TxnEntry &to)
+{
+    to.tx_id = from.tx_id;
+    to.status = from.status;
+    to.commit_ts = from.commit_ts;
+    to.commit_lower_bound = from.commit_lower_bound;
+}
+
+void InMemoryHandler::UploadVersion(const TableName &table_name,
+                                    const Key &key,
+                                    VersionEntry &version_entry,
+                                    EntryExtension *extension,
+                                    request::HandlerResult<int64_t> &result)
+{
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    VersionPartition &partition = table->GetPartition(key);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    VersionList *list = partition.Find(key);
+    VersionCell *latest = list == nullptr ? nullptr : list->Latest();
+    // the new version must directly follow a committed one, anything else
+    // means another writer got there first.
+    if (latest == nullptr || !latest->IsCommitted() ||
+        latest->version_ + 1 != version_entry.version_)
+    {
+        result.SetError();
+        return;
+    }
+    latest->tx_id_ = version_entry.tx_id_;
+    result.result_ = latest->max_commit_ts_;
+    list->versions_.emplace_back(version_entry.version_,
+                                 version_entry.tx_id_,
+                                 VersionEntry::kDefaultBeginTs,
+                                 VersionEntry::kDefaultEndTs,
+                                 version_entry.is_deleted_);
+    result.SetFinished();
+}
+
+void InMemoryHandler::DeleteVersion(const TableName &table_name,
+                                    const Key &key,
+                                    int64_t version_key,
+                                    EntryExtension *extension,
+                                    request::HandlerResult<Void> &result)
+{
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    VersionPartition &partition = table->GetPartition(key);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    VersionList *list = partition.Find(key);
+    VersionCell *latest = list == nullptr ? nullptr : list->Latest();
+    if (latest != nullptr && latest->version_ == version_key &&
+        !latest->IsCommitted())
+    {
+        int64_t tx_id = latest->tx_id_;
+        list->versions_.pop_back();
+        VersionCell *prev = list->Latest();
+        if (prev != nullptr && prev->tx_id_ == tx_id)
+        {
+            prev->tx_id_ = VersionEntry::kEmptyTxId;
+        }
+    }
+    result.SetFinished();
+}
+
+void InMemoryHandler::CleanStaleVersion(const TableName &table_name,
+                                        int64_t end_time,
+                                        request::HandlerResult<Void> &result)
+{
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    for (size_t i = 0; i < table->GetPartitionCount(); i++)
+    {
+        VersionPartition &partition = table->GetPartition(i);
+        std::lock_guard<std::mutex> lk(partition.mutex_);
+        for (auto &it : partition.lists_)
+        {
+            VersionList &list = it.second;
+            if (list.read_count_ > 0)
+            {
+                continue;
+            }
+            while (list.versions_.size() > 1 &&
+                   list.versions_[1].IsCommitted() &&
+                   list.versions_.front().end_ts_ < end_time)
+            {
+                list.versions_.pop_front();
+            }
+        }
+    }
+    result.SetFinished();
+}
+
+void InMemoryHandler::CleanStaleTxn(int64_t end_time,
+                                    request::HandlerResult<Void> &result)
+{
+    TxnTable &txn_table = db_->GetTxnTable();
+    for (size_t i = 0; i < txn_table.GetPartitionCount(); i++)
+    {
+        TxnPartition &partition = txn_table.GetPartition(i);
+        std::lock_guard<std::mutex> lk(partition.mutex_);
+        for (auto it = partition.txns_.begin(); it != partition.txns_.end();)
+        {
+            TxnStatus status = it->second.entry_.status;
+            if ((status == TxnStatus::kCommitted ||
+                 status == TxnStatus::kAborted) &&
+                it->second.begin_time_ < end_time)
+            {
+                it = partition.txns_.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+    result.SetFinished();
+}
+
+void InMemoryHandler::InitVersionList(const TableName &table_name,
+                                      const Key &key,
+                                      VersionEntry &version_entry,
+                                      request::HandlerResult<bool> &result)
+{
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    VersionPartition &partition = table->GetPartition(key);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    if (partition.Find(key) != nullptr)
+    {
+        result.result_ = false;
+        result.SetFinished();
+        return;
+    }
+    VersionList &list = partition.FindOrInit(key);
+    list.versions_.clear();
+    list.versions_.emplace_back(version_entry.version_,
+                                version_entry.tx_id_,
+                                version_entry.begin_ts_,
+                                version_entry.end_ts_,
+                                version_entry.is_deleted_);
+    Record *record = version_entry.write_record_ != nullptr
+                         ? version_entry.write_record_
+                         : version_entry.read_record_;
+    if (record != nullptr)
+    {
+        list.versions_.back().record_ = record->Copy();
+    }
+    result.result_ = true;
+    result.SetFinished();
+}
+
+void InMemoryHandler::CommitVersion(const TableName &table_name,
+                                    const Key &key,
+                                    int64_t version_key,
+                                    int64_t expect_txn_id,
+                                    int64_t target_begin_ts,
+                                    int64_t target_end_ts,
+                                    int64_t target_tx_id,
+                                    EntryExtension *extension,
+                                    request::HandlerResult<Void> &result,
+                                    Record *record,
+                                    bool commited)
+{
+    // there is no separate data store write to wait for.
+    result.ref_cnt = 0;
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    VersionPartition &partition = table->GetPartition(key);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    VersionList *list = partition.Find(key);
+    VersionCell *cell = list == nullptr ? nullptr : list->Find(version_key);
+    if (cell == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    if (cell->tx_id_ != expect_txn_id)
+    {
+        // committing the same version twice is harmless.
+        if (cell->IsCommitted() && cell->begin_ts_ == target_begin_ts)
+        {
+            result.SetFinished();
+        }
+        else
+        {
+            result.SetError();
+        }
+        return;
+    }
+
+    cell->begin_ts_ = target_begin_ts;
+    cell->end_ts_ = target_end_ts;
+    cell->tx_id_ = target_tx_id;
+    if (!cell->is_deleted_ && record != nullptr)
+    {
+        cell->record_ = record->Copy();
+    }
+
+    VersionCell *prev = list->Find(version_key - 1);
+    if (prev != nullptr && prev->end_ts_ == VersionEntry::kMaxTimeStamp)
+    {
+        prev->end_ts_ = target_begin_ts;
+        prev->tx_id_ = VersionEntry::kEmptyTxId;
+    }
+    if (list->read_count_ > 0)
+    {
+        list->read_count_--;
+    }
+    result.SetFinished();
+}
+
+void InMemoryHandler::UpdateMaxCommitTsAndReread(
+    const TableName &table_name,
+    const Key &key,
+    int64_t version_key,
+    int64_t max_commit_ts,
+    EntryExtension *extension,
+    request::HandlerResult<VersionEntry> &result)
+{
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    VersionPartition &partition = table->GetPartition(key);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    VersionList *list = partition.Find(key);
+    VersionCell *cell = list == nullptr ? nullptr : list->Find(version_key);
+    if (cell == nullptr)
+    {
+        // the version has been evicted, the reader has to abort.
+        result.result_.version_ = VersionEntry::kDefaultVersion;
+        result.SetFinished();
+        return;
+    }
+    cell->max_commit_ts_ = std::max(cell->max_commit_ts_, max_commit_ts);
+    CopyOut(*cell, result.result_);
+    if (list->read_count_ > 0)
+    {
+        list->read_count_--;
+    }
+    result.SetFinished();
+}
+
+void InMemoryHandler::ReleaseReadCounter(const TableName &table_name,
+                                         const Key &key,
+                                         int64_t version_key,
+                                         EntryExtension *extension,
+                                         request::HandlerResult<Void> &result)
+{
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    VersionPartition &partition = table->GetPartition(key);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    VersionList *list = partition.Find(key);
+    if (list != nullptr && list->read_count_ > 0)
+    {
+        list->read_count_--;
+    }
+    result.SetFinished();
+}
+
+void InMemoryHandler::GetVersionList(
+    const TableName &table_name,
+    const Key &key,
+    const int64_t time,
+    request::HandlerResult<std::vector<VersionEntry>> &result,
+    void *)
+{
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    std::vector<VersionEntry> &entries = result.result_;
+    while (entries.size() < 2)
+    {
+        entries.emplace_back();
+    }
+
+    VersionPartition &partition = table->GetPartition(key);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    VersionList &list = partition.FindOrInit(key);
+    list.read_count_++;
+
+    size_t size = list.versions_.size();
+    const VersionCell &latest = list.versions_[size - 1];
+    // a dirty latest version is invisible, its predecessor is read instead.
+    CopyOut(latest, entries[0], latest.IsCommitted());
+    if (size > 1)
+    {
+        CopyOut(list.versions_[size - 2], entries[1], !latest.IsCommitted());
+    }
+    else
+    {
+        entries[1].version_ = VersionEntry::kDefaultVersion;
+        entries[1].tx_id_ = VersionEntry::kEmptyTxId;
+        entries[1].begin_ts_ = VersionEntry::kDefaultBeginTs;
+        entries[1].end_ts_ = VersionEntry::kDefaultEndTs;
+        entries[1].is_deleted_ = true;
+    }
+    result.SetFinished();
+}
+
+void InMemoryHandler::GetTxn(int64_t txn_id,
+                             request::HandlerResult<TxnEntry> &result)
+{
+    TxnPartition &partition = db_->GetTxnTable().GetPartition(txn_id);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    auto it = partition.txns_.find(txn_id);
+    if (it == partition.txns_.end())
+    {
+        result.SetError();
+        return;
+    }
+    CopyOut(it->second.entry_, result.result_);
+    result.SetFinished();
+}
+
+void InMemoryHandler::NewTxn(TxnEntry &entry,
+                             int64_t local_time,
+                             int64_t max_txn_execution_time_ms,
+                             request::HandlerResult<Void> &result)
+{
+    TxnPartition &partition = db_->GetTxnTable().GetPartition(entry.tx_id);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    TxnCell &cell = partition.txns_[entry.tx_id];
+    // an id still owned by a live transaction can not be recycled yet.
+    if (cell.entry_.tx_id == entry.tx_id &&
+        cell.entry_.status == TxnStatus::kOngoing &&
+        local_time - cell.begin_time_ < max_txn_execution_time_ms * 1000)
+    {
+        result.SetError();
+        return;
+    }
+    cell.entry_.Reset(entry.tx_id, entry.commit_lower_bound);
+    cell.begin_time_ = local_time;
+    result.SetFinished();
+}
+
+void InMemoryHandler::SetCommitTimestamp(int64_t txn_id,
+                                         int64_t commit_ts,
+                                         EntryExtension *extension,
+                                         request::HandlerResult<int64_t> &result)
+{
+    TxnPartition &partition = db_->GetTxnTable().GetPartition(txn_id);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    auto it = partition.txns_.find(txn_id);
+    if (it == partition.txns_.end())
+    {
+        result.SetError();
+        return;
+    }
+    TxnEntry &txn = it->second.entry_;
+    if (txn.status != TxnStatus::kOngoing)
+    {
+        result.result_ = TxnEntry::kDefaultCommitTs;
+    }
+    else
+    {
+        if (txn.commit_ts == TxnEntry::kDefaultCommitTs)
+        {
+            txn.commit_ts = std::max(commit_ts, txn.commit_lower_bound);
+        }
+        result.result_ = txn.commit_ts;
+    }
+    result.SetFinished();
+}
+
+void InMemoryHandler::UpdateCommitLowerBound(
+    int64_t txn_id,
+    int64_t commit_ts_lower_bound,
+    request::HandlerResult<TxnEntry> &result)
+{
+    TxnPartition &partition = db_->GetTxnTable().GetPartition(txn_id);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    auto it = partition.txns_.find(txn_id);
+    if (it == partition.txns_.end())
+    {
+        result.SetError();
+        return;
+    }
+    TxnEntry &txn = it->second.entry_;
+    if (txn.status == TxnStatus::kOngoing &&
+        txn.commit_ts == TxnEntry::kDefaultCommitTs)
+    {
+        txn.commit_lower_bound =
+            std::max(txn.commit_lower_bound, commit_ts_lower_bound);
+    }
+    CopyOut(txn, result.result_);
+    result.SetFinished();
+}
+
+void InMemoryHandler::UpdateTxnStatus(int64_t txn_id,
+                                      TxnStatus status,
+                                      EntryExtension *extension,
+                                      request::HandlerResult<Void> &result)
+{
+    TxnPartition &partition = db_->GetTxnTable().GetPartition(txn_id);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    TxnCell &cell = partition.txns_[txn_id];
+    cell.entry_.tx_id = txn_id;
+    cell.entry_.status = status;
+    result.SetFinished();
+}
+
+txcheckpoint::KeyIterator::Pointer InMemoryHandler::GetAllCurrentKeys(
+    const TableName &table_name, void *key_deserializer)
+{
+    std::vector<Key::Pointer> keys;
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table != nullptr)
+    {
+        for (size_t i = 0; i < table->GetPartitionCount(); i++)
+        {
+            VersionPartition &partition = table->GetPartition(i);
+            std::lock_guard<std::mutex> lk(partition.mutex_);
+            for (auto &it : partition.lists_)
+            {
+                keys.push_back(it.first->Copy());
+            }
+        }
+    }
+    return std::make_unique<SnapshotKeyIterator>(std::move(keys),
+                                                 key_deserializer);
+}
+
+txcheckpoint::KeyIterator::Pointer InMemoryHandler::GetPartitionKeys(
+    const TableName &table_name, int partition_id, void *key_deserializer)
+{
+    std::vector<Key::Pointer> keys;
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table != nullptr &&
+        static_cast<size_t>(partition_id) < table->GetPartitionCount())
+    {
+        VersionPartition &partition = table->GetPartition(
+            static_cast<size_t>(partition_id));
+        std::lock_guard<std::mutex> lk(partition.mutex_);
+        keys.reserve(partition.lists_.size());
+        for (auto &it : partition.lists_)
+        {
+            keys.push_back(it.first->Copy());
+        }
+    }
+    return std::make_unique<SnapshotKeyIterator>(std::move(keys),
+                                                 key_deserializer);
+}
+
+txcheckpoint::KeyIterator::Pointer InMemoryHandler::GetCheckpointKeys(
+    TableName &table_name,
+    int partition_id,
+    int64_t checkpoint_ts,
+    void *key_deserializer)
+{
+    std::vector<Key::Pointer> keys;
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table != nullptr && partition_id >= 0 &&
+        static_cast<size_t>(partition_id) < table->GetPartitionCount())
+    {
+        VersionPartition &partition = table->GetPartition(partition_id);
+        std::lock_guard<std::mutex> lk(partition.mutex_);
+        for (auto &it : partition.lists_)
+        {
+            // skip keys that only hold the pseudo version.
+            for (auto &cell : it.second.versions_)
+            {
+                if (cell.version_ > VersionEntry::kFirstVersion &&
+                    cell.IsCommitted() && cell.begin_ts_ <= checkpoint_ts)
+                {
+                    keys.push_back(it.first->Copy());
+                    break;
+                }
+            }
+        }
+    }
+    return std::make_unique<SnapshotKeyIterator>(std::move(keys),
+                                                 key_deserializer);
+}
+
+void InMemoryHandler::CheckRemoveActEntry(TableName &,
+                                          int,
+                                          Key *,
+                                          int64_t,
+                                          request::HandlerResult<Void> &result)
+{
+    result.SetFinished();
+}
+
+void InMemoryHandler::KickoutVersion(const TableName &table_name,
+                                     const Key *key,
+                                     int64_t checkpoint_ts,
+                                     int64_t expire_ts,
+                                     int64_t lru_ts,
+                                     request::HandlerResult<bool> &result)
+{
+    result.result_ = false;
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    VersionPartition &partition = table->GetPartition(*key);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    auto it = partition.lists_.find(key);
+    if (it == partition.lists_.end() || it->second.read_count_ > 0)
+    {
+        result.SetFinished();
+        return;
+    }
+
+    // versions superseded before lru_ts are only read by txns started
+    // before it, so the LRU interval, shortened under memory pressure,
+    // trims them ahead of their expiry.
+    VersionList &list = it->second;
+    int64_t trim_ts = std::max(expire_ts, lru_ts);
+    while (list.versions_.size() > 1 && list.versions_[1].IsCommitted() &&
+           list.versions_.front().end_ts_ < trim_ts)
+    {
+        list.versions_.pop_front();
+        result.result_ = true;
+    }
+
+    // the list itself stays: there is no data store behind this backend to
+    // read a dropped key back from, so checkpoint_ts only matters to
+    // backends that have one.
+    result.SetFinished();
+}
+
+void InMemoryHandler::GetVisibleVersionPromise(
+    const TableName &table_name,
+    const Key &key,
+    request::HandlerResult<VersionEntry> &result,
+    void *)
+{
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    VersionPartition &partition = table->GetPartition(key);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    VersionList *list = partition.Find(key);
+    if (list == nullptr)
+    {
+        VersionCell pseudo(VersionEntry::kFirstVersion,
+                           VersionEntry::kEmptyTxId,
+                           0,
+                           VersionEntry::kMaxTimeStamp,
+                           true);
+        CopyOut(pseudo, result.result_);
+        result.SetFinished();
+        return;
+    }
+    size_t size = list->versions_.size();
+    const VersionCell *visible = &list->versions_[size - 1];
+    if (!visible->IsCommitted() && size > 1)
+    {
+        visible = &list->versions_[size - 2];
+    }
+    CopyOut(*visible, result.result_, true);
+    result.SetFinished();
+}
+
+void InMemoryHandler::GetSnapshotVersion(
+    const TableName &table_name,
+    const Key &key,
+    int64_t read_ts,
+    request::HandlerResult<VersionEntry> &result,
+    void *)
+{
+    VersionTable *table = db_->GetVersionTable(table_name);
+    if (table == nullptr)
+    {
+        result.SetError();
+        return;
+    }
+    VersionPartition &partition = table->GetPartition(key);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    VersionList *list = partition.Find(key);
+    if (list == nullptr)
+    {
+        VersionCell pseudo(VersionEntry::kFirstVersion,
+                           VersionEntry::kEmptyTxId,
+                           0,
+                           VersionEntry::kMaxTimeStamp,
+                           true);
+        CopyOut(pseudo, result.result_);
+        result.SetFinished();
+        return;
+    }
+    // the writer of a dirty latest version commits after read_ts, or has
+    // to be waited for.
+    const VersionCell &latest = list->versions_.back();
+    if (!latest.IsCommitted() && !PushWriterPast(latest.tx_id_, read_ts))
+    {
+        result.SetError();
+        return;
+    }
+    for (auto it = list->versions_.rbegin(); it != list->versions_.rend();
+         it++)
+    {
+        if (it->IsCommitted() && it->begin_ts_ <= read_ts)
+        {
+            // writers uploading a version after it commit past read_ts.
+            it->max_commit_ts_ = std::max(it->max_commit_ts_, read_ts);
+            CopyOut(*it, result.result_, true);
+            result.SetFinished();
+            return;
+        }
+    }
+    // the version visible at read_ts has been kicked out.
+    result.SetError();
+}
+
+bool InMemoryHandler::PushWriterPast(int64_t txn_id, int64_t read_ts)
+{
+    TxnPartition &partition = db_->GetTxnTable().GetPartition(txn_id);
+    std::lock_guard<std::mutex> lk(partition.mutex_);
+    auto it = partition.txns_.find(txn_id);
+    if (it == partition.txns_.end())
+    {
+        return false;
+    }
+    TxnEntry &txn = it->second.entry_;
+    if (txn.status == TxnStatus::kAborted)
+    {
+        return true;
+    }
+    if (txn.commit_ts == TxnEntry::kDefaultCommitTs)
+    {
+        txn.commit_lower_bound =
+            std::max(txn.commit_lower_bound, read_ts + 1);
+        return true;
+    }
+    return txn.commit_ts > read_ts;
+}
+
+size_t InMemoryHandler::PartitionOf(const TableName &table_name,
+                                    const Key &key)
+{
+    // the same for every table, see VersionTable::GetPartition.
+    return key.Hash() % db_->GetPartitionCount();
+}
+}  // namespace txservice::memory
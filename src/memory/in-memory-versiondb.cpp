@@ -0,0 +1,164 @@
+#include "memory/in-memory-versiondb.h"
+#include <assert.h>
+#include "memory/in-memory-handler.h"
+
+namespace txservice::memory
+{
+VersionCell *VersionList::Find(int64_t version)
+{
+    if (versions_.empty())
+    {
+        return nullptr;
+    }
+    // versions are consecutive, so the slot can be computed directly.
+    int64_t offset = version - versions_.front().version_;
+    if (offset < 0 || offset >= static_cast<int64_t>(versions_.size()))
+    {
+        return nullptr;
+    }
+    VersionCell *cell = &versions_[offset];
+    assert(cell->version_ == version);
+    return cell;
+}
+
+VersionCell *VersionList::Latest()
+{
+    return versions_.empty() ? nullptr : &versions_.back();
+}
+
+VersionList *VersionPartition::Find(const Key &key)
+{
+    auto it = lists_.find(&key);
+    return it == lists_.end() ? nullptr : &(it->second);
+}
+
+VersionList &VersionPartition::FindOrInit(const Key &key)
+{
+    auto it = lists_.find(&key);
+    if (it != lists_.end())
+    {
+        return it->second;
+    }
+
+    Key::Pointer owned = key.Copy();
+    const Key *raw = owned.get();
+    VersionList &list = lists_[raw];
+    list.key_ = std::move(owned);
+    // pseudo version standing for "not existing", see
+    // ReadOutsideOperation::InternalPickVisibleVersion.
+    list.versions_.emplace_back(VersionEntry::kFirstVersion,
+                                VersionEntry::kEmptyTxId,
+                                0,
+                                VersionEntry::kMaxTimeStamp,
+                                true);
+    return list;
+}
+
+VersionTable::VersionTable(size_t partition_count)
+    : partition_count_(partition_count),
+      partitions_(std::make_unique<VersionPartition[]>(partition_count))
+{
+}
+
+void VersionTable::Clear()
+{
+    for (size_t i = 0; i < partition_count_; i++)
+    {
+        std::lock_guard<std::mutex> lk(partitions_[i].mutex_);
+        partitions_[i].lists_.clear();
+    }
+}
+
+TxnTable::TxnTable(size_t partition_count)
+    : partition_count_(partition_count),
+      partitions_(std::make_unique<TxnPartition[]>(partition_count))
+{
+}
+
+void TxnTable::Clear()
+{
+    for (size_t i = 0; i < partition_count_; i++)
+    {
+        std::lock_guard<std::mutex> lk(partitions_[i].mutex_);
+        partitions_[i].txns_.clear();
+    }
+}
+
+InMemoryVersionDb::InMemoryVersionDb(size_t partition_count)
+    : partition_count_(partition_count), txn_table_(partition_count)
+{
+}
+
+request::Handler::Pointer InMemoryVersionDb::MakeHandler()
+{
+    return std::make_unique<InMemoryHandler>(this);
+}
+
+bool InMemoryVersionDb::CreateVersionTable(const TableName &table_name)
+{
+    std::unique_lock<std::shared_mutex> lk(table_mutex_);
+    if (version_tables_.find(table_name) != version_tables_.end())
+    {
+        return false;
+    }
+    version_tables_.emplace(table_name,
+                            std::make_unique<VersionTable>(partition_count_));
+    return true;
+}
+
+bool InMemoryVersionDb::DropVersionTable(const TableName &table_name)
+{
+    std::unique_lock<std::shared_mutex> lk(table_mutex_);
+    return version_tables_.erase(table_name) > 0;
+}
+
+bool InMemoryVersionDb::ClearTransactions()
+{
+    txn_table_.Clear();
+    return true;
+}
+
+bool InMemoryVersionDb::ClearVersions()
+{
+    std::shared_lock<std::shared_mutex> lk(table_mutex_);
+    for (auto &table : version_tables_)
+    {
+        table.second->Clear();
+    }
+    return true;
+}
+
+size_t InMemoryVersionDb::VersionMemoryUsage()
+{
+    size_t usage = 0;
+    std::shared_lock<std::shared_mutex> lk(table_mutex_);
+    for (auto &table : version_tables_)
+    {
+        for (size_t i = 0; i < table.second->GetPartitionCount(); i++)
+        {
+            VersionPartition &partition = table.second->GetPartition(i);
+            std::lock_guard<std::mutex> partition_lk(partition.mutex_);
+            for (auto &it : partition.lists_)
+            {
+                usage += sizeof(VersionList) + it.first->Serialize_Length();
+                for (const VersionCell &cell : it.second.versions_)
+                {
+                    usage += sizeof(VersionCell);
+                    if (cell.record_ != nullptr)
+                    {
+                        usage += cell.record_->Serialize_Length();
+                    }
+                }
+            }
+        }
+    }
+    return usage;
+}
+
+VersionTable *InMemoryVersionDb::GetVersionTable(const TableName &table_name)
+{
+    std::shared_lock<std::shared_mutex> lk(table_mutex_);
+    auto it = version_tables_.find(table_name);
+    return it == version_tables_.end() ? nullptr : it->second.get();
+}
+}  // namespace txservice::memory
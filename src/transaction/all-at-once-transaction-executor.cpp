@@ -1,4 +1,5 @@
 #include "transaction/all-at-once-transaction-executor.h"
+#include "utility/cycle-clock.h"
 
 namespace txservice::transaction
 {
@@ -18,7 +19,8 @@ AllAtOnceTransactionExecutor::AllAtOnceTransactionExecutor(
       concurrent_txn_count_(concurrent_txn_count),
       request_queue_pool_(capacity),
       push_index_(0),
-      pop_index_(0)
+      pop_index_(0),
+      ready_queue_(concurrent_txn_count)
 {
     active_txn_number_ = 0;
     for (int i = 0; i < concurrent_txn_count; i++)
@@ -33,10 +35,17 @@ AllAtOnceTransactionExecutor::AllAtOnceTransactionExecutor(
                                          transaction_request);
         active_txn_.push_back(transaction_task);
     }
+    for (int i = 0; i < concurrent_txn_count; i++)
+    {
+        active_txn_[i].GetTransactionExecution()->SetMetrics(&metrics_);
+        active_txn_[i].GetTransactionExecution()->SetReadyQueue(&ready_queue_,
+                                                                i);
+    }
+    ready_tasks_.reserve(concurrent_txn_count_);
 }
 
-void AllAtOnceTransactionExecutor::AddRequest(
-    std::shared_ptr<OperationRequest> operation_request)
+void AllAtOnceTransactionExecutor::Submit(
+    OperationRequest *operation_request)
 {
     request_queue_pool_[push_index_] = operation_request;
     push_index_++;
@@ -48,7 +57,7 @@ void AllAtOnceTransactionExecutor::LaunchRequests()
     size_t last_index = 0;
     while (pop_index_ < push_index_)
     {
-        std::shared_ptr<OperationRequest> operation_request =
+        OperationRequest *operation_request =
             request_queue_pool_[pop_index_];
 
         int64_t session_id = operation_request->session_id_;
@@ -67,11 +76,14 @@ void AllAtOnceTransactionExecutor::LaunchRequests()
                         ->PushRequest(operation_request);
                     find_empty_txn_task = true;
                     active_txn_number_++;
+                    active_txn_[last_index]
+                        .GetTransactionExecution()
+                        ->MarkReady();
 
                     while (pop_index_ < push_index_)
                     {
                         pop_index_++;
-                        std::shared_ptr<OperationRequest> operation_request =
+                        OperationRequest *operation_request =
                             request_queue_pool_[pop_index_];
 
                         int64_t session_id = operation_request->session_id_;
@@ -112,8 +124,11 @@ void AllAtOnceTransactionExecutor::Advance()
 
     while (!has_finished_txn)
     {
-        for (int i = 0; i < concurrent_txn_count_; i++)
+        ready_tasks_.clear();
+        ready_queue_.Drain(ready_tasks_);
+        for (int32_t i : ready_tasks_)
         {
+            active_txn_[i].GetTransactionExecution()->ClearReady();
             if (active_txn_[i].InUse())
             {
                 TransactionExecution *execution =
@@ -124,7 +139,7 @@ void AllAtOnceTransactionExecutor::Advance()
                 {
                     TransactionRequest *transaction_request =
                         active_txn_[i].GetTransactionRequest();
-                    std::shared_ptr<OperationRequest> operation_request =
+                    OperationRequest *operation_request =
                         transaction_request->CurrentRequest();
 
                     if (operation_request != nullptr)
@@ -220,27 +235,48 @@ void AllAtOnceTransactionExecutor::Advance()
                     if (execution->GetTxnStatus() ==
                         txservice::TxnStatus::kAborted)
                     {
-                        abort_count_++;
+                        metrics_.RecordAbort(execution->GetAbortReason());
                     }
                     if (execution->GetTxnStatus() ==
                         txservice::TxnStatus::kCommitted)
                     {
-                        commit_count_++;
+                        metrics_.RecordCommit(
+                            CycleClock::Now() -
+                            execution->GetCommitBeginTicks());
                     }
                     active_txn_[i].Release();
                     active_txn_number_--;
                     has_finished_txn = true;
                 }
+                else
+                {
+                    active_txn_[i].Reschedule();
+                }
             }
         }
         handler_->SendBatch();
+        if (tx_log_ != nullptr)
+        {
+            tx_log_->Poll(executor_id_);
+        }
     }
 }
 
-void AllAtOnceTransactionExecutor::Statistics(int &commit, int &abort)
+void AllAtOnceTransactionExecutor::SetCommitProtocol(
+    const StepOperation::Steps *protocol)
 {
-    commit = commit_count_;
-    abort = abort_count_;
+    for (TransactionTask &task : active_txn_)
+    {
+        task.GetTransactionExecution()->SetCommitProtocol(protocol);
+    }
+}
+
+void AllAtOnceTransactionExecutor::SetChangeFeed(txckpt::ChangeFeed *change_feed)
+{
+    for (TransactionTask &task : active_txn_)
+    {
+        task.GetTransactionExecution()->SetChangeFeed(change_feed);
+    }
 }
 
 void AllAtOnceTransactionExecutor::Run()
@@ -250,6 +286,10 @@ void AllAtOnceTransactionExecutor::Run()
         LaunchRequests();
         Advance();
     }
+    // drained, the requests submitted next reuse the queue from the front
+    // instead of running off its end.
+    push_index_ = 0;
+    pop_index_ = 0;
 }
 
 bool AllAtOnceTransactionExecutor::IsFinished()
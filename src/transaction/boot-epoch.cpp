@@ -0,0 +1,86 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "transaction/txn-id-generator.h"
+#include "txlog/log-record.h"
+
+namespace txservice::transaction
+{
+namespace
+{
+constexpr int64_t kEpochCount = int64_t(1) << BootEpoch::kBits;
+
+std::string DirectoryOf(const std::string &path)
+{
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? "." : path.substr(0, slash + 1);
+}
+}  // namespace
+
+BootEpoch::BootEpoch(int64_t boot_epoch) : epoch_(boot_epoch)
+{
+    if (boot_epoch < 0 || boot_epoch >= kEpochCount)
+    {
+        throw std::runtime_error("boot epoch out of range of the txn id");
+    }
+}
+
+BootEpoch::BootEpoch(const std::string &path) : path_(path), epoch_(-1)
+{
+    std::ifstream file(path_);
+    if (file.is_open() &&
+        (!(file >> epoch_) || epoch_ < 0 || epoch_ >= kEpochCount))
+    {
+        throw std::runtime_error("cannot read boot epoch from " + path_);
+    }
+    Next();
+}
+
+int64_t BootEpoch::Current()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return epoch_;
+}
+
+int64_t BootEpoch::Next()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t epoch = (epoch_ + 1) % kEpochCount;
+    if (!path_.empty())
+    {
+        Persist(epoch);
+    }
+    epoch_ = epoch;
+    return epoch_;
+}
+
+void BootEpoch::Persist(int64_t epoch)
+{
+    std::string tmp_path = path_ + ".tmp";
+    std::string content = std::to_string(epoch) + "\n";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 ||
+        write(fd, content.data(), content.size()) !=
+            static_cast<ssize_t>(content.size()) ||
+        fdatasync(fd) != 0)
+    {
+        std::string error = std::strerror(errno);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        throw std::runtime_error("cannot write boot epoch " + tmp_path +
+                                 ": " + error);
+    }
+    close(fd);
+    if (rename(tmp_path.c_str(), path_.c_str()) != 0)
+    {
+        throw std::runtime_error("cannot rename boot epoch " + tmp_path +
+                                 ": " + std::strerror(errno));
+    }
+    txlog::SyncDirectory(DirectoryOf(path_));
+}
+}  // namespace txservice::transaction
@@ -0,0 +1,403 @@
+#include "transaction/coalescing-handler.h"
+#include <algorithm>
+
+namespace txservice::transaction
+{
+CoalescingHandler::CoalescingHandler(request::Handler::Pointer handler)
+    : handler_(std::move(handler))
+{
+}
+
+void CoalescingHandler::UploadVersion(const TableName &table_name,
+                                      const Key &key,
+                                      VersionEntry &version_entry,
+                                      EntryExtension *extension,
+                                      request::HandlerResult<int64_t> &result)
+{
+    uploads_.push_back({PartitionOf(table_name, key),
+                        {&table_name, &key, &version_entry, extension,
+                         &result}});
+}
+
+void CoalescingHandler::MultiUploadVersion(
+    const std::vector<request::UploadVersionRequest> &requests)
+{
+    for (const request::UploadVersionRequest &request : requests)
+    {
+        uploads_.push_back(
+            {PartitionOf(*request.table_name_, *request.key_), request});
+    }
+}
+
+void CoalescingHandler::UpdateMaxCommitTsAndReread(
+    const TableName &table_name,
+    const Key &key,
+    int64_t version_key,
+    int64_t max_commit_ts,
+    EntryExtension *extension,
+    request::HandlerResult<VersionEntry> &result)
+{
+    rereads_.push_back({PartitionOf(table_name, key),
+                        {&table_name, &key, version_key, max_commit_ts,
+                         extension, &result}});
+}
+
+void CoalescingHandler::MultiUpdateMaxCommitTsAndReread(
+    const std::vector<request::UpdateMaxCommitTsRequest> &requests)
+{
+    for (const request::UpdateMaxCommitTsRequest &request : requests)
+    {
+        rereads_.push_back(
+            {PartitionOf(*request.table_name_, *request.key_), request});
+    }
+}
+
+void CoalescingHandler::CommitVersion(const TableName &table_name,
+                                      const Key &key,
+                                      int64_t version_key,
+                                      int64_t expect_txn_id,
+                                      int64_t target_begin_ts,
+                                      int64_t target_end_ts,
+                                      int64_t target_tx_id,
+                                      EntryExtension *extension,
+                                      request::HandlerResult<Void> &result,
+                                      Record *record,
+                                      bool commited)
+{
+    commits_.push_back({PartitionOf(table_name, key),
+                        {&table_name, &key, version_key, expect_txn_id,
+                         target_begin_ts, target_end_ts, target_tx_id,
+                         extension, &result, record, commited}});
+}
+
+void CoalescingHandler::MultiCommitVersion(
+    const std::vector<request::CommitVersionRequest> &requests)
+{
+    for (const request::CommitVersionRequest &request : requests)
+    {
+        commits_.push_back(
+            {PartitionOf(*request.table_name_, *request.key_), request});
+    }
+}
+
+void CoalescingHandler::GetTxn(int64_t txn_id,
+                               request::HandlerResult<TxnEntry> &result)
+{
+    TxnLookup *lookup = FindOrAddLookup(get_txn_lookups_, txn_id, false);
+    lookup->callers_.push_back(&result);
+}
+
+void CoalescingHandler::UpdateCommitLowerBound(
+    int64_t txn_id,
+    int64_t commit_ts_lower_bound,
+    request::HandlerResult<TxnEntry> &result)
+{
+    // pushing the highest bound answers every caller: a bound only holds
+    // back a commit timestamp that is not chosen yet, which is all the
+    // callers check for.
+    TxnLookup *lookup = FindOrAddLookup(lower_bound_lookups_, txn_id, true);
+    lookup->lower_bound_ =
+        std::max(lookup->lower_bound_, commit_ts_lower_bound);
+    lookup->callers_.push_back(&result);
+}
+
+CoalescingHandler::TxnLookup *CoalescingHandler::FindOrAddLookup(
+    std::unordered_map<int64_t, TxnLookup *> &lookups,
+    int64_t txn_id,
+    bool push_lower_bound)
+{
+    auto it = lookups.find(txn_id);
+    if (it != lookups.end())
+    {
+        return it->second;
+    }
+
+    std::unique_ptr<TxnLookup> lookup;
+    if (free_lookups_.empty())
+    {
+        lookup = std::make_unique<TxnLookup>();
+        lookup->result_.SetListener(lookup.get());
+    }
+    else
+    {
+        lookup = std::move(free_lookups_.back());
+        free_lookups_.pop_back();
+    }
+    lookup->txn_id_ = txn_id;
+    lookup->push_lower_bound_ = push_lower_bound;
+    lookup->lower_bound_ = TxnEntry::kDefaultCommitTs;
+    lookup->callers_.clear();
+    lookup->result_.Reset();
+    lookup->done_.store(false, std::memory_order_relaxed);
+
+    TxnLookup *raw = lookup.get();
+    pending_lookups_.push_back(std::move(lookup));
+    lookups.emplace(txn_id, raw);
+    return raw;
+}
+
+void CoalescingHandler::TxnLookup::OnCompletion()
+{
+    for (request::HandlerResult<TxnEntry> *caller : callers_)
+    {
+        caller->result_.tx_id = result_.result_.tx_id;
+        caller->result_.status = result_.result_.status;
+        caller->result_.commit_ts = result_.result_.commit_ts;
+        caller->result_.commit_lower_bound =
+            result_.result_.commit_lower_bound;
+        if (result_.IsError())
+        {
+            caller->SetError();
+        }
+        else
+        {
+            caller->SetFinished();
+        }
+    }
+    done_.store(true, std::memory_order_release);
+}
+
+void CoalescingHandler::ReclaimLookups()
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < sent_lookups_.size(); i++)
+    {
+        if (sent_lookups_[i]->done_.load(std::memory_order_acquire))
+        {
+            free_lookups_.push_back(std::move(sent_lookups_[i]));
+        }
+        else
+        {
+            sent_lookups_[kept++] = std::move(sent_lookups_[i]);
+        }
+    }
+    sent_lookups_.resize(kept);
+}
+
+template <typename T>
+void CoalescingHandler::SortByPartition(std::vector<Pending<T>> &pending,
+                                        std::vector<T> &requests)
+{
+    std::stable_sort(pending.begin(),
+                     pending.end(),
+                     [](const Pending<T> &a, const Pending<T> &b)
+                     { return a.partition_ < b.partition_; });
+    requests.clear();
+    for (const Pending<T> &p : pending)
+    {
+        requests.push_back(p.request_);
+    }
+    pending.clear();
+}
+
+void CoalescingHandler::SendBatch()
+{
+    ReclaimLookups();
+
+    if (!uploads_.empty())
+    {
+        SortByPartition(uploads_, upload_batch_);
+        handler_->MultiUploadVersion(upload_batch_);
+    }
+    if (!rereads_.empty())
+    {
+        SortByPartition(rereads_, reread_batch_);
+        handler_->MultiUpdateMaxCommitTsAndReread(reread_batch_);
+    }
+    if (!commits_.empty())
+    {
+        SortByPartition(commits_, commit_batch_);
+        handler_->MultiCommitVersion(commit_batch_);
+    }
+
+    for (std::unique_ptr<TxnLookup> &lookup : pending_lookups_)
+    {
+        if (lookup->push_lower_bound_)
+        {
+            handler_->UpdateCommitLowerBound(
+                lookup->txn_id_, lookup->lower_bound_, lookup->result_);
+        }
+        else
+        {
+            handler_->GetTxn(lookup->txn_id_, lookup->result_);
+        }
+        sent_lookups_.push_back(std::move(lookup));
+    }
+    pending_lookups_.clear();
+    get_txn_lookups_.clear();
+    lower_bound_lookups_.clear();
+
+    handler_->SendBatch();
+}
+
+void CoalescingHandler::DeleteVersion(const TableName &table_name,
+                                      const Key &key,
+                                      int64_t version_key,
+                                      EntryExtension *extension,
+                                      request::HandlerResult<Void> &result)
+{
+    handler_->DeleteVersion(table_name, key, version_key, extension, result);
+}
+
+void CoalescingHandler::CleanStaleVersion(const TableName &table_name,
+                                          int64_t end_time,
+                                          request::HandlerResult<Void> &result)
+{
+    handler_->CleanStaleVersion(table_name, end_time, result);
+}
+
+void CoalescingHandler::CleanStaleTxn(int64_t end_time,
+                                      request::HandlerResult<Void> &result)
+{
+    handler_->CleanStaleTxn(end_time, result);
+}
+
+void CoalescingHandler::InitVersionList(const TableName &table_name,
+                                        const Key &key,
+                                        VersionEntry &version_entry,
+                                        request::HandlerResult<bool> &result)
+{
+    handler_->InitVersionList(table_name, key, version_entry, result);
+}
+
+void CoalescingHandler::ReleaseReadCounter(
+    const TableName &table_name,
+    const Key &key,
+    int64_t version_key,
+    EntryExtension *extension,
+    request::HandlerResult<Void> &result)
+{
+    handler_->ReleaseReadCounter(
+        table_name, key, version_key, extension, result);
+}
+
+void CoalescingHandler::GetVersionList(
+    const TableName &table_name,
+    const Key &key,
+    const int64_t time,
+    request::HandlerResult<std::vector<VersionEntry>> &result,
+    void *callback_deserializer)
+{
+    handler_->GetVersionList(
+        table_name, key, time, result, callback_deserializer);
+}
+
+void CoalescingHandler::NewTxn(TxnEntry &entry,
+                               int64_t local_time,
+                               int64_t max_txn_execution_time_ms,
+                               request::HandlerResult<Void> &result)
+{
+    handler_->NewTxn(entry, local_time, max_txn_execution_time_ms, result);
+}
+
+void CoalescingHandler::SetCommitTimestamp(
+    int64_t txn_id,
+    int64_t commit_ts,
+    EntryExtension *extension,
+    request::HandlerResult<int64_t> &result)
+{
+    handler_->SetCommitTimestamp(txn_id, commit_ts, extension, result);
+}
+
+void CoalescingHandler::UpdateTxnStatus(int64_t txn_id,
+                                        TxnStatus status,
+                                        EntryExtension *extension,
+                                        request::HandlerResult<Void> &result)
+{
+    handler_->UpdateTxnStatus(txn_id, status, extension, result);
+}
+
+void CoalescingHandler::GetAllCurrentKeys(
+    int64_t txn_id,
+    const TableName &table_name,
+    request::HandlerResult<std::vector<StringKey>> &result)
+{
+    handler_->GetAllCurrentKeys(txn_id, table_name, result);
+}
+
+txcheckpoint::KeyIterator::Pointer CoalescingHandler::GetAllCurrentKeys(
+    const TableName &table_name, void *key_deserializer)
+{
+    return handler_->GetAllCurrentKeys(table_name, key_deserializer);
+}
+
+txcheckpoint::KeyIterator::Pointer CoalescingHandler::GetPartitionKeys(
+    const TableName &table_name, int partition, void *key_deserializer)
+{
+    return handler_->GetPartitionKeys(table_name, partition, key_deserializer);
+}
+
+void CoalescingHandler::InsertRangeEntry(int64_t txn_id,
+                                         const TableName &table_name,
+                                         const std::string &range,
+                                         int64_t commit_ts,
+                                         request::HandlerResult<Void> &result)
+{
+    handler_->InsertRangeEntry(txn_id, table_name, range, commit_ts, result);
+}
+
+void CoalescingHandler::UpdateRangeEntry(int64_t txn_id,
+                                         int64_t commit_ts,
+                                         request::HandlerResult<Void> &result)
+{
+    handler_->UpdateRangeEntry(txn_id, commit_ts, result);
+}
+
+txcheckpoint::KeyIterator::Pointer CoalescingHandler::GetCheckpointKeys(
+    TableName &table_name,
+    int partition,
+    int64_t ts,
+    void *key_deserializer)
+{
+    return handler_->GetCheckpointKeys(
+        table_name, partition, ts, key_deserializer);
+}
+
+void CoalescingHandler::CheckRemoveActEntry(
+    TableName &table_name,
+    int partition,
+    Key *key,
+    int64_t ts,
+    request::HandlerResult<Void> &result)
+{
+    handler_->CheckRemoveActEntry(table_name, partition, key, ts, result);
+}
+
+void CoalescingHandler::KickoutVersion(const TableName &table_name,
+                                       const Key *key,
+                                       int64_t expire_ts,
+                                       int64_t checkpoint_ts,
+                                       int64_t lru_ts,
+                                       request::HandlerResult<bool> &result)
+{
+    handler_->KickoutVersion(
+        table_name, key, expire_ts, checkpoint_ts, lru_ts, result);
+}
+
+void CoalescingHandler::GetVisibleVersionPromise(
+    const TableName &table_name,
+    const Key &key,
+    request::HandlerResult<VersionEntry> &result,
+    void *callback_deserializer)
+{
+    handler_->GetVisibleVersionPromise(
+        table_name, key, result, callback_deserializer);
+}
+
+void CoalescingHandler::GetSnapshotVersion(
+    const TableName &table_name,
+    const Key &key,
+    int64_t read_ts,
+    request::HandlerResult<VersionEntry> &result,
+    void *callback_deserializer)
+{
+    handler_->GetSnapshotVersion(
+        table_name, key, read_ts, result, callback_deserializer);
+}
+
+size_t CoalescingHandler::PartitionOf(const TableName &table_name,
+                                      const Key &key)
+{
+    return handler_->PartitionOf(table_name, key);
+}
+}  // namespace txservice::transaction
@@ -0,0 +1,11 @@
+#include "transaction/txn-id-generator-factory.h"
+
+namespace txservice::transaction
+{
+std::unique_ptr<TxnIDGenerator> EpochTxnIDGeneratorFactory::GetTxnIDGenerator(
+    int executor_id)
+{
+    return std::make_unique<EpochTxnIDGenerator>(
+        node_id_, executor_id, &epochs_);
+}
+}  // namespace txservice::transaction
@@ -0,0 +1,43 @@
+#include <stdexcept>
+#include "transaction/txn-id-generator.h"
+
+namespace txservice::transaction
+{
+EpochTxnIDGenerator::EpochTxnIDGenerator(int node_id,
+                                         int executor_id,
+                                         BootEpoch *epochs,
+                                         int64_t sequence)
+    : node_id_(node_id),
+      executor_id_(executor_id),
+      epochs_(epochs),
+      sequence_(sequence)
+{
+    if (node_id < 0 || node_id >= (1 << kNodeBits) || executor_id < 0 ||
+        executor_id >= (1 << kExecutorBits) || sequence < 0 ||
+        sequence >= (int64_t(1) << kSequenceBits))
+    {
+        throw std::runtime_error(
+            "node id, executor id or sequence out of range of the txn id");
+    }
+    SetEpoch(epochs_->Current());
+}
+
+int64_t EpochTxnIDGenerator::GenerateID()
+{
+    if (sequence_ == (int64_t(1) << kSequenceBits) - 1)
+    {
+        // ids of the old epoch may still be around, go on under a new one.
+        SetEpoch(epochs_->Next());
+        sequence_ = 0;
+    }
+    sequence_++;
+    return prefix_ | sequence_;
+}
+
+void EpochTxnIDGenerator::SetEpoch(int64_t epoch)
+{
+    prefix_ = (node_id_ << (kExecutorBits + kEpochBits + kSequenceBits)) |
+              (executor_id_ << (kEpochBits + kSequenceBits)) |
+              (epoch << kSequenceBits);
+}
+}  // namespace txservice::transaction
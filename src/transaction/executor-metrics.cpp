@@ -0,0 +1,97 @@
+#include "transaction/executor-metrics.h"
+#include "utility/cycle-clock.h"
+
+namespace txservice::transaction
+{
+const char *PhaseName(OperationPhase phase)
+{
+    switch (phase)
+    {
+    case OperationPhase::kReadOutside:
+        return "ReadOutside";
+    case OperationPhase::kReadSnapshot:
+        return "ReadSnapshot";
+    case OperationPhase::kUpload:
+        return "Upload";
+    case OperationPhase::kUploadVersionEntry:
+        return "UploadVersionEntry";
+    case OperationPhase::kSetCommitTs:
+        return "SetCommitTs";
+    case OperationPhase::kValidate:
+        return "Validate";
+    case OperationPhase::kUpdateReadEntryMaxCommitTs:
+        return "UpdateReadEntryMaxCommitTs";
+    case OperationPhase::kPushConflictTxnCommitTsLowerBound:
+        return "PushConflictTxnCommitTsLowerBound";
+    case OperationPhase::kWriteToLog:
+        return "WriteToLog";
+    case OperationPhase::kUpdateTxnStatusToCommit:
+        return "UpdateTxnStatusToCommit";
+    case OperationPhase::kPostProcessingAfterCommit:
+        return "PostProcessingAfterCommit";
+    case OperationPhase::kPostProcessingCommitEntryAfterCommit:
+        return "PostProcessingCommitEntryAfterCommit";
+    case OperationPhase::kPostProcessingAfterAbort:
+        return "PostProcessingAfterAbort";
+    case OperationPhase::kPostProcessingDeleteEntryAfterAbort:
+        return "PostProcessingDeleteEntryAfterAbort";
+    case OperationPhase::kReleaseReadCounter:
+        return "ReleaseReadCounter";
+    case OperationPhase::kReleaseReadCounterForEachEntry:
+        return "ReleaseReadCounterForEachEntry";
+    case OperationPhase::kUpdateTxnStatusToAbort:
+        return "UpdateTxnStatusToAbort";
+    case OperationPhase::kInsert:
+        return "Insert";
+    case OperationPhase::kUpdate:
+        return "Update";
+    case OperationPhase::kUpsert:
+        return "Upsert";
+    case OperationPhase::kDelete:
+        return "Delete";
+    case OperationPhase::kInitTxn:
+        return "InitTxn";
+    case OperationPhase::kReadDataStore:
+        return "ReadDataStore";
+    case OperationPhase::kInsertRange:
+        return "InsertRange";
+    case OperationPhase::kStep:
+        return "Step";
+    case OperationPhase::kCommit:
+        return "Commit";
+    default:
+        return "Unknown";
+    }
+}
+
+void MetricsSnapshot::Merge(const MetricsSnapshot &that)
+{
+    commit_count_ += that.commit_count_;
+    abort_count_ += that.abort_count_;
+    for (size_t i = 0; i < kAbortReasonCount; i++)
+    {
+        abort_reasons_[i] += that.abort_reasons_[i];
+    }
+    nanos_per_tick_ = that.nanos_per_tick_;
+    for (size_t i = 0; i < kOperationPhaseCount; i++)
+    {
+        phases_[i].Merge(that.phases_[i]);
+    }
+}
+
+void ExecutorMetrics::Snapshot(MetricsSnapshot &snapshot) const
+{
+    snapshot.commit_count_ = commit_count_.load(std::memory_order_relaxed);
+    snapshot.abort_count_ = abort_count_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kAbortReasonCount; i++)
+    {
+        snapshot.abort_reasons_[i] =
+            abort_reasons_[i].load(std::memory_order_relaxed);
+    }
+    snapshot.nanos_per_tick_ = CycleClock::NanosPerTick();
+    for (size_t i = 0; i < kOperationPhaseCount; i++)
+    {
+        phases_[i].TakeSnapshot(snapshot.phases_[i]);
+    }
+}
+}  // namespace txservice::transaction
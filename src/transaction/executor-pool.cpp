@@ -0,0 +1,137 @@
+#include "transaction/executor-pool.h"
+#include <algorithm>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace txservice::transaction
+{
+ExecutorPool::ExecutorPool(uint32_t executor_count,
+                           uint32_t concurrent_txn_count,
+                           TxnIDGeneratorFactory *id_factory,
+                           VersionDb *version_db,
+                           txlog::TxLog *tx_log,
+                           size_t capacity,
+                           bool pin_to_core,
+                           uint32_t first_core)
+    : stopping_(false), pin_to_core_(pin_to_core), first_core_(first_core)
+{
+    for (uint32_t i = 0; i < executor_count; i++)
+    {
+        executors_.push_back(std::make_unique<RuntimeTransactionExecutor>(
+            i,
+            concurrent_txn_count,
+            id_factory->GetTxnIDGenerator(i),
+            version_db->MakeHandler(),
+            std::make_unique<LocalTimeProvider>(),
+            tx_log,
+            capacity));
+    }
+}
+
+ExecutorPool::~ExecutorPool()
+{
+    ShutDown();
+}
+
+void ExecutorPool::Start()
+{
+    stopping_.store(false, std::memory_order_release);
+    uint32_t core_count = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < executors_.size(); i++)
+    {
+        threads_.emplace_back(&ExecutorPool::RunExecutor, this, i);
+        if (pin_to_core_)
+        {
+            PinToCore(threads_.back(), (first_core_ + i) % core_count);
+        }
+    }
+}
+
+void ExecutorPool::ShutDown()
+{
+    stopping_.store(true, std::memory_order_release);
+    for (auto &thread : threads_)
+    {
+        thread.join();
+    }
+    threads_.clear();
+    for (auto &executor : executors_)
+    {
+        executor->ShutDown();
+    }
+}
+
+void ExecutorPool::AddRequest(OperationRequest *operation_request)
+{
+    size_t idx = ExecutorIndex(operation_request->session_id_);
+    executors_[idx]->AddRequest(operation_request);
+}
+
+void ExecutorPool::AddRequest(
+    std::shared_ptr<OperationRequest> operation_request)
+{
+    size_t idx = ExecutorIndex(operation_request->session_id_);
+    executors_[idx]->AddRequest(std::move(operation_request));
+}
+
+MetricsSnapshot ExecutorPool::Metrics() const
+{
+    MetricsSnapshot snapshot;
+    for (auto &executor : executors_)
+    {
+        snapshot.Merge(executor->Metrics());
+    }
+    return snapshot;
+}
+
+size_t ExecutorPool::ExecutorIndex(int64_t session_id) const
+{
+    // mix the bits first, session ids handed out with a stride equal to the
+    // executor count would otherwise all land in the same queue.
+    uint64_t hash = static_cast<uint64_t>(session_id) * 0x9E3779B97F4A7C15ull;
+    return (hash >> 32) % executors_.size();
+}
+
+void ExecutorPool::RunExecutor(size_t idx)
+{
+    RuntimeTransactionExecutor *executor = executors_[idx].get();
+    size_t idle_passes = 0;
+    while (true)
+    {
+        if (executor->RunOnce())
+        {
+            idle_passes = 0;
+            continue;
+        }
+        if (stopping_.load(std::memory_order_acquire))
+        {
+            if (executor->IsFinished())
+            {
+                break;
+            }
+            // sessions left open by their clients would never finish.
+            executor->AbortOpenSessions();
+        }
+        if (++idle_passes < Constant::EXECUTOR_IDLE_PASSES)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        // the timeout bounds the wait of transactions on handler results.
+        executor->Park(Constant::EXECUTOR_PARK_TIMEOUT_US);
+    }
+}
+
+void ExecutorPool::PinToCore(std::thread &thread, uint32_t core)
+{
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core, &cpu_set);
+    pthread_setaffinity_np(
+        thread.native_handle(), sizeof(cpu_set_t), &cpu_set);
+#endif
+}
+}  // namespace txservice::transaction
@@ -0,0 +1,80 @@
+#include "transaction/hot-key-tracker.h"
+#include <algorithm>
+
+namespace txservice::transaction
+{
+HotKeyTracker::HotKeyTracker(size_t top_k, size_t sketch_width)
+    : sketch_(sketch_width), top_k_(top_k), records_(0)
+{
+    top_.reserve(top_k_);
+}
+
+void HotKeyTracker::Record(const LocalState::SetKey &key, AbortReason reason)
+{
+    size_t hash = key.Hash();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (++records_ % Constant::HOT_KEY_DECAY_INTERVAL == 0)
+    {
+        Decay();
+    }
+    uint32_t count = sketch_.Add(hash);
+
+    Entry *min_entry = nullptr;
+    for (Entry &entry : top_)
+    {
+        if (entry.hash_ == hash && entry.table_name_ == *key.table_name &&
+            *entry.key_ == *key.key)
+        {
+            entry.count_ = count;
+            entry.last_reason_ = reason;
+            return;
+        }
+        if (min_entry == nullptr || entry.count_ < min_entry->count_)
+        {
+            min_entry = &entry;
+        }
+    }
+
+    if (top_.size() < top_k_)
+    {
+        top_.push_back({hash, count, *key.table_name, key.key->Copy(), reason});
+    }
+    else if (min_entry != nullptr && count > min_entry->count_)
+    {
+        min_entry->hash_ = hash;
+        min_entry->count_ = count;
+        min_entry->table_name_ = *key.table_name;
+        min_entry->key_ = key.key->Copy();
+        min_entry->last_reason_ = reason;
+    }
+}
+
+void HotKeyTracker::TopKeys(std::vector<HotKey> &keys) const
+{
+    keys.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Entry &entry : top_)
+        {
+            keys.push_back({entry.table_name_,
+                            entry.key_->Copy(),
+                            entry.count_,
+                            entry.last_reason_});
+        }
+    }
+    std::sort(keys.begin(),
+              keys.end(),
+              [](const HotKey &lhs, const HotKey &rhs) {
+                  return lhs.aborts_ > rhs.aborts_;
+              });
+}
+
+void HotKeyTracker::Decay()
+{
+    sketch_.Decay();
+    for (Entry &entry : top_)
+    {
+        entry.count_ >>= 1;
+    }
+}
+}  // namespace txservice::transaction
@@ -56,14 +56,12 @@ size_t LocalState::GetWriteSetSize() const
     return key_write_set_.GetSize();
 }
 
-const std::vector<LocalState::KeyReadSetEntry::Pointer>
-    *LocalState::GetAllReadSet() const
+LocalState::ReadSet *LocalState::GetAllReadSet()
 {
     return key_read_set_.GetAllReadSet();
 }
 
-const std::vector<LocalState::KeyWriteSetEntry::Pointer>
-    *LocalState::GetAllWriteSet() const
+LocalState::WriteSet *LocalState::GetAllWriteSet()
 {
     return key_write_set_.GetAllWriteSet();
 }
@@ -0,0 +1,89 @@
+#include "transaction/operation-request-pool.h"
+#include <typeinfo>
+
+namespace txservice::transaction
+{
+OperationRequestPool::OperationRequestPool(size_t capacity)
+    : free_requests_(capacity)
+{
+}
+
+OperationRequestPool::~OperationRequestPool()
+{
+    OperationRequest *request;
+    while (free_requests_.read(request))
+    {
+        delete request;
+    }
+}
+
+OperationRequest *OperationRequestPool::Acquire(int64_t session_id,
+                                                OperationType operation_type)
+{
+    OperationRequest *request;
+    if (free_requests_.read(request))
+    {
+        request->Reset(session_id, operation_type);
+    }
+    else
+    {
+        request = new OperationRequest(session_id, operation_type);
+        request->pool_ = this;
+    }
+    request->AddRef();
+    return request;
+}
+
+OperationRequest *OperationRequestPool::Acquire(int64_t session_id,
+                                                const TableName &table_name,
+                                                Key::Pointer key,
+                                                Record::Pointer record,
+                                                OperationType operation_type,
+                                                void *callback_deserializer)
+{
+    OperationRequest *request = Acquire(session_id, operation_type);
+    request->table_name_ = table_name;
+    request->key_ = std::move(key);
+    request->record_ = std::move(record);
+    request->callback_deserializer_ = callback_deserializer;
+    return request;
+}
+
+OperationRequest *OperationRequestPool::Acquire(int64_t session_id,
+                                                const TableName &table_name,
+                                                const Key &key,
+                                                const Record *record,
+                                                OperationType operation_type,
+                                                void *callback_deserializer)
+{
+    OperationRequest *request = Acquire(session_id, operation_type);
+    request->table_name_ = table_name;
+    // CopyFrom of keys and records assumes the same type.
+    if (request->key_ == nullptr || typeid(*request->key_) != typeid(key) ||
+        !request->key_->CopyFrom(key))
+    {
+        request->key_ = key.Copy();
+    }
+    if (record == nullptr)
+    {
+        request->record_ = nullptr;
+    }
+    else if (request->record_ == nullptr ||
+             typeid(*request->record_) != typeid(*record) ||
+             !request->record_->CopyFrom(*record))
+    {
+        request->record_ = record->Copy();
+    }
+    request->callback_deserializer_ = callback_deserializer;
+    return request;
+}
+
+void OperationRequestPool::Recycle(OperationRequest *request)
+{
+    // the key and record stay for the next Acquire to copy into.
+    if (!free_requests_.writeIfNotFull(request))
+    {
+        delete request;
+    }
+}
+}  // namespace txservice::transaction
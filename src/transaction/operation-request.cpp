@@ -1,9 +1,52 @@
 #include "transaction/operation-request.h"
-#include <condition_variable>
-#include <mutex>
+#include "transaction/operation-request-pool.h"
 
 namespace txservice::transaction
 {
+void OperationRequest::Release()
+{
+    if (ref_count_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+    if (pool_ != nullptr)
+    {
+        pool_->Recycle(this);
+    }
+    else
+    {
+        // moved out first, dropping it may destroy this request.
+        std::shared_ptr<OperationRequest> owner = std::move(owner_);
+    }
+}
+
+OperationRequest *OperationRequest::Adopt(
+    std::shared_ptr<OperationRequest> request)
+{
+    OperationRequest *raw = request.get();
+    if (raw->ref_count_.fetch_add(1, std::memory_order_relaxed) == 0)
+    {
+        raw->owner_ = std::move(request);
+    }
+    // the reference taken above belongs to the caller.
+    return raw;
+}
+
+void OperationRequest::Reset(int64_t session_id, OperationType operation_type)
+{
+    type_ = 0;
+    session_id_ = session_id;
+    operation_type_ = operation_type;
+    result_ = nullptr;
+    dependent_request_.clear();
+    request_processor_ = nullptr;
+    callback_deserializer_ = nullptr;
+    need_to_read_outside_ = false;
+    completion_.Reset();
+    continuation_ = nullptr;
+    continuation_state_.store(0, std::memory_order_relaxed);
+}
+
 void OperationRequest::SetResult(Result *result)
 {
     result_ = result;
@@ -35,20 +78,28 @@ void OperationRequest::PullResult()
 
 void OperationRequest::Notify()
 {
-    std::unique_lock<std::mutex> lk(mutex_);
-    is_finished_ = true;
-    lk.unlock();
-    cv_.notify_one();
+    completion_.Set();
+    if (continuation_state_.fetch_or(kNotified, std::memory_order_acq_rel) ==
+        kContinuationSet)
+    {
+        // last use of the request here, the continuation may release it.
+        continuation_(this);
+    }
 }
 
 void OperationRequest::Wait()
 {
-    // try fast path first
-    if (is_finished_)
-        return;
-    // slow path, requires cv
-    std::unique_lock<std::mutex> lk(mutex_);
-    cv_.wait(lk, [this] { return is_finished_; });
+    completion_.Wait();
+}
+
+void OperationRequest::OnComplete(Continuation fn)
+{
+    continuation_ = std::move(fn);
+    if (continuation_state_.fetch_or(kContinuationSet,
+                                     std::memory_order_acq_rel) == kNotified)
+    {
+        continuation_(this);
+    }
 }
 
 }  // namespace txservice::transaction
\ No newline at end of file
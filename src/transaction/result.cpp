@@ -15,6 +15,7 @@ void Result::Reset(Record *record, OperationRequest *operation_request)
     is_null_ = false;
     is_error_ = false;
     status_ = TxnStatus::kOngoing;
+    abort_reason_ = AbortReason::kNone;
     operation_request_ = operation_request;
     operation_request_->SetResult(this);
 }
@@ -25,6 +26,7 @@ void Result::Reset(OperationRequest *operation_request)
     is_null_ = false;
     is_error_ = false;
     status_ = TxnStatus::kOngoing;
+    abort_reason_ = AbortReason::kNone;
     operation_request_ = operation_request;
     record_ = nullptr;
     operation_request_->SetResult(this);
@@ -1,4 +1,5 @@
 #include "transaction/runtime-transaction-executor.h"
+#include "utility/cycle-clock.h"
 
 namespace txservice::transaction
 {
@@ -17,7 +18,8 @@ RuntimeTransactionExecutor::RuntimeTransactionExecutor(
       tx_log),
       concurrent_txn_count_(concurrent_txn_count),
       request_queue_pool_(capacity),
-      current_request_(nullptr)
+      current_request_(nullptr),
+      ready_queue_(concurrent_txn_count)
 {
     active_txn_number_ = 0;
     for (int i = 0; i < concurrent_txn_count; i++)
@@ -34,18 +36,64 @@ RuntimeTransactionExecutor::RuntimeTransactionExecutor(
 
         active_txn_.push_back(transaction_task);
     }
+
+    free_task_head_ = TransactionTask::kNoTask;
+    for (int32_t i = static_cast<int32_t>(concurrent_txn_count_) - 1; i >= 0;
+         i--)
+    {
+        active_txn_[i].GetTransactionExecution()->SetMetrics(&metrics_);
+        active_txn_[i].GetTransactionExecution()->SetReadyQueue(&ready_queue_,
+                                                                i);
+        active_txn_[i].SetNextFree(free_task_head_);
+        free_task_head_ = i;
+    }
+    ready_tasks_.reserve(concurrent_txn_count_);
+    session_task_.reserve(concurrent_txn_count_);
 }
 
-void RuntimeTransactionExecutor::AddRequest(
-    std::shared_ptr<OperationRequest> operation_request)
+void RuntimeTransactionExecutor::Submit(OperationRequest *operation_request)
 {
     request_queue_pool_.write(operation_request);
 }
 
+int32_t RuntimeTransactionExecutor::FindSessionTask(int64_t session_id)
+{
+    auto it = session_task_.find(session_id);
+    return it == session_task_.end() ? TransactionTask::kNoTask : it->second;
+}
+
+int32_t RuntimeTransactionExecutor::AcquireTask(int64_t session_id)
+{
+    int32_t index = free_task_head_;
+    if (index == TransactionTask::kNoTask)
+    {
+        return index;
+    }
+    free_task_head_ = active_txn_[index].GetNextFree();
+    active_txn_[index].Reset(session_id);
+    session_task_[session_id] = index;
+    active_txn_number_++;
+    return index;
+}
+
+void RuntimeTransactionExecutor::ReleaseTask(int32_t index)
+{
+    TransactionTask &task = active_txn_[index];
+    auto it = session_task_.find(task.GetSessionID());
+    if (it != session_task_.end() && it->second == index)
+    {
+        session_task_.erase(it);
+    }
+    task.Release();
+    task.SetNextFree(free_task_head_);
+    free_task_head_ = index;
+    active_txn_number_--;
+}
+
 // transaction operation request must be next to each other.
-void RuntimeTransactionExecutor::LaunchRequests()
+bool RuntimeTransactionExecutor::LaunchRequests()
 {
-    size_t last_index = -1;
+    bool launched = false;
     while (true)
     {
         if (current_request_ == nullptr)
@@ -54,70 +102,50 @@ void RuntimeTransactionExecutor::LaunchRequests()
             {
                 break;
             }
+            launched = true;
         }
         int64_t session_id = current_request_->session_id_;
-        int concurrent_txn_index;
+        int32_t task_index;
 
         if (current_request_->operation_type_ == OperationType::Begin)
         {
-            // find an empty slot if we are beginning a new transaction
+            // wait for a free slot if we are beginning a new transaction
             if (active_txn_number_ >= concurrent_txn_count_)
             {
-                return;
+                return launched;
             }
-            for (concurrent_txn_index = 0;
-                 concurrent_txn_index < concurrent_txn_count_;
-                 concurrent_txn_index++)
-            {
-                if (!active_txn_[concurrent_txn_index].InUse())
-                {
-                    active_txn_[concurrent_txn_index].Reset(session_id);
-                    active_txn_number_++;
-                    last_index = concurrent_txn_index;
-                    break;
-                }
-            }
-            if (concurrent_txn_index == concurrent_txn_count_)
+            task_index = AcquireTask(session_id);
+            if (task_index == TransactionTask::kNoTask)
             {
                 throw "no empty txn task";
             }
         }
         else
         {
-            for (concurrent_txn_index = 0;
-                 concurrent_txn_index < concurrent_txn_count_;
-                 concurrent_txn_index++)
-            {
-                if (active_txn_[concurrent_txn_index].GetSessionID() ==
-                    session_id)
-                {
-                    last_index = concurrent_txn_index;
-                    break;
-                }
-            }
-            if (concurrent_txn_index == concurrent_txn_count_)
+            task_index = FindSessionTask(session_id);
+            if (task_index == TransactionTask::kNoTask)
             {
                 throw "no session task";
             }
         }
 
-        if (last_index == -1)
-        {
-            throw "not found suitable transaction";
-        }
-
-        active_txn_[last_index].GetTransactionRequest()->PushRequest(
+        active_txn_[task_index].GetTransactionRequest()->PushRequest(
             current_request_);
+        active_txn_[task_index].GetTransactionExecution()->MarkReady();
         current_request_ = nullptr;
     }
+    return launched;
 }
 
 void RuntimeTransactionExecutor::Advance()
 {
     bool has_finished_txn = false;
 
-    for (int i = 0; i < concurrent_txn_count_; i++)
+    ready_tasks_.clear();
+    ready_queue_.Drain(ready_tasks_);
+    for (int32_t i : ready_tasks_)
     {
+        active_txn_[i].GetTransactionExecution()->ClearReady();
         if (active_txn_[i].InUse())
         {
             TransactionExecution *execution =
@@ -197,40 +225,106 @@ void RuntimeTransactionExecutor::Advance()
             {
                 if (execution->GetTxnStatus() == txservice::TxnStatus::kAborted)
                 {
-                    abort_count_++;
+                    metrics_.RecordAbort(execution->GetAbortReason());
                 }
                 if (execution->GetTxnStatus() == txservice::TxnStatus::kCommitted)
                 {
-                    commit_count_++;
+                    metrics_.RecordCommit(CycleClock::Now() -
+                                          execution->GetCommitBeginTicks());
                 }
 
-                active_txn_[i].Release();
-                active_txn_number_--;
+                ReleaseTask(i);
                 has_finished_txn = true;
             }
+            else
+            {
+                active_txn_[i].Reschedule();
+            }
         }
     }
 }
 
-void RuntimeTransactionExecutor::Statistics(int &commit, int &abort)
+void RuntimeTransactionExecutor::SetCommitProtocol(
+    const StepOperation::Steps *protocol)
 {
-    commit = commit_count_;
-    abort = abort_count_;
+    for (TransactionTask &task : active_txn_)
+    {
+        task.GetTransactionExecution()->SetCommitProtocol(protocol);
+    }
+}
+
+void RuntimeTransactionExecutor::SetChangeFeed(txckpt::ChangeFeed *change_feed)
+{
+    for (TransactionTask &task : active_txn_)
+    {
+        task.GetTransactionExecution()->SetChangeFeed(change_feed);
+    }
 }
 
 void RuntimeTransactionExecutor::Run()
 {
-    while (!request_queue_pool_.isEmpty() || active_txn_number_ > 0)
+    while (!IsFinished())
     {
-        LaunchRequests();
-        Advance();
-        handler_->SendBatch();
+        RunOnce();
+    }
+}
+
+bool RuntimeTransactionExecutor::RunOnce()
+{
+    bool launched = LaunchRequests();
+    Advance();
+    handler_->SendBatch();
+    if (tx_log_ != nullptr)
+    {
+        tx_log_->Poll(executor_id_);
+    }
+    return launched || !ready_tasks_.empty();
+}
+
+void RuntimeTransactionExecutor::Park(int64_t timeout_us)
+{
+    if (current_request_ == nullptr)
+    {
+        request_queue_pool_.tryReadUntil(
+            std::chrono::steady_clock::now() +
+                std::chrono::microseconds(timeout_us),
+            current_request_);
+    }
+}
+
+void RuntimeTransactionExecutor::AbortOpenSessions()
+{
+    if (abort_requests_.empty())
+    {
+        for (uint32_t i = 0; i < concurrent_txn_count_; i++)
+        {
+            abort_requests_.push_back(
+                std::make_unique<OperationRequest>(0, OperationType::Abort));
+        }
+    }
+    for (size_t i = 0; i < active_txn_.size(); i++)
+    {
+        TransactionTask &task = active_txn_[i];
+        TransactionExecution *execution = task.GetTransactionExecution();
+        if (!task.InUse() || execution->IsFinished() ||
+            execution->IsWaiting() || !execution->IsIdle() ||
+            task.GetTransactionRequest()->HasRequest())
+        {
+            continue;
+        }
+        // owned here, the task only holds a reference until it is released.
+        OperationRequest *abort = abort_requests_[i].get();
+        abort->Reset(task.GetSessionID(), OperationType::Abort);
+        abort->AddRef();
+        task.GetTransactionRequest()->PushRequest(abort);
+        execution->MarkReady();
     }
 }
 
 bool RuntimeTransactionExecutor::IsFinished()
 {
-    return request_queue_pool_.isEmpty() && active_txn_number_ == 0;
+    return current_request_ == nullptr && request_queue_pool_.isEmpty() &&
+           active_txn_number_ == 0;
 }
 
 void RuntimeTransactionExecutor::ShutDown() 
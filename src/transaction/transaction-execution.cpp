@@ -1,4 +1,6 @@
 #include "transaction/transaction-execution.h"
+#include "txlog/log-replay.h"
+#include "utility/cycle-clock.h"
 
 namespace txservice::transaction
 {
@@ -38,6 +40,7 @@ TransactionExecution::TransactionExecution(const TransactionExecution &that)
       txn_id_generator_(that.txn_id_generator_),
       time_provider_(that.time_provider_),
       tx_log_(that.tx_log_),
+      commit_protocol_(that.commit_protocol_),
       handler_(that.handler_),
       txn_id_(that.txn_id_),
       txn_entry_(that.txn_entry_),
@@ -79,7 +82,9 @@ void TransactionExecution::Init()
     }
     update_txn_status_to_abort_operation.Init(this);
     read_outside_operation.Init(this);
+    read_snapshot_operation.Init(this);
     init_txn_operation.Init(this);
+    step_operation.Init(this);
     insert_operation.Init(this);
     upsert_operation.Init(this);
     update_operation.Init(this);
@@ -98,8 +103,12 @@ void TransactionExecution::Reset()
     current_request_ = nullptr;
     is_transaction_finished_ = false;
     status_ = TxnStatus::kOngoing;
+    read_only_ = false;
+    txn_entry_created_ = false;
+    abort_reason_ = AbortReason::kNone;
     commit_timestamp_ = -1;
     max_commit_timestamp_of_writers_ = -1;
+    pending_completions_.store(0, std::memory_order_relaxed);
     ResetTxnIDAndTime();
 }
 
@@ -116,11 +125,91 @@ void TransactionExecution::ResetTime()
     txn_entry_.Reset(commit_timestamp_local_);
 }
 
+void TransactionExecution::SetMetrics(ExecutorMetrics *metrics)
+{
+    metrics_ = metrics;
+}
+
+void TransactionExecution::SetChangeFeed(txckpt::ChangeFeed *change_feed)
+{
+    change_feed_ = change_feed;
+}
+
+void TransactionExecution::RecordChange(const LocalState::SetKey &set_key)
+{
+    if (change_feed_ != nullptr)
+    {
+        change_feed_->Append(
+            *set_key.table_name,
+            handler_->PartitionOf(*set_key.table_name, *set_key.key),
+            *set_key.key,
+            GetCommitTs());
+    }
+}
+
+void TransactionExecution::RecordPhase(OperationPhase phase,
+                                       uint64_t begin_ticks)
+{
+    if (metrics_ != nullptr)
+    {
+        metrics_->RecordPhase(phase, CycleClock::Now() - begin_ticks);
+    }
+}
+
+void TransactionExecution::SetReadyQueue(ReadyQueue *ready_queue,
+                                         int32_t task_index)
+{
+    ready_queue_ = ready_queue;
+    task_index_ = task_index;
+}
+
+void TransactionExecution::ExpectCompletion()
+{
+    pending_completions_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TransactionExecution::OnCompletion()
+{
+    pending_completions_.fetch_sub(1, std::memory_order_release);
+    MarkReady();
+}
+
+void TransactionExecution::MarkReady()
+{
+    if (ready_queue_ != nullptr &&
+        !is_ready_.exchange(true, std::memory_order_acq_rel))
+    {
+        ready_queue_->Push(task_index_);
+    }
+}
+
+void TransactionExecution::ClearReady()
+{
+    is_ready_.store(false, std::memory_order_release);
+}
+
+bool TransactionExecution::IsWaiting() const
+{
+    return pending_completions_.load(std::memory_order_acquire) > 0;
+}
+
+bool TransactionExecution::IsIdle() const
+{
+    return operation_vector_.empty();
+}
+
 void TransactionExecution::Call(TransactionOperation *operation,
                                 bool run_current_operation)
 {
     operation_vector_.push_back(operation);
-    operation->Call();
+    if (run_current_operation)
+    {
+        operation->Call();
+    }
+    else
+    {
+        operation->Defer();
+    }
 }
 
 bool TransactionExecution::MoveForward()
@@ -181,15 +270,15 @@ void TransactionExecution::CleanStack()
 
 void TransactionExecution::WriteLog(
     int64_t commit_timestamp,
-    const std::vector<transaction::LocalState::KeyWriteSetEntry::Pointer>
-        *write_entry,
+    const LocalState::WriteSet *write_entry,
     const size_t size,
     const TxnEntry *txn_entry,
     std::atomic<bool> *is_finish,
-    bool sync)
+    bool sync,
+    request::CompletionListener *listener)
 {
     tx_log_->AsyncAppend(
-        executor_id_, write_entry, size, txn_entry, is_finish, sync);
+        executor_id_, write_entry, size, txn_entry, is_finish, sync, listener);
 }
 
 WriteSetEntry *TransactionExecution::FindInWriteSet(const TableName &table_name,
@@ -225,8 +314,7 @@ void TransactionExecution::InsertWriteSet(TableName *table_name,
                                        need_post_processing);
 }
 
-const std::vector<LocalState::KeyReadSetEntry::Pointer>
-    *TransactionExecution::GetAllReadSet() const
+LocalState::ReadSet *TransactionExecution::GetAllReadSet()
 {
     return local_state_.GetAllReadSet();
 }
@@ -235,8 +323,7 @@ size_t TransactionExecution::GetReadSetSize() const
     return local_state_.GetReadSetSize();
 }
 
-const std::vector<LocalState::KeyWriteSetEntry::Pointer>
-    *TransactionExecution::GetAllWriteSet() const
+LocalState::WriteSet *TransactionExecution::GetAllWriteSet()
 {
     return local_state_.GetAllWriteSet();
 }
@@ -282,10 +369,87 @@ int64_t TransactionExecution::GetCommitTs()
     return commit_timestamp_;
 }
 
-void TransactionExecution::Recover(std::string msg)
+void TransactionExecution::Recover(TxnStatus outcome, std::string msg)
+{
+    // a handler request of the commit or abort post processing failed, after
+    // the outcome was decided. Redo the outcome, waiting on the handler, and
+    // let the caller carry on as if the request had succeeded.
+    bool redone =
+        outcome == TxnStatus::kCommitted ? RedoCommit() : RedoAbort();
+    if (!redone)
+    {
+        throw std::runtime_error(
+            msg + " unhandle exception and need to be recovered manually");
+    }
+}
+
+void TransactionExecution::RecoverDeleteVersion(const LocalState::SetKey &key,
+                                                const WriteSetEntry &entry,
+                                                std::string msg)
+{
+    if (!txlog::LogReplay::RedoDeleteVersion(*handler_,
+                                             *key.table_name,
+                                             *key.key,
+                                             entry.version_,
+                                             entry.extension_.get()))
+    {
+        throw std::runtime_error(
+            msg + " unhandle exception and need to be recovered manually");
+    }
+}
+
+void TransactionExecution::RecoverReleaseReadCounter(
+    const LocalState::SetKey &key, const ReadSetEntry &entry, std::string msg)
 {
-    throw std::runtime_error(
-        "unhandle exception and need to be recovered manually");
+    if (!txlog::LogReplay::RedoReleaseReadCounter(*handler_,
+                                                  *key.table_name,
+                                                  *key.key,
+                                                  entry.version_,
+                                                  entry.extension_.get()))
+    {
+        throw std::runtime_error(
+            msg + " unhandle exception and need to be recovered manually");
+    }
+}
+
+bool TransactionExecution::RedoCommit()
+{
+    if (!txlog::LogReplay::RedoTxnStatus(
+            *handler_, txn_id_, TxnStatus::kCommitted))
+    {
+        return false;
+    }
+    LocalState::WriteSet *write_set = GetAllWriteSet();
+    for (size_t i = 0; i < GetWriteSetSize(); i++)
+    {
+        const LocalState::KeyWriteSetEntry &entry = (*write_set)[i];
+        if (entry.entry_.need_post_processing_ &&
+            !txlog::LogReplay::RedoVersion(*handler_,
+                                           *entry.key_.table_name,
+                                           *entry.key_.key,
+                                           entry.entry_.version_,
+                                           entry.entry_.is_deleted_,
+                                           entry.entry_.record_,
+                                           txn_id_,
+                                           GetCommitTs()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TransactionExecution::RedoAbort()
+{
+    // only the status: dirty versions and read counters whose release
+    // failed are retried by RecoverDeleteVersion and
+    // RecoverReleaseReadCounter.
+    if (!txn_entry_created_)
+    {
+        return true;
+    }
+    return txlog::LogReplay::RedoTxnStatus(
+        *handler_, txn_id_, TxnStatus::kAborted);
 }
 
 Result *TransactionExecution::Insert(TableName *table_name,
@@ -293,7 +457,12 @@ Result *TransactionExecution::Insert(TableName *table_name,
                                      Record *record,
                                      void *callback_deserializer)
 {
-    result_.Reset(record, GetCurrentRequest());
+    if (read_only_)
+    {
+        return RejectWrite();
+    }
+    // record is the payload to write, not a buffer for the read behind it.
+    result_.Reset(GetCurrentRequest());
     insert_operation.Reset(table_name, key, record, callback_deserializer);
     Call(&(insert_operation));
     return &result_;
@@ -304,7 +473,12 @@ Result *TransactionExecution::Upsert(TableName *table_name,
                                      Record *record,
                                      void *callback_deserializer)
 {
-    result_.Reset(record, GetCurrentRequest());
+    if (read_only_)
+    {
+        return RejectWrite();
+    }
+    // record is the payload to write, not a buffer for the read behind it.
+    result_.Reset(GetCurrentRequest());
     upsert_operation.Reset(table_name, key, record, callback_deserializer);
     Call(&(upsert_operation));
     return &result_;
@@ -314,6 +488,10 @@ Result *TransactionExecution::Update(TableName *table_name,
                                      Key *key,
                                      Record *record)
 {
+    if (read_only_)
+    {
+        return RejectWrite();
+    }
     result_.Reset(GetCurrentRequest());
     update_operation.Reset(table_name, key, record);
     Call(&(update_operation));
@@ -322,6 +500,10 @@ Result *TransactionExecution::Update(TableName *table_name,
 
 Result *TransactionExecution::Delete(TableName *table_name, Key *key)
 {
+    if (read_only_)
+    {
+        return RejectWrite();
+    }
     result_.Reset(GetCurrentRequest());
     delete_operation.Reset(table_name, key);
     Call(&(delete_operation));
@@ -334,6 +516,17 @@ Result *TransactionExecution::Read(TableName *table_name,
                                    void *callback_deserializer)
 {
     result_.Reset(record, GetCurrentRequest());
+    if (read_only_)
+    {
+        read_snapshot_operation.Reset(
+            table_name, key, record, callback_deserializer);
+        Call(&(read_snapshot_operation));
+        return &result_;
+    }
+    if (ReadLocally(*table_name, *key))
+    {
+        return &result_;
+    }
     read_outside_operation.Reset(
         table_name, key, record, false, callback_deserializer);
     Call(&(read_outside_operation));
@@ -347,6 +540,17 @@ Result *TransactionExecution::Read(TableName *table_name,
                                    void *callback_deserializer)
 {
     result_.Reset(record, GetCurrentRequest());
+    if (read_only_)
+    {
+        read_snapshot_operation.Reset(
+            table_name, key, record, callback_deserializer);
+        Call(&(read_snapshot_operation));
+        return &result_;
+    }
+    if (ReadLocally(*table_name, *key))
+    {
+        return &result_;
+    }
     read_outside_operation.Reset(table_name,
                                  key,
                                  record,
@@ -378,12 +582,29 @@ Result *TransactionExecution::ReadDataStore(TableName *table_name,
 
 Result *TransactionExecution::Commit()
 {
+    commit_begin_ticks_ = CycleClock::Now();
     result_.Reset(GetCurrentRequest());
+    if (read_only_)
+    {
+        return FinishReadOnly(TxnStatus::kCommitted);
+    }
+    if (commit_protocol_ != nullptr)
+    {
+        step_operation.Reset(commit_protocol_);
+        Call(&(step_operation));
+        return &result_;
+    }
     upload_operation.Reset();
     Call(&(upload_operation));
     return &result_;
 }
 
+void TransactionExecution::SetCommitProtocol(
+    const StepOperation::Steps *protocol)
+{
+    commit_protocol_ = protocol;
+}
+
 void TransactionExecution::Abort(std::string message)
 {
     Abort();
@@ -391,8 +612,25 @@ void TransactionExecution::Abort(std::string message)
 
 Result *TransactionExecution::Abort()
 {
+    // no-op when an operation found the reason already.
+    SetAbortReason(AbortReason::kClientAbort);
     CleanStack();
     result_.Reset(GetCurrentRequest());
+    if (read_only_)
+    {
+        result_.SetAbortReason(GetAbortReason());
+        return FinishReadOnly(TxnStatus::kAborted);
+    }
+    if (!txn_entry_created_)
+    {
+        // no entry to mark aborted, only uploaded versions and read
+        // counters to release.
+        result_.SetAbortReason(GetAbortReason());
+        result_.SetStatus(TxnStatus::kAborted);
+        post_processing_after_abort_operation.Reset();
+        Call(&(post_processing_after_abort_operation));
+        return &result_;
+    }
     update_txn_status_to_abort_operation.Reset();
     Call(&(update_txn_status_to_abort_operation));
     return &result_;
@@ -402,11 +640,79 @@ Result *TransactionExecution::Begin(int type)
 {
     result_.Reset(GetCurrentRequest());
     type_ = type;
+    read_only_ = type == ReadOnlyTxn;
+    if (read_only_)
+    {
+        // no txn entry, it writes no version for others to resolve.
+        read_ts_ = time_provider_->GetTime();
+        result_.SetFinished();
+        return &result_;
+    }
+    if (commit_protocol_ == nullptr)
+    {
+        // the id is fixed by Reset, the entry goes out with the first
+        // upload batch at commit.
+        txn_id_ = txn_entry_.tx_id;
+        result_.SetFinished();
+        return &result_;
+    }
+    // a protocol may resolve the entry at any step, create it up front.
     init_txn_operation.Reset();
     Call(&(init_txn_operation));
     return &result_;
 }
 
+bool TransactionExecution::ReadLocally(const TableName &table_name,
+                                       const Key &key)
+{
+    if (WriteSetEntry *write_entry = FindInWriteSet(table_name, key))
+    {
+        if (write_entry->is_deleted_)
+        {
+            result_.SetDeleted();
+        }
+        else
+        {
+            result_.SetRecord(write_entry->record_);
+        }
+        return true;
+    }
+    ReadSetEntry *read_entry = FindInReadSet(table_name, key);
+    if (read_entry == nullptr)
+    {
+        return false;
+    }
+    if (read_entry->is_deleted_ && read_entry->version_ <= 0)
+    {
+        result_.SetNull();
+    }
+    else if (read_entry->is_deleted_)
+    {
+        result_.SetDeleted();
+    }
+    else
+    {
+        // copied out of the entry's own payload into the request's buffer.
+        result_.SetRecord(read_entry->record_);
+    }
+    return true;
+}
+
+Result *TransactionExecution::RejectWrite()
+{
+    result_.Reset(GetCurrentRequest());
+    result_.SetError();
+    return &result_;
+}
+
+Result *TransactionExecution::FinishReadOnly(TxnStatus status)
+{
+    SetTxnStatus(status);
+    SetFinished();
+    result_.SetStatus(status);
+    return &result_;
+}
+
 bool TransactionExecution::IsFinished()
 {
     return is_transaction_finished_;
@@ -430,6 +736,19 @@ void TransactionExecution::PrepareAbort()
 {
     SetTxnStatus(TxnStatus::kAborting);
 }
+void TransactionExecution::SetAbortReason(AbortReason reason,
+                                          const LocalState::SetKey *key)
+{
+    if (abort_reason_ == AbortReason::kNone)
+    {
+        abort_reason_ = reason;
+    }
+    if (key != nullptr && metrics_ != nullptr)
+    {
+        metrics_->RecordAbortKey(*key, reason);
+    }
+}
+
 void TransactionExecution::WaitForAbort()
 {
     SetTxnStatus(TxnStatus::kWaitForAborting);
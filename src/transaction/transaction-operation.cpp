@@ -1,5 +1,6 @@
 #include "transaction/transaction-operation.h"
 #include "transaction/transaction-execution.h"
+#include "utility/cycle-clock.h"
 
 namespace txservice::transaction
 {
@@ -12,18 +13,28 @@ void TransactionOperation::Invoke(TransactionOperation *operation,
 void TransactionOperation::Call()
 {
     move_to_next_ = false;
+    begin_ticks_ = CycleClock::Now();
     CallImpl();
 }
 
+void TransactionOperation::Defer()
+{
+    move_to_next_ = false;
+    begin_ticks_ = CycleClock::Now();
+}
+
 TransactionOperation* TransactionOperation::Next()
 {
+    execution_->RecordPhase(GetPhase(), begin_ticks_);
     move_to_next_ = true;
     has_next_ = true;
     return NextImpl();
 }
 
-TransactionOperation* TransactionOperation::PrepareAbort()
+TransactionOperation* TransactionOperation::PrepareAbort(
+    AbortReason reason, const LocalState::SetKey *key)
 {
+    execution_->SetAbortReason(reason, key);
     execution_->WaitForAbort();
     has_next_ = false;
     return nullptr;
@@ -36,11 +47,23 @@ TransactionOperation* TransactionOperation::Abort()
     return nullptr;
 }
 
+TransactionOperation* TransactionOperation::Abort(AbortReason reason)
+{
+    execution_->SetAbortReason(reason);
+    return Abort();
+}
+
 void TransactionOperation::Init(TransactionExecution *execution)
 {
     execution_ = execution;
 }
 
+request::CompletionListener *TransactionOperation::ExpectCompletion()
+{
+    execution_->ExpectCompletion();
+    return execution_;
+}
+
 void ReadOutsideOperation::Reset(TableName *table_name,
                                  Key *key,
                                  Record *record,
@@ -62,13 +85,14 @@ void ReadOutsideOperation::Reset(TableName *table_name,
     result_of_get_version_list_.Reset();
     result_of_get_version_list_.result_[0].Reset(
         execution_->GetCurrentRequest()->result_->record_,
-        std::move(key_read_set_entry_->entry_->extension_));
+        std::move(key_read_set_entry_->entry_.extension_));
     result_of_get_version_list_.result_[1].Reset(
         execution_->GetCurrentRequest()->result_->record_);
 }
 
 void ReadOutsideOperation::CallImpl()
 {
+    Watch(result_of_get_version_list_);
     execution_->handler_->GetVersionList(
         *table_name_,
         *key_,
@@ -91,7 +115,7 @@ TransactionOperation* ReadOutsideOperation::NextImpl()
 {
     if (result_of_get_version_list_.IsError()) 
     {
-        key_read_set_entry_->entry_->extension_ = std::move(result_of_get_version_list_.result_[0].extension_);
+        key_read_set_entry_->entry_.extension_ = std::move(result_of_get_version_list_.result_[0].extension_);
         execution_->ReleaseReadSet();
         execution_->GetCurrentRequest()->result_->SetError();
     }
@@ -156,16 +180,19 @@ void ReadOutsideOperation::InternalRead()
         {
             bool is_deleted = visible_version->is_deleted_;
             Record *record = visible_version->read_record_;
-            key_read_set_entry_->entry_->Reset(
+            key_read_set_entry_->entry_.Reset(
                 visible_version->version_,
                 visible_version->tx_id_,
                 visible_version->begin_ts_,
                 visible_version->end_ts_,
                 visible_version->is_deleted_,
-                visible_version->read_record_,
+                nullptr,
                 std::move(visible_version->extension_));
+            // repeated reads of the key are answered from this copy.
+            key_read_set_entry_->entry_.KeepRecord(is_deleted ? nullptr
+                                                              : record);
 
-            key_read_set_entry_->key_->Reset(table_name_, key_);
+            key_read_set_entry_->key_.Reset(table_name_, key_);
 
             if (is_deleted)
             {
@@ -178,23 +205,82 @@ void ReadOutsideOperation::InternalRead()
         }
         else
         {
-            key_read_set_entry_->entry_->Reset(0,
-                                               VersionEntry::kEmptyTxId,
-                                               0,
-                                               VersionEntry::kMaxTimeStamp,
-                                               true,
-                                               nullptr,
-                                               std::move(result_of_get_version_list_.result_[0].extension_));
-            key_read_set_entry_->key_->Reset(table_name_, key_);
+            key_read_set_entry_->entry_.Reset(0,
+                                              VersionEntry::kEmptyTxId,
+                                              0,
+                                              VersionEntry::kMaxTimeStamp,
+                                              true,
+                                              nullptr,
+                                              std::move(result_of_get_version_list_.result_[0].extension_));
+            key_read_set_entry_->entry_.KeepRecord(nullptr);
+            key_read_set_entry_->key_.Reset(table_name_, key_);
 
             this->execution_->GetCurrentRequest()->result_->SetNull();
         }
 }
 
+void ReadSnapshotOperation::Reset(TableName *table_name,
+                                  Key *key,
+                                  Record *record,
+                                  void *callback_deserializer)
+{
+    table_name_ = table_name;
+    key_ = key;
+    callback_deserializer_ = callback_deserializer;
+    result_of_get_visible_version_.Reset();
+    result_of_get_visible_version_.result_.Reset(record);
+}
+
+void ReadSnapshotOperation::CallImpl()
+{
+    Watch(result_of_get_visible_version_);
+    execution_->handler_->GetSnapshotVersion(*table_name_,
+                                             *key_,
+                                             execution_->ReadTs(),
+                                             result_of_get_visible_version_,
+                                             callback_deserializer_);
+}
+
+bool ReadSnapshotOperation::IsFinished() const
+{
+    return result_of_get_visible_version_.IsFinished();
+}
+
+bool ReadSnapshotOperation::IsCascadeFinished() const
+{
+    return IsFinished() && move_to_next_;
+}
+
+TransactionOperation* ReadSnapshotOperation::NextImpl()
+{
+    Result *result = execution_->GetCurrentRequest()->result_;
+    VersionEntry &visible = result_of_get_visible_version_.result_;
+    if (result_of_get_visible_version_.IsError())
+    {
+        result->SetError();
+    }
+    else if (visible.is_deleted_ && visible.version_ <= 0)
+    {
+        result->SetNull();
+    }
+    else if (visible.is_deleted_)
+    {
+        result->SetDeleted();
+    }
+    else
+    {
+        result->SetRecord(visible.read_record_);
+    }
+    has_next_ = false;
+    return nullptr;
+}
+
 void Upload::Reset()
 {
     key_write_set_ = execution_->GetAllWriteSet();
     size_ = execution_->GetWriteSetSize();
+    new_txn_ = !execution_->IsTxnEntryCreated();
+    result_of_new_txn_.Reset();
 }
 
 void Upload::CallImpl()
@@ -209,17 +295,41 @@ void Upload::CallImpl()
         }        
     }
     
+    if (new_txn_)
+    {
+        // ahead of the versions naming the txn, in the same batch.
+        Watch(result_of_new_txn_);
+        execution_->handler_->NewTxn(execution_->txn_entry_,
+                                     execution_->commit_timestamp_local_,
+                                     execution_->kMaxTxnExecutionTimeMS,
+                                     result_of_new_txn_);
+    }
+    upload_requests_.clear();
     for (int i = 0; i < size_; i++)
     {
-        execution_->upload_version_entry_operation_vector[i]->Reset(
-            (*key_write_set_)[i]->entry_.get(),
-            (*key_write_set_)[i]->key_.get());
-        Invoke(execution_->upload_version_entry_operation_vector[i].get());
+        UploadVersionEntry *upload_version_entry =
+            execution_->upload_version_entry_operation_vector[i].get();
+        upload_version_entry->Reset(&(*key_write_set_)[i].entry_,
+                                    &(*key_write_set_)[i].key_);
+        Invoke(upload_version_entry, false);
+        upload_requests_.push_back(upload_version_entry->MakeRequest());
+    }
+    if (!upload_requests_.empty())
+    {
+        execution_->handler_->MultiUploadVersion(upload_requests_);
     }
 }
 
 TransactionOperation* Upload::NextImpl()
 {
+    if (new_txn_)
+    {
+        if (result_of_new_txn_.IsError())
+        {
+            return Abort(AbortReason::kNewTxnFailed);
+        }
+        execution_->SetTxnEntryCreated();
+    }
     if (execution_->IsWaitForAborting())
     {
         return Abort();
@@ -233,6 +343,10 @@ TransactionOperation* Upload::NextImpl()
 
 bool Upload::IsFinished() const
 {
+    if (new_txn_ && !result_of_new_txn_.IsFinished())
+    {
+        return false;
+    }
     for (int i = 0; i < size_; i++)
     {
         if (!execution_->upload_version_entry_operation_vector[i]->IsCascadeFinished())
@@ -265,8 +379,19 @@ void UploadVersionEntry::Reset(WriteSetEntry *write_set_entry,
                          std::move(write_set_entry_->extension_));
 }
 
+request::UploadVersionRequest UploadVersionEntry::MakeRequest()
+{
+    Watch(result_of_upload_version_);
+    return {set_key_->table_name,
+            set_key_->key,
+            &version_entry_,
+            write_set_entry_->read_entry_->extension_.get(),
+            &result_of_upload_version_};
+}
+
 void UploadVersionEntry::CallImpl()
 {
+    Watch(result_of_upload_version_);
     execution_->handler_->UploadVersion(
         *(set_key_->table_name),
         *(set_key_->key),
@@ -290,7 +415,7 @@ TransactionOperation* UploadVersionEntry::NextImpl()
     write_set_entry_->extension_ = std::move(version_entry_.extension_);
     if (result_of_upload_version_.IsError())
     {
-        return PrepareAbort();
+        return PrepareAbort(AbortReason::kWriteWriteConflict, set_key_);
     }
     else
     {
@@ -315,15 +440,14 @@ void SetCommitTsOperation::CallImpl()
         std::max(execution_->GetMaxCommitTsOfWriters() + 1,
                  execution_->commit_timestamp_local_);
 
-    const std::vector<LocalState::KeyReadSetEntry::Pointer> *key_read_set_ =
-        execution_->GetAllReadSet();
+    LocalState::ReadSet *key_read_set_ = execution_->GetAllReadSet();
     size_t size_ = execution_->GetReadSetSize();
 
     for (size_t i = 0; i < size_; i++)
     {
-        ReadSetEntry *entry = (*key_read_set_)[i]->entry_.get();
-        if (execution_->FindInWriteSet(*((*key_read_set_)[i]->key_->table_name),
-                                       *((*key_read_set_)[i]->key_->key)) !=
+        ReadSetEntry *entry = &(*key_read_set_)[i].entry_;
+        if (execution_->FindInWriteSet(*((*key_read_set_)[i].key_.table_name),
+                                       *((*key_read_set_)[i].key_.key)) !=
                                        nullptr)
         {
             proposed_commit_ts =
@@ -336,6 +460,7 @@ void SetCommitTsOperation::CallImpl()
     }
     execution_->SetCommitTs(proposed_commit_ts);
 
+    Watch(result_of_set_commit_ts_);
     execution_->handler_->SetCommitTimestamp(
         execution_->txn_id_,
         proposed_commit_ts,
@@ -357,14 +482,14 @@ TransactionOperation* SetCommitTsOperation::NextImpl()
 {
     if (result_of_set_commit_ts_.IsError())
     {
-        return Abort();
+        return Abort(AbortReason::kSetCommitTsFailed);
     }
     else
     {
         int64_t commit_time = result_of_set_commit_ts_.result_;
         if (commit_time < 0)
         {
-            return Abort();
+            return Abort(AbortReason::kSetCommitTsFailed);
         }
         else
         {
@@ -382,7 +507,7 @@ void Validate::Reset()
     read_index_.clear();
     for (int i = 0; i < size; i++)
     {
-         if (!((*key_read_set_)[i]->entry_->is_updated_))
+         if (!((*key_read_set_)[i].entry_.is_updated_))
         {
             read_index_.push_back(i);
         }
@@ -411,14 +536,25 @@ void Validate::CallImpl()
         }        
     }
     
+    update_requests_.clear();
     for (int i = 0; i < read_index_.size(); i++)
     {
         size_t index = read_index_[i];
-        execution_->update_read_entry_max_commit_ts_operation_vector[i]->Reset(
-            (*key_read_set_)[index]->entry_.get(),
-            (*key_read_set_)[index]->key_.get(),
+        UpdateReadEntryMaxCommitTs *update_read_entry_max_commit_ts =
+            execution_->update_read_entry_max_commit_ts_operation_vector[i]
+                .get();
+        update_read_entry_max_commit_ts->Reset(
+            &(*key_read_set_)[index].entry_,
+            &(*key_read_set_)[index].key_,
             i);
-        Invoke(execution_->update_read_entry_max_commit_ts_operation_vector[i].get());
+        Invoke(update_read_entry_max_commit_ts, false);
+        update_requests_.push_back(
+            update_read_entry_max_commit_ts->MakeRequest());
+    }
+    if (!update_requests_.empty())
+    {
+        execution_->handler_->MultiUpdateMaxCommitTsAndReread(
+            update_requests_);
     }
 }
 
@@ -462,8 +598,20 @@ void UpdateReadEntryMaxCommitTs::Reset(ReadSetEntry *read_set_entry,
     index_ = index;
 }
 
+request::UpdateMaxCommitTsRequest UpdateReadEntryMaxCommitTs::MakeRequest()
+{
+    Watch(result_of_update_max_commit_ts_);
+    return {set_key_->table_name,
+            set_key_->key,
+            read_set_entry_->version_,
+            execution_->GetCommitTs(),
+            read_set_entry_->extension_.get(),
+            &result_of_update_max_commit_ts_};
+}
+
 void UpdateReadEntryMaxCommitTs::CallImpl()
 {
+    Watch(result_of_update_max_commit_ts_);
     execution_->handler_->UpdateMaxCommitTsAndReread(
         *(set_key_->table_name),
         *(set_key_->key),
@@ -497,7 +645,7 @@ TransactionOperation* UpdateReadEntryMaxCommitTs::NextImpl()
 {
     if (result_of_update_max_commit_ts_.IsError())
     {
-        return PrepareAbort();
+        return PrepareAbort(AbortReason::kReadValidationFailed, set_key_);
     }
     else
     {
@@ -505,18 +653,19 @@ TransactionOperation* UpdateReadEntryMaxCommitTs::NextImpl()
         VersionEntry &version_entry = result_of_update_max_commit_ts_.result_;
         if (version_entry.version_ == VersionEntry::kDefaultVersion)
         {
-            return PrepareAbort();
+            return PrepareAbort(AbortReason::kReadValidationFailed, set_key_);
         }
         assert(version_entry.max_commit_ts_ >= execution_->GetCommitTs());
         // Check whether the read version entry is locked by another txn.
         if (execution_->GetCommitTs() > version_entry.end_ts_)
         {
-            return PrepareAbort();
+            return PrepareAbort(AbortReason::kReadVersionOverwritten,
+                                set_key_);
         }
         else if (version_entry.tx_id_ != VersionEntry::kEmptyTxId)
         {
             execution_->push_conflict_txn_commit_ts_lower_bound_operation_vector[index_]
-                ->Reset(version_entry.tx_id_);
+                ->Reset(version_entry.tx_id_, set_key_);
             return execution_->push_conflict_txn_commit_ts_lower_bound_operation_vector[index_].get();
         }
     }
@@ -524,14 +673,17 @@ TransactionOperation* UpdateReadEntryMaxCommitTs::NextImpl()
     return nullptr;
 }
 
-void PushConflictTxnCommitTsLowerBound::Reset(int64_t txn_id)
+void PushConflictTxnCommitTsLowerBound::Reset(
+    int64_t txn_id, const LocalState::SetKey *set_key)
 {
     result_of_update_commit_lower_bound_.Reset();
     txn_id_ = txn_id;
+    set_key_ = set_key;
 }
 
 void PushConflictTxnCommitTsLowerBound::CallImpl()
 {
+    Watch(result_of_update_commit_lower_bound_);
     execution_->handler_->UpdateCommitLowerBound(
                 txn_id_,
                 execution_->GetCommitTs() + 1,
@@ -542,7 +694,7 @@ TransactionOperation* PushConflictTxnCommitTsLowerBound::NextImpl()
 {
     if (result_of_update_commit_lower_bound_.IsError())
     {
-        return PrepareAbort();
+        return PrepareAbort(AbortReason::kConflictTxnCommitted, set_key_);
     }
     else
     {
@@ -554,7 +706,8 @@ TransactionOperation* PushConflictTxnCommitTsLowerBound::NextImpl()
                 (txn_entry.commit_ts != TxnEntry::kDefaultCommitTs &&
                  txn_entry.commit_ts <= execution_->GetCommitTs()))
         {
-            return PrepareAbort();
+            return PrepareAbort(AbortReason::kConflictTxnCommitted,
+                                set_key_);
         }
     }
     has_next_ = false;
@@ -600,7 +753,8 @@ void WriteToLog::CallImpl()
             execution_->GetWriteSetSize(),
             &(execution_->txn_entry_),
             &(is_finished_),
-            true);
+            true,
+            ExpectCompletion());
     };
 }
 
@@ -627,6 +781,7 @@ void UpdateTxnStatusToCommit::Reset()
 
 void UpdateTxnStatusToCommit::CallImpl()
 {
+    Watch(result_of_update_txn_status_to_commit_);
     execution_->handler_->UpdateTxnStatus(
         execution_->txn_id_,
         TxnStatus::kCommitted,
@@ -648,17 +803,13 @@ TransactionOperation* UpdateTxnStatusToCommit::NextImpl()
 {
     if (result_of_update_txn_status_to_commit_.IsError())
     {
-        execution_->Recover("Update Txn Commit Fail!");
-        has_next_ = false;
-        return nullptr;
-    }
-    else
-    {
-        execution_->GetCurrentRequest()->result_->SetStatus(
-            TxnStatus::kCommitted);
-        execution_->post_processing_after_commit_operation.Reset();
-        return (&(execution_->post_processing_after_commit_operation));
+        execution_->Recover(TxnStatus::kCommitted,
+                            "Update Txn Commit Fail!");
     }
+    execution_->GetCurrentRequest()->result_->SetStatus(
+        TxnStatus::kCommitted);
+    execution_->post_processing_after_commit_operation.Reset();
+    return (&(execution_->post_processing_after_commit_operation));
 }
 
 void PostProcessingAfterCommit::Reset()
@@ -669,7 +820,7 @@ void PostProcessingAfterCommit::Reset()
 
     for (int i = 0; i < size; i++)
     {
-        if ((*key_write_set_)[i]->entry_->need_post_processing_)
+        if ((*key_write_set_)[i].entry_.need_post_processing_)
         {
             post_process_index_.push_back(i);
         }
@@ -688,13 +839,22 @@ void PostProcessingAfterCommit::CallImpl()
         }        
     }
     
+    commit_requests_.clear();
     for (int i = 0; i < post_process_index_.size(); i++)
     {
         size_t index = post_process_index_[i];
-        execution_->post_processing_commit_entry_after_commit_operation_vector[i]->Reset(
-            (*key_write_set_)[index]->entry_.get(),
-            (*key_write_set_)[index]->key_.get());
-        Invoke(execution_->post_processing_commit_entry_after_commit_operation_vector[i].get());
+        PostProcessingCommitEntryAfterCommit *commit_entry =
+            execution_
+                ->post_processing_commit_entry_after_commit_operation_vector[i]
+                .get();
+        commit_entry->Reset(&(*key_write_set_)[index].entry_,
+                            &(*key_write_set_)[index].key_);
+        Invoke(commit_entry, false);
+        commit_requests_.push_back(commit_entry->MakeRequest());
+    }
+    if (!commit_requests_.empty())
+    {
+        execution_->handler_->MultiCommitVersion(commit_requests_);
     }
 }
 
@@ -732,8 +892,27 @@ void PostProcessingCommitEntryAfterCommit::Reset(
     result_of_commit_version_in_post_processing_commit_.ref_cnt = 2;
 }
 
+request::CommitVersionRequest
+PostProcessingCommitEntryAfterCommit::MakeRequest()
+{
+    // not watched, see CallImpl.
+    return {set_key_->table_name,
+            set_key_->key,
+            entry_->version_,
+            execution_->txn_id_,
+            execution_->GetCommitTs(),
+            VersionEntry::kMaxTimeStamp,
+            VersionEntry::kEmptyTxId,
+            entry_->extension_.get(),
+            &result_of_commit_version_in_post_processing_commit_,
+            entry_->record_,
+            false};
+}
+
 void PostProcessingCommitEntryAfterCommit::CallImpl()
 {
+    // not watched: completion is signalled through ref_cnt, which the
+    // executor keeps polling.
     execution_->handler_->CommitVersion(
         *(set_key_->table_name),
         *(set_key_->key),
@@ -761,12 +940,11 @@ TransactionOperation* PostProcessingCommitEntryAfterCommit::NextImpl()
 {
     if (result_of_commit_version_in_post_processing_commit_.IsError())
     {
-        execution_->Recover("Replace Entry Commit Fail!");
-    }
-    else
-    {
-        entry_->read_entry_->need_release_ = false;
+        execution_->Recover(TxnStatus::kCommitted,
+                            "Replace Entry Commit Fail!");
     }
+    entry_->read_entry_->need_release_ = false;
+    execution_->RecordChange(*set_key_);
     has_next_ = false;
     return nullptr;
 }
@@ -779,7 +957,7 @@ void PostProcessingAfterAbort::Reset()
 
     for (int i = 0; i < size; i++)
     {
-         if ((*key_write_set_)[i]->entry_->need_post_processing_)
+         if ((*key_write_set_)[i].entry_.need_post_processing_)
         {
             post_process_index_.push_back(i);
         }
@@ -804,8 +982,8 @@ void PostProcessingAfterAbort::CallImpl()
     {
         size_t index = post_process_index_[i];
         execution_->post_processing_delete_entry_after_abort_operation_vector[i]->Reset(
-            (*key_write_set_)[index]->entry_.get(),
-            (*key_write_set_)[index]->key_.get());
+            &(*key_write_set_)[index].entry_,
+            &(*key_write_set_)[index].key_);
         Invoke(execution_->post_processing_delete_entry_after_abort_operation_vector[i].get());
     }
 }
@@ -843,6 +1021,7 @@ void PostProcessingDeleteEntryAfterAbort::Reset(
 
 void PostProcessingDeleteEntryAfterAbort::CallImpl()
 {
+    Watch(result_of_delete_version_in_post_processing_abort_);
     execution_->handler_->DeleteVersion(
         *(set_key_->table_name),
         *(set_key_->key),
@@ -865,9 +1044,11 @@ TransactionOperation* PostProcessingDeleteEntryAfterAbort::NextImpl()
 {
     if (result_of_delete_version_in_post_processing_abort_.IsError())
     {
-        execution_->Recover("Delete Version Abort Fail!");
+        // a dirty version left behind would block its key for good.
+        execution_->RecoverDeleteVersion(
+            *set_key_, *entry_, "Delete Version Abort Fail!");
     }
-    else if (entry_->read_entry_!= nullptr && entry_->read_entry_->need_post_processing_)
+    if (entry_->read_entry_!= nullptr && entry_->read_entry_->need_post_processing_)
     {
         entry_->read_entry_->need_release_ = false;
     }
@@ -884,7 +1065,7 @@ void ReleaseReadCounter::Reset()
     release_index_.clear();
     for (int i = 0; i < size; i++)
     {
-         if ((*key_read_set_)[i]->entry_->need_release_)
+         if ((*key_read_set_)[i].entry_.need_release_)
         {
             release_index_.push_back(i);
         }
@@ -909,8 +1090,8 @@ void ReleaseReadCounter::CallImpl()
     {
         size_t index = release_index_[i];
         execution_->release_read_counter_for_each_entry_operation_vector[i]->Reset(
-            (*key_read_set_)[index]->entry_.get(),
-            (*key_read_set_)[index]->key_.get());
+            &(*key_read_set_)[index].entry_,
+            &(*key_read_set_)[index].key_);
         Invoke(execution_->release_read_counter_for_each_entry_operation_vector[i].get());
     }
 }
@@ -950,6 +1131,7 @@ void ReleaseReadCounterForEachEntry::Reset(ReadSetEntry *read_set_entry,
 
 void ReleaseReadCounterForEachEntry::CallImpl()
 {
+    Watch(result_of_release_read_counter_);
     execution_->handler_->ReleaseReadCounter(
         *(set_key_->table_name),
         *(set_key_->key),
@@ -972,16 +1154,13 @@ TransactionOperation* ReleaseReadCounterForEachEntry::NextImpl()
 {
     if (result_of_release_read_counter_.IsError())
     {
-        execution_->Recover("Release Counter Fail!");
-        has_next_ = false;
-        return nullptr;
-    }
-    else
-    {
-        read_set_entry_->need_release_ = false;
-        has_next_ = false;
-        return nullptr;
+        // the counter would keep the version from being kicked out.
+        execution_->RecoverReleaseReadCounter(
+            *set_key_, *read_set_entry_, "Release Counter Fail!");
     }
+    read_set_entry_->need_release_ = false;
+    has_next_ = false;
+    return nullptr;
 }
 
 void UpdateTxnStatusToAbort::Reset()
@@ -991,6 +1170,7 @@ void UpdateTxnStatusToAbort::Reset()
 
 void UpdateTxnStatusToAbort::CallImpl()
 {
+    Watch(result_of_update_txn_status_to_abort_);
     execution_->handler_->UpdateTxnStatus(
         execution_->txn_id_,
         TxnStatus::kAborted,
@@ -1012,17 +1192,15 @@ TransactionOperation* UpdateTxnStatusToAbort::NextImpl()
 {
     if (result_of_update_txn_status_to_abort_.IsError())
     {
-        execution_->Recover("Update Status Abort Fail!");
-        has_next_ = false;
-        return nullptr;
-    }
-    else
-    {
-        execution_->GetCurrentRequest()->result_->SetStatus(
-            TxnStatus::kAborted);
-        execution_->post_processing_after_abort_operation.Reset();
-        return &(execution_->post_processing_after_abort_operation);
+        execution_->Recover(TxnStatus::kAborted,
+                            "Update Status Abort Fail!");
     }
+    execution_->GetCurrentRequest()->result_->SetAbortReason(
+        execution_->GetAbortReason());
+    execution_->GetCurrentRequest()->result_->SetStatus(
+        TxnStatus::kAborted);
+    execution_->post_processing_after_abort_operation.Reset();
+    return &(execution_->post_processing_after_abort_operation);
 }
 
 void InsertOperation::Reset(TableName *table_name,
@@ -1038,6 +1216,11 @@ void InsertOperation::Reset(TableName *table_name,
 
 void InsertOperation::CallImpl()
 {
+    read_locally_ = execution_->FindInReadSet(*table_name_, *key_) != nullptr;
+    if (read_locally_)
+    {
+        return;
+    }
     execution_->read_outside_operation.Reset(table_name_,
                                              key_,
                                              record_,
@@ -1048,7 +1231,8 @@ void InsertOperation::CallImpl()
 
 bool InsertOperation::IsFinished() const
 {
-    return execution_->read_outside_operation.IsCascadeFinished();
+    return read_locally_ ||
+           execution_->read_outside_operation.IsCascadeFinished();
 }
 
 bool InsertOperation::IsCascadeFinished() const
@@ -1058,9 +1242,25 @@ bool InsertOperation::IsCascadeFinished() const
 
 TransactionOperation* InsertOperation::NextImpl()
 {
+    WriteSetEntry *write_entry =
+        execution_->FindInWriteSet(*table_name_, *key_);
     ReadSetEntry *read_entry = execution_->FindInReadSet(*table_name_, *key_);
 
-    if (read_entry != nullptr && read_entry->is_deleted_)
+    if (write_entry != nullptr)
+    {
+        // only a key this txn deleted can be inserted again.
+        if (write_entry->is_deleted_)
+        {
+            write_entry->is_deleted_ = false;
+            write_entry->record_ = record_;
+            execution_->GetCurrentRequest()->result_->SetFinished();
+        }
+        else
+        {
+            execution_->GetCurrentRequest()->result_->SetError();
+        }
+    }
+    else if (read_entry != nullptr && read_entry->is_deleted_)
     {
         int64_t version_key = read_entry->version_ + 1;
         read_entry->is_updated_ = true;
@@ -1090,6 +1290,11 @@ void UpsertOperation::Reset(TableName *table_name,
 
 void UpsertOperation::CallImpl()
 {
+    read_locally_ = execution_->FindInReadSet(*table_name_, *key_) != nullptr;
+    if (read_locally_)
+    {
+        return;
+    }
     execution_->read_outside_operation.Reset(table_name_,
                                              key_,
                                              record_,
@@ -1100,7 +1305,8 @@ void UpsertOperation::CallImpl()
 
 bool UpsertOperation::IsFinished() const
 {
-    return execution_->read_outside_operation.IsCascadeFinished();
+    return read_locally_ ||
+           execution_->read_outside_operation.IsCascadeFinished();
 }
 
 bool UpsertOperation::IsCascadeFinished() const
@@ -1110,8 +1316,16 @@ bool UpsertOperation::IsCascadeFinished() const
 
 TransactionOperation* UpsertOperation::NextImpl()
 {
+    WriteSetEntry *write_entry =
+        execution_->FindInWriteSet(*table_name_, *key_);
     ReadSetEntry *read_entry = execution_->FindInReadSet(*table_name_, *key_);
-    if (read_entry != nullptr)
+    if (write_entry != nullptr)
+    {
+        write_entry->is_deleted_ = false;
+        write_entry->record_ = record_;
+        execution_->GetCurrentRequest()->result_->SetFinished();
+    }
+    else if (read_entry != nullptr)
     {
         int64_t version_key = read_entry->version_ + 1;
         read_entry->is_updated_ = true;
@@ -1134,10 +1348,24 @@ void UpdateOperation::Reset(TableName *table_name, Key *key, Record *record)
 void UpdateOperation::CallImpl()
 {
     LocalState::SetKey set_key(table_name_, std::move(key_));
-
+    WriteSetEntry *write_entry =
+        execution_->FindInWriteSet(*table_name_, *key_);
     ReadSetEntry *read_entry = execution_->FindInReadSet(*table_name_, *key_);
 
-    if (read_entry != nullptr)
+    if (write_entry != nullptr)
+    {
+        // the key is uploaded once, with the txn's last write to it.
+        if (write_entry->is_deleted_)
+        {
+            execution_->GetCurrentRequest()->result_->SetError();
+        }
+        else
+        {
+            write_entry->record_ = record_;
+            execution_->GetCurrentRequest()->result_->SetFinished();
+        }
+    }
+    else if (read_entry != nullptr)
     {
         if (read_entry->is_deleted_ && read_entry->version_ > 0)
         {
@@ -1247,6 +1475,7 @@ void InitTxnOperation::Reset()
 
 void InitTxnOperation::CallImpl()
 {
+    Watch(result_of_new_txn_);
     execution_->handler_->NewTxn(execution_->txn_entry_,
         execution_->commit_timestamp_local_,
         execution_->kMaxTxnExecutionTimeMS,
@@ -1267,13 +1496,14 @@ TransactionOperation* InitTxnOperation::NextImpl()
 {
     if (result_of_new_txn_.IsError())
     {
-        execution_->ResetTxnIDAndTime();
-        execution_->init_txn_operation.Reset();
-        return (&(execution_->init_txn_operation));
+        // ids are unique by construction, a retry under a new one would
+        // not help.
+        return Abort(AbortReason::kNewTxnFailed);
     }
     else
     {
         execution_->txn_id_ = execution_->txn_entry_.tx_id;
+        execution_->SetTxnEntryCreated();
         execution_->GetCurrentRequest()->result_->SetFinished();
         has_next_ = false;
         return nullptr;
@@ -1325,4 +1555,66 @@ TransactionOperation* ReadDataStoreOperation::NextImpl()
     has_next_ = false;
     return nullptr;
 }
+void StepOperation::Reset(const Steps *steps)
+{
+    steps_ = steps;
+    next_step_ = 0;
+    stopped_ = false;
+    failed_ = false;
+    fail_reason_ = AbortReason::kNone;
+    then_ = nullptr;
+    awaited_.clear();
+}
+
+void StepOperation::CallImpl()
+{
+    awaited_.clear();
+    if (next_step_ < steps_->size())
+    {
+        stopped_ = !(*steps_)[next_step_++](*this);
+    }
+}
+
+bool StepOperation::IsFinished() const
+{
+    for (const bool *is_finished : awaited_)
+    {
+        if (!*is_finished)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StepOperation::IsCascadeFinished() const
+{
+    return IsFinished() && move_to_next_;
+}
+
+TransactionOperation *StepOperation::NextImpl()
+{
+    if (failed_)
+    {
+        return Abort(fail_reason_);
+    }
+    if (!stopped_ && next_step_ < steps_->size())
+    {
+        // called again by MoveForward, which runs the next step.
+        return this;
+    }
+    has_next_ = then_ != nullptr;
+    return then_;
+}
+
+void StepOperation::Fail(AbortReason reason)
+{
+    failed_ = true;
+    fail_reason_ = reason;
+}
+
+void StepOperation::Then(TransactionOperation *operation)
+{
+    then_ = operation;
+}
 }  // namespace txservice::transaction
\ No newline at end of file
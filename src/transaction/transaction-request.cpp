@@ -12,12 +12,12 @@ TransactionRequest::TransactionRequest(const TransactionRequest &that)
 {
 }
 
-void TransactionRequest::PushRequest(std::shared_ptr<OperationRequest> operation_request)
+void TransactionRequest::PushRequest(OperationRequest *operation_request)
 {
     operation_request_queue_.push_back(operation_request);
 }
 
-std::shared_ptr<OperationRequest> TransactionRequest::CurrentRequest()
+OperationRequest *TransactionRequest::CurrentRequest()
 {
     if (current_ >= operation_request_queue_.size())
     {
@@ -29,8 +29,17 @@ std::shared_ptr<OperationRequest> TransactionRequest::CurrentRequest()
     }
 }
 
+bool TransactionRequest::HasRequest() const
+{
+    return current_ < operation_request_queue_.size();
+}
+
 void TransactionRequest::Reset()
 {
+    for (OperationRequest *operation_request : operation_request_queue_)
+    {
+        operation_request->Release();
+    }
     operation_request_queue_.clear();
     current_ = 0;
 }
@@ -0,0 +1,107 @@
+#include "txcheckpoint/change-feed.h"
+#include <algorithm>
+
+namespace txservice::txckpt
+{
+ChangeFeed::ChangeFeed(size_t partition_count)
+    : partitions_(std::max<size_t>(1, partition_count))
+{
+}
+
+void ChangeFeed::Append(const TableName &table_name,
+                        size_t partition,
+                        const Key &key,
+                        int64_t commit_ts)
+{
+    Partition &part = partitions_[partition % partitions_.size()];
+    std::lock_guard<std::mutex> lock(part.mutex_);
+    DirtyKeys &keys = part.tables_[table_name];
+    auto it = keys.find(&key);
+    if (it != keys.end())
+    {
+        it->second.commit_ts_ = std::max(it->second.commit_ts_, commit_ts);
+        return;
+    }
+    Key::Pointer owned = key.Copy();
+    const Key *raw = owned.get();
+    keys.emplace(raw, Dirty{std::move(owned), commit_ts});
+}
+
+std::vector<Key::Pointer> ChangeFeed::Drain(const TableName &table_name,
+                                            size_t partition,
+                                            int64_t checkpoint_ts)
+{
+    std::vector<Key::Pointer> drained;
+    Partition &part = partitions_[partition % partitions_.size()];
+    std::lock_guard<std::mutex> lock(part.mutex_);
+    auto table = part.tables_.find(table_name);
+    if (table == part.tables_.end())
+    {
+        return drained;
+    }
+    DirtyKeys &keys = table->second;
+    DirtyKeys &pending = part.pending_[table_name];
+    for (auto it = keys.begin(); it != keys.end();)
+    {
+        if (it->second.commit_ts_ <= checkpoint_ts)
+        {
+            drained.push_back(it->second.key_->Copy());
+            pending.insert(keys.extract(it++));
+        }
+        else
+        {
+            it++;
+        }
+    }
+    return drained;
+}
+
+void ChangeFeed::Commit()
+{
+    for (Partition &part : partitions_)
+    {
+        std::lock_guard<std::mutex> lock(part.mutex_);
+        part.pending_.clear();
+    }
+}
+
+void ChangeFeed::Rollback()
+{
+    for (Partition &part : partitions_)
+    {
+        std::lock_guard<std::mutex> lock(part.mutex_);
+        for (auto &[table_name, pending] : part.pending_)
+        {
+            DirtyKeys &keys = part.tables_[table_name];
+            while (!pending.empty())
+            {
+                auto node = pending.extract(pending.begin());
+                // appended again since, at a later commit.
+                auto it = keys.find(node.key());
+                if (it != keys.end())
+                {
+                    it->second.commit_ts_ = std::max(
+                        it->second.commit_ts_, node.mapped().commit_ts_);
+                    continue;
+                }
+                keys.insert(std::move(node));
+            }
+        }
+        part.pending_.clear();
+    }
+}
+
+size_t ChangeFeed::Size()
+{
+    size_t size = 0;
+    for (Partition &part : partitions_)
+    {
+        std::lock_guard<std::mutex> lock(part.mutex_);
+        for (auto &table : part.tables_)
+        {
+            size += table.second.size();
+        }
+    }
+    return size;
+}
+}  // namespace txservice::txckpt
@@ -0,0 +1,266 @@
+#include "txcheckpoint/checkpoint-coordinator.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include "txcheckpoint/snapshot-file.h"
+#include "utility/parallel-for.h"
+
+namespace txservice::txckpt
+{
+namespace
+{
+void ThrowErrno(const std::string &what)
+{
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+void MakeDirectory(const std::string &path)
+{
+    if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        ThrowErrno("cannot create checkpoint directory " + path);
+    }
+}
+
+void SyncDirectory(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0 || fsync(fd) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        ThrowErrno("cannot sync checkpoint directory " + path);
+    }
+    close(fd);
+}
+
+// removes path and the files in it, if it exists.
+void RemoveDirectory(const std::string &path)
+{
+    if (DIR *dir = opendir(path.c_str()))
+    {
+        while (dirent *file = readdir(dir))
+        {
+            if (strcmp(file->d_name, ".") != 0 &&
+                strcmp(file->d_name, "..") != 0)
+            {
+                unlink((path + "/" + file->d_name).c_str());
+            }
+        }
+        closedir(dir);
+        rmdir(path.c_str());
+    }
+}
+}  // namespace
+
+CheckpointCoordinator::CheckpointCoordinator(const std::string &directory,
+                                             VersionDb *version_db,
+                                             txlog::TxLog *tx_log,
+                                             size_t thread_count,
+                                             int pipeline_depth,
+                                             ChangeFeed *change_feed)
+    : directory_(directory),
+      version_db_(version_db),
+      tx_log_(tx_log),
+      thread_count_(std::max<size_t>(1, thread_count)),
+      pipeline_depth_(pipeline_depth),
+      change_feed_(change_feed)
+{
+}
+
+void CheckpointCoordinator::AddTable(const TableName &table_name,
+                                     int partition_count,
+                                     const Record &infant,
+                                     void *record_deserializer,
+                                     void *key_deserializer)
+{
+    tables_.push_back(Table{table_name,
+                            partition_count,
+                            infant.Copy(),
+                            record_deserializer,
+                            key_deserializer});
+}
+
+CheckpointCoordinator::Stats CheckpointCoordinator::Checkpoint(
+    int64_t checkpoint_ts)
+{
+    Stats stats = Write(
+        checkpoint_ts, CheckpointPath(directory_, checkpoint_ts), false);
+    // superseded by this one.
+    for (int64_t older : ListCheckpoints(directory_))
+    {
+        if (older < checkpoint_ts)
+        {
+            RemoveDirectory(CheckpointPath(directory_, older));
+        }
+    }
+    for (int64_t older : ListDeltas(directory_))
+    {
+        if (older < checkpoint_ts)
+        {
+            RemoveDirectory(DeltaPath(directory_, older));
+        }
+    }
+    return stats;
+}
+
+CheckpointCoordinator::Stats CheckpointCoordinator::IncrementalCheckpoint(
+    int64_t checkpoint_ts)
+{
+    if (change_feed_ == nullptr || ListCheckpoints(directory_).empty())
+    {
+        throw std::runtime_error(
+            "incremental checkpoint needs a change feed and a full "
+            "checkpoint to start from");
+    }
+    return Write(checkpoint_ts, DeltaPath(directory_, checkpoint_ts), true);
+}
+
+int64_t CheckpointCoordinator::LastCheckpointTs() const
+{
+    std::vector<int64_t> full = ListCheckpoints(directory_);
+    if (full.empty())
+    {
+        return kNoCheckpoint;
+    }
+    // deltas only count on top of a full checkpoint.
+    std::vector<int64_t> deltas = ListDeltas(directory_);
+    if (!deltas.empty() && deltas.back() > full.back())
+    {
+        return deltas.back();
+    }
+    return full.back();
+}
+
+CheckpointCoordinator::Stats CheckpointCoordinator::Write(
+    int64_t checkpoint_ts, const std::string &path, bool incremental)
+{
+    Stats stats;
+    try
+    {
+        stats = WriteFiles(checkpoint_ts, path, incremental);
+    }
+    catch (...)
+    {
+        // the keys drained are read again by the next checkpoint.
+        if (change_feed_ != nullptr)
+        {
+            change_feed_->Rollback();
+        }
+        throw;
+    }
+    if (change_feed_ != nullptr)
+    {
+        change_feed_->Commit();
+    }
+    if (tx_log_ != nullptr)
+    {
+        tx_log_->CleanBefore(checkpoint_ts);
+    }
+    return stats;
+}
+
+CheckpointCoordinator::Stats CheckpointCoordinator::WriteFiles(
+    int64_t checkpoint_ts, const std::string &path, bool incremental)
+{
+    std::string tmp_path = path + ".tmp";
+    MakeDirectory(directory_);
+    // left over by a checkpoint that did not finish.
+    RemoveDirectory(tmp_path);
+    MakeDirectory(tmp_path);
+
+    std::vector<std::pair<Table *, int>> partitions;
+    for (Table &table : tables_)
+    {
+        for (int p = 0; p < table.partition_count_; p++)
+        {
+            partitions.emplace_back(&table, p);
+        }
+    }
+    std::vector<Stats> partition_stats(partitions.size());
+    ParallelFor(thread_count_, partitions.size(), [&](size_t i) {
+        Table &table = *partitions[i].first;
+        int partition = partitions[i].second;
+        TxCheckpoint checkpoint(table.table_name_,
+                                partition,
+                                nullptr,
+                                version_db_->MakeHandler(),
+                                table.infant_.get(),
+                                table.record_deserializer_,
+                                table.key_deserializer_,
+                                pipeline_depth_);
+        if (incremental)
+        {
+            checkpoint.NewIncrementalCheckpoint(checkpoint_ts, *change_feed_);
+        }
+        else
+        {
+            if (change_feed_ != nullptr)
+            {
+                // covered by the scan.
+                change_feed_->Drain(
+                    table.table_name_, partition, checkpoint_ts);
+            }
+            checkpoint.NewCheckpoint(checkpoint_ts);
+        }
+
+        // a full checkpoint has a file for every partition, an incremental
+        // one only for the partitions that changed.
+        std::unique_ptr<SnapshotWriter> writer;
+        if (!incremental)
+        {
+            writer = std::make_unique<SnapshotWriter>(
+                SnapshotPath(tmp_path, table.table_name_, partition),
+                checkpoint_ts);
+        }
+        while (checkpoint.MoveNext())
+        {
+            if (writer == nullptr)
+            {
+                writer = std::make_unique<SnapshotWriter>(
+                    SnapshotPath(tmp_path, table.table_name_, partition),
+                    checkpoint_ts);
+            }
+            writer->Add(checkpoint.Current());
+        }
+        if (writer == nullptr)
+        {
+            return;
+        }
+        writer->Finish();
+        checkpoint.Flush();
+
+        Stats &stats = partition_stats[i];
+        stats.partitions_ = 1;
+        stats.entries_ = writer->EntryCount();
+        stats.raw_bytes_ = writer->RawBytes();
+        stats.file_bytes_ = writer->FileBytes();
+    });
+
+    // every snapshot file is durable, publish the checkpoint as a whole.
+    SyncDirectory(tmp_path);
+    if (rename(tmp_path.c_str(), path.c_str()) != 0)
+    {
+        ThrowErrno("cannot rename checkpoint " + tmp_path);
+    }
+    SyncDirectory(directory_);
+
+    Stats stats;
+    for (const Stats &partition : partition_stats)
+    {
+        stats.partitions_ += partition.partitions_;
+        stats.entries_ += partition.entries_;
+        stats.raw_bytes_ += partition.raw_bytes_;
+        stats.file_bytes_ += partition.file_bytes_;
+    }
+    return stats;
+}
+}  // namespace txservice::txckpt
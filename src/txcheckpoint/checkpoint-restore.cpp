@@ -0,0 +1,150 @@
+#include "txcheckpoint/checkpoint-restore.h"
+#include <unistd.h>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "txcheckpoint/snapshot-file.h"
+#include "txlog/log-replay.h"
+#include "utility/parallel-for.h"
+
+namespace txservice::txckpt
+{
+CheckpointRestore::CheckpointRestore(const std::string &directory,
+                                     VersionDb *version_db,
+                                     size_t thread_count)
+    : directory_(directory),
+      version_db_(version_db),
+      thread_count_(std::max<size_t>(1, thread_count))
+{
+}
+
+void CheckpointRestore::AddTable(const TableName &table_name,
+                                 int partition_count,
+                                 const Key &key,
+                                 const Record &record)
+{
+    tables_[table_name] = Schema{partition_count, key.Copy(), record.Copy()};
+}
+
+CheckpointRestore::Stats CheckpointRestore::Run()
+{
+    Stats stats;
+    std::vector<int64_t> full = ListCheckpoints(directory_);
+    if (full.empty())
+    {
+        return stats;
+    }
+    // the full checkpoint, then the incremental ones on top of it.
+    std::vector<std::string> paths{CheckpointPath(directory_, full.back())};
+    stats.checkpoint_ts_ = full.back();
+    for (int64_t delta : ListDeltas(directory_))
+    {
+        if (delta > full.back())
+        {
+            paths.push_back(DeltaPath(directory_, delta));
+            stats.checkpoint_ts_ = delta;
+        }
+    }
+
+    std::vector<std::pair<const TableName *, int>> partitions;
+    for (auto &[table_name, schema] : tables_)
+    {
+        for (int p = 0; p < schema.partition_count_; p++)
+        {
+            partitions.emplace_back(&table_name, p);
+        }
+    }
+    std::vector<Stats> partition_stats(partitions.size());
+    ParallelFor(thread_count_, partitions.size(), [&](size_t i) {
+        const TableName &table_name = *partitions[i].first;
+        int partition = partitions[i].second;
+        const Schema &schema = tables_.at(table_name);
+        Stats &part = partition_stats[i];
+
+        // oldest first, each at its next entry.
+        std::vector<std::unique_ptr<SnapshotReader>> readers;
+        auto advance = [&part](SnapshotReader &reader) {
+            bool has_next = reader.MoveNext();
+            part.entries_ += has_next ? 1 : 0;
+            return has_next;
+        };
+        for (size_t f = 0; f < paths.size(); f++)
+        {
+            std::string path = SnapshotPath(paths[f], table_name, partition);
+            // an incremental checkpoint only has the partitions that
+            // changed, a full one has them all.
+            if (f > 0 && access(path.c_str(), F_OK) != 0)
+            {
+                continue;
+            }
+            auto reader = std::make_unique<SnapshotReader>(
+                path, *schema.key_, *schema.record_);
+            part.files_++;
+            if (advance(*reader))
+            {
+                readers.push_back(std::move(reader));
+            }
+        }
+
+        request::Handler::Pointer handler = version_db_->MakeHandler();
+        while (!readers.empty())
+        {
+            // the smallest key; of the files holding it, the newest wins.
+            size_t newest = 0;
+            for (size_t r = 1; r < readers.size(); r++)
+            {
+                if (readers[r]->CurrentKey() <= readers[newest]->CurrentKey())
+                {
+                    newest = r;
+                }
+            }
+            CheckpointEntry entry = readers[newest]->Current();
+            if (!txlog::LogReplay::RestoreVersion(*handler,
+                                                  table_name,
+                                                  *entry.key_,
+                                                  entry.version_,
+                                                  entry.is_deleted_,
+                                                  entry.record_,
+                                                  entry.commit_ts_))
+            {
+                throw std::runtime_error(
+                    "cannot restore checkpoint of table " + table_name +
+                    " partition " + std::to_string(partition) +
+                    " into a store holding its keys");
+            }
+            part.keys_++;
+
+            // the older files holding the key move on first, the key of
+            // newest is only valid until it does.
+            std::vector<bool> exhausted(readers.size(), false);
+            for (size_t r = 0; r < readers.size(); r++)
+            {
+                if (r != newest &&
+                    readers[r]->CurrentKey() == readers[newest]->CurrentKey())
+                {
+                    exhausted[r] = !advance(*readers[r]);
+                }
+            }
+            exhausted[newest] = !advance(*readers[newest]);
+            size_t kept = 0;
+            for (size_t r = 0; r < readers.size(); r++)
+            {
+                if (!exhausted[r])
+                {
+                    readers[kept++] = std::move(readers[r]);
+                }
+            }
+            readers.resize(kept);
+        }
+    });
+
+    for (const Stats &part : partition_stats)
+    {
+        stats.files_ += part.files_;
+        stats.entries_ += part.entries_;
+        stats.keys_ += part.keys_;
+    }
+    return stats;
+}
+}  // namespace txservice::txckpt
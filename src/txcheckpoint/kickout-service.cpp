@@ -0,0 +1,114 @@
+#include "txcheckpoint/kickout-service.h"
+#include <algorithm>
+#include "utility/parallel-for.h"
+
+namespace txservice::kickout
+{
+KickoutService::KickoutService(VersionDb *version_db,
+                               size_t memory_budget,
+                               size_t thread_count,
+                               int window)
+    : version_db_(version_db),
+      memory_budget_(memory_budget),
+      thread_count_(std::max<size_t>(1, thread_count)),
+      window_(window),
+      lru_interval_(kMaxLruInterval)
+{
+}
+
+void KickoutService::AddTable(const TableName &table_name,
+                              int partition_count,
+                              void *key_deserializer)
+{
+    tables_.push_back(Table{table_name, partition_count, key_deserializer});
+}
+
+KickoutService::Stats KickoutService::Round(int64_t kickout_ts,
+                                            int64_t checkpoint_ts)
+{
+    std::vector<std::pair<size_t, int>> partitions;
+    for (size_t t = 0; t < tables_.size(); t++)
+    {
+        Table &table = tables_[t];
+        if (!over_budget_ && table.skip_ > 0)
+        {
+            table.skip_--;
+            continue;
+        }
+        for (int p = 0; p < table.partition_count_; p++)
+        {
+            partitions.emplace_back(t, p);
+        }
+    }
+
+    struct Count
+    {
+        size_t total_num_ = 0;
+        size_t kickout_num_ = 0;
+    };
+    std::vector<Count> counts(partitions.size());
+    ParallelFor(thread_count_, partitions.size(), [&](size_t i) {
+        Table &table = tables_[partitions[i].first];
+        Kickout kickout(version_db_->MakeHandler(),
+                        table.table_name_,
+                        partitions[i].second,
+                        window_,
+                        table.key_deserializer_);
+        kickout.NewKickout(kickout_ts,
+                           lru_interval_,
+                           std::min(checkpoint_ts, kickout_ts));
+        kickout.Run();
+        counts[i].total_num_ = kickout.total_num;
+        counts[i].kickout_num_ = kickout.kickout_num;
+    });
+
+    Stats stats;
+    std::vector<Count> table_counts(tables_.size());
+    std::vector<bool> scanned(tables_.size(), false);
+    for (size_t i = 0; i < partitions.size(); i++)
+    {
+        Count &count = table_counts[partitions[i].first];
+        count.total_num_ += counts[i].total_num_;
+        count.kickout_num_ += counts[i].kickout_num_;
+        scanned[partitions[i].first] = true;
+        stats.total_num_ += counts[i].total_num_;
+        stats.kickout_num_ += counts[i].kickout_num_;
+    }
+    for (size_t t = 0; t < tables_.size(); t++)
+    {
+        if (!scanned[t])
+        {
+            continue;
+        }
+        stats.tables_++;
+        Table &table = tables_[t];
+        if (table_counts[t].kickout_num_ == 0)
+        {
+            table.skip_ = table.backoff_;
+            table.backoff_ = std::min(kMaxBackoff, table.backoff_ * 2);
+        }
+        else
+        {
+            table.skip_ = 0;
+            table.backoff_ = 1;
+        }
+    }
+
+    stats.memory_usage_ = version_db_->VersionMemoryUsage();
+    if (memory_budget_ > 0 && stats.memory_usage_ > 0)
+    {
+        over_budget_ = stats.memory_usage_ > memory_budget_;
+        if (over_budget_)
+        {
+            lru_interval_ = std::max(Constant::KICKOUT_MIN_LRU_INTERVAL,
+                                     lru_interval_ / 2);
+        }
+        else if (stats.memory_usage_ < memory_budget_ / 4 * 3)
+        {
+            lru_interval_ = std::min(kMaxLruInterval, lru_interval_ * 2);
+        }
+    }
+    stats.lru_interval_ = lru_interval_;
+    return stats;
+}
+}  // namespace txservice::kickout
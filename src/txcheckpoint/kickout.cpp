@@ -0,0 +1,59 @@
+#include "txcheckpoint/kickout.h"
+#include <stdexcept>
+#include <thread>
+
+namespace txservice::kickout
+{
+void Kickout::Run()
+{
+    size_t window = slots_.size();
+    size_t issued = 0;
+    size_t finished = 0;
+    while (HasNext() || finished < issued)
+    {
+        // keep the window full before waiting on its oldest call.
+        while (issued - finished < window && HasNext())
+        {
+            Slot &slot = slots_[issued % window];
+            // the iterator may reuse its key, the slot keeps its own copy.
+            Key &key = key_iterator->Next();
+            if (slot.key_ == nullptr || !slot.key_->CopyFrom(key))
+            {
+                slot.key_ = key.Copy();
+            }
+            slot.result_.Reset();
+            handler_->KickoutVersion(table_name_,
+                                     slot.key_.get(),
+                                     checkpoint_ts,
+                                     expire_ts,
+                                     lru_ts,
+                                     slot.result_);
+            issued++;
+        }
+        if (finished < issued)
+        {
+            Finish(slots_[finished % window]);
+            finished++;
+        }
+    }
+}
+
+void Kickout::Finish(Slot &slot)
+{
+    while (!slot.result_.IsFinished())
+    {
+        handler_->SendBatch();
+        std::this_thread::yield();
+    }
+    if (slot.result_.IsError())
+    {
+        throw std::runtime_error("kickout failed in table " + table_name_ +
+                                 " partition " + std::to_string(partition_));
+    }
+    total_num++;
+    if (slot.result_.result_)
+    {
+        kickout_num++;
+    }
+}
+}  // namespace txservice::kickout
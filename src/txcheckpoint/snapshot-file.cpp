@@ -0,0 +1,672 @@
+#include "txcheckpoint/snapshot-file.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include "txlog/log-record.h"
+
+namespace txservice::txckpt
+{
+namespace
+{
+const char kCheckpointPrefix[] = "checkpoint.";
+const char kDeltaPrefix[] = "delta.";
+const char kTmpSuffix[] = ".tmp";
+const char kRunSuffix[] = ".run";
+
+// an entry but its key and record: their lengths, is_deleted, version and
+// commit timestamp.
+constexpr size_t kEntryFixedLength = 2 * sizeof(uint32_t) +
+                                     Constant::BOOL_LENGTH +
+                                     2 * Constant::INT64_T_LENGTH;
+
+void ThrowErrno(const std::string &what)
+{
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+uint32_t Checksum(const char *data, size_t length)
+{
+    return txlog::LogRecordHeader::Checksum(data, length);
+}
+
+template <typename T>
+void Append(std::string &buffer, const T &value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+T Take(const char *buffer, size_t &offset)
+{
+    T value;
+    memcpy(&value, buffer + offset, sizeof(value));
+    offset += sizeof(value);
+    return value;
+}
+
+// the serialized key of a serialized entry.
+std::string_view EntryKey(const char *entry)
+{
+    uint32_t key_length;
+    memcpy(&key_length, entry, sizeof(key_length));
+    return std::string_view(entry + sizeof(key_length), key_length);
+}
+
+bool WriteAll(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd, data, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+// reads back the entries of a run file through a buffer of
+// SNAPSHOT_RUN_BUFFER_SIZE.
+class RunReader
+{
+public:
+    explicit RunReader(const std::string &path)
+        : path_(path),
+          buffer_(Constant::SNAPSHOT_RUN_BUFFER_SIZE),
+          begin_(0),
+          end_(0),
+          length_(0)
+    {
+        fd_ = open(path_.c_str(), O_RDONLY);
+        if (fd_ < 0)
+        {
+            ThrowErrno("cannot open snapshot run " + path_);
+        }
+    }
+
+    ~RunReader()
+    {
+        close(fd_);
+    }
+
+    /// moves to the next entry, false at the end of the run.
+    bool Next()
+    {
+        begin_ += length_;
+        length_ = 0;
+        if (!Fill(sizeof(uint32_t)))
+        {
+            if (end_ == begin_)
+            {
+                return false;
+            }
+            throw std::runtime_error("truncated snapshot run " + path_);
+        }
+        size_t fixed = kEntryFixedLength + EntryKey(Entry()).size();
+        if (!Fill(fixed))
+        {
+            throw std::runtime_error("truncated snapshot run " + path_);
+        }
+        uint32_t record_length;
+        memcpy(&record_length,
+               Entry() + fixed - sizeof(record_length),
+               sizeof(record_length));
+        if (!Fill(fixed + record_length))
+        {
+            throw std::runtime_error("truncated snapshot run " + path_);
+        }
+        length_ = fixed + record_length;
+        return true;
+    }
+
+    const char *Entry() const
+    {
+        return buffer_.data() + begin_;
+    }
+
+    uint32_t Length() const
+    {
+        return length_;
+    }
+
+private:
+    // makes length bytes from begin_ available, false if the file ends
+    // before.
+    bool Fill(size_t length)
+    {
+        if (end_ - begin_ >= length)
+        {
+            return true;
+        }
+        memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+        if (buffer_.size() < length)
+        {
+            buffer_.resize(length);
+        }
+        while (end_ < length)
+        {
+            ssize_t read_bytes =
+                read(fd_, buffer_.data() + end_, buffer_.size() - end_);
+            if (read_bytes < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (read_bytes < 0)
+            {
+                ThrowErrno("cannot read snapshot run " + path_);
+            }
+            if (read_bytes == 0)
+            {
+                return false;
+            }
+            end_ += read_bytes;
+        }
+        return true;
+    }
+
+    const std::string path_;
+    int fd_;
+    std::vector<char> buffer_;
+    size_t begin_;
+    size_t end_;
+    uint32_t length_;
+};
+
+// timestamps of the directories <prefix><ts> in directory, ascending;
+// those still being written end in .tmp.
+std::vector<int64_t> ListTimestamps(const std::string &directory,
+                                    const char *prefix)
+{
+    std::vector<int64_t> timestamps;
+    if (DIR *dir = opendir(directory.c_str()))
+    {
+        size_t prefix_length = strlen(prefix);
+        while (dirent *file = readdir(dir))
+        {
+            if (strncmp(file->d_name, prefix, prefix_length) != 0)
+            {
+                continue;
+            }
+            char *end;
+            int64_t ts = strtoll(file->d_name + prefix_length, &end, 10);
+            if (*end == '\0')
+            {
+                timestamps.push_back(ts);
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(timestamps.begin(), timestamps.end());
+    return timestamps;
+}
+}  // namespace
+
+SnapshotWriter::SnapshotWriter(const std::string &path,
+                               int64_t checkpoint_ts,
+                               size_t run_size)
+    : path_(path),
+      checkpoint_ts_(checkpoint_ts),
+      run_size_(run_size),
+      codec_(folly::io::getCodec(PickCodec())),
+      run_count_(0),
+      block_entries_(0),
+      entry_count_(0),
+      block_count_(0),
+      raw_bytes_(0),
+      file_bytes_(0)
+{
+    std::string tmp_path = path_ + kTmpSuffix;
+    fd_ = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+    {
+        ThrowErrno("cannot create snapshot " + tmp_path);
+    }
+}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    // not finished: drop what was written.
+    if (fd_ >= 0)
+    {
+        close(fd_);
+        unlink((path_ + kTmpSuffix).c_str());
+        for (size_t run = 0; run < run_count_; run++)
+        {
+            unlink(RunPath(run).c_str());
+        }
+    }
+}
+
+folly::io::CodecType SnapshotWriter::PickCodec()
+{
+    using folly::io::CodecType;
+    for (CodecType type : {CodecType::ZSTD,
+                           CodecType::LZ4,
+                           CodecType::SNAPPY,
+                           CodecType::ZLIB})
+    {
+        if (folly::io::hasCodec(type))
+        {
+            return type;
+        }
+    }
+    return CodecType::NO_COMPRESSION;
+}
+
+void SnapshotWriter::Add(const CheckpointEntry &entry)
+{
+    uint32_t key_length = entry.key_->Serialize_Length();
+    uint32_t record_length =
+        entry.is_deleted_ ? 0 : entry.record_->Serialize_Length();
+    EntryRef ref{arena_.size(),
+                 static_cast<uint32_t>(kEntryFixedLength + key_length +
+                                       record_length),
+                 key_length};
+    arena_.resize(arena_.size() + ref.length_);
+
+    char *buffer = arena_.data() + ref.offset_;
+    size_t offset = 0;
+    memcpy(buffer + offset, &key_length, sizeof(key_length));
+    offset += sizeof(key_length);
+    entry.key_->SerializeToBuffer(buffer, offset);
+    memcpy(buffer + offset, &entry.is_deleted_, Constant::BOOL_LENGTH);
+    offset += Constant::BOOL_LENGTH;
+    memcpy(buffer + offset, &entry.version_, Constant::INT64_T_LENGTH);
+    offset += Constant::INT64_T_LENGTH;
+    memcpy(buffer + offset, &entry.commit_ts_, Constant::INT64_T_LENGTH);
+    offset += Constant::INT64_T_LENGTH;
+    memcpy(buffer + offset, &record_length, sizeof(record_length));
+    offset += sizeof(record_length);
+    if (!entry.is_deleted_)
+    {
+        entry.record_->SerializeToBuffer(buffer, offset);
+    }
+    entries_.push_back(ref);
+    entry_count_++;
+    raw_bytes_ += ref.length_;
+    if (arena_.size() >= run_size_)
+    {
+        SpillRun();
+    }
+}
+
+void SnapshotWriter::SortEntries()
+{
+    const char *arena = arena_.data();
+    std::sort(entries_.begin(),
+              entries_.end(),
+              [arena](const EntryRef &lhs, const EntryRef &rhs) {
+                  return EntryKey(arena + lhs.offset_) <
+                         EntryKey(arena + rhs.offset_);
+              });
+}
+
+std::string SnapshotWriter::RunPath(size_t run) const
+{
+    return path_ + kTmpSuffix + kRunSuffix + std::to_string(run);
+}
+
+void SnapshotWriter::SpillRun()
+{
+    SortEntries();
+    std::string path = RunPath(run_count_);
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        ThrowErrno("cannot create snapshot run " + path);
+    }
+    run_count_++;
+    // written in pieces of a merge read buffer, the run is read back in
+    // order and need not be durable.
+    std::string chunk;
+    chunk.reserve(Constant::SNAPSHOT_RUN_BUFFER_SIZE);
+    auto flush = [&]() {
+        if (!WriteAll(fd, chunk.data(), chunk.size()))
+        {
+            close(fd);
+            ThrowErrno("cannot write snapshot run " + path);
+        }
+        chunk.clear();
+    };
+    for (const EntryRef &ref : entries_)
+    {
+        if (chunk.size() + ref.length_ > Constant::SNAPSHOT_RUN_BUFFER_SIZE)
+        {
+            flush();
+        }
+        chunk.append(arena_.data() + ref.offset_, ref.length_);
+    }
+    flush();
+    close(fd);
+    arena_.clear();
+    entries_.clear();
+}
+
+void SnapshotWriter::MergeRuns()
+{
+    std::vector<std::unique_ptr<RunReader>> runs;
+    for (size_t run = 0; run < run_count_; run++)
+    {
+        runs.push_back(std::make_unique<RunReader>(RunPath(run)));
+    }
+    // smallest key on top; a key is in one run only.
+    auto greater = [](const RunReader *lhs, const RunReader *rhs) {
+        return EntryKey(lhs->Entry()) > EntryKey(rhs->Entry());
+    };
+    std::vector<RunReader *> heap;
+    for (auto &run : runs)
+    {
+        if (run->Next())
+        {
+            heap.push_back(run.get());
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), greater);
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        RunReader *run = heap.back();
+        AddToBlock(run->Entry(), run->Length(), EntryKey(run->Entry()));
+        if (run->Next())
+        {
+            std::push_heap(heap.begin(), heap.end(), greater);
+        }
+        else
+        {
+            heap.pop_back();
+        }
+    }
+    runs.clear();
+    for (size_t run = 0; run < run_count_; run++)
+    {
+        unlink(RunPath(run).c_str());
+    }
+    run_count_ = 0;
+}
+
+void SnapshotWriter::Finish()
+{
+    if (run_count_ == 0)
+    {
+        SortEntries();
+        for (const EntryRef &ref : entries_)
+        {
+            const char *entry = arena_.data() + ref.offset_;
+            AddToBlock(entry, ref.length_, EntryKey(entry));
+        }
+    }
+    else
+    {
+        if (!entries_.empty())
+        {
+            SpillRun();
+        }
+        MergeRuns();
+    }
+    FlushBlock();
+
+    SnapshotFooter footer;
+    footer.index_offset_ = file_bytes_;
+    footer.index_length_ = index_.size();
+    footer.entry_count_ = entry_count_;
+    footer.checkpoint_ts_ = checkpoint_ts_;
+    footer.block_count_ = block_count_;
+    footer.codec_ = static_cast<uint32_t>(codec_->type());
+    footer.index_checksum_ = Checksum(index_.data(), index_.size());
+    footer.magic_ = SnapshotFooter::kMagic;
+    Write(index_.data(), index_.size());
+    Write(reinterpret_cast<const char *>(&footer), sizeof(footer));
+
+    std::string tmp_path = path_ + kTmpSuffix;
+    if (fdatasync(fd_) != 0)
+    {
+        ThrowErrno("cannot sync snapshot " + tmp_path);
+    }
+    close(fd_);
+    fd_ = -1;
+    if (rename(tmp_path.c_str(), path_.c_str()) != 0)
+    {
+        ThrowErrno("cannot rename snapshot " + tmp_path);
+    }
+    arena_.clear();
+    arena_.shrink_to_fit();
+    entries_.clear();
+    entries_.shrink_to_fit();
+}
+
+void SnapshotWriter::AddToBlock(const char *entry,
+                                uint32_t length,
+                                std::string_view key)
+{
+    if (!block_.empty() &&
+        block_.size() + length > Constant::SNAPSHOT_BLOCK_SIZE)
+    {
+        FlushBlock();
+    }
+    if (block_.empty())
+    {
+        block_first_key_.assign(key.data(), key.size());
+    }
+    block_.append(entry, length);
+    block_entries_++;
+}
+
+void SnapshotWriter::FlushBlock()
+{
+    if (block_.empty())
+    {
+        return;
+    }
+    WriteBlock(block_,
+               block_first_key_.data(),
+               block_first_key_.size(),
+               block_entries_);
+    block_.clear();
+    block_entries_ = 0;
+}
+
+void SnapshotWriter::WriteBlock(const std::string &raw,
+                                const char *first_key,
+                                uint32_t first_key_length,
+                                uint32_t entry_count)
+{
+    std::string compressed = codec_->compress(raw);
+    uint64_t offset = file_bytes_;
+    Write(compressed.data(), compressed.size());
+
+    Append(index_, offset);
+    Append(index_, static_cast<uint32_t>(compressed.size()));
+    Append(index_, static_cast<uint32_t>(raw.size()));
+    Append(index_, Checksum(compressed.data(), compressed.size()));
+    Append(index_, entry_count);
+    Append(index_, first_key_length);
+    index_.append(first_key, first_key_length);
+    block_count_++;
+}
+
+void SnapshotWriter::Write(const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd_, data, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            ThrowErrno("cannot write snapshot " + path_ + kTmpSuffix);
+        }
+        data += written;
+        length -= written;
+        file_bytes_ += written;
+    }
+}
+
+SnapshotReader::SnapshotReader(const std::string &path,
+                               const Key &key,
+                               const Record &record)
+    : path_(path),
+      next_block_(0),
+      block_offset_(0),
+      key_(key.Copy()),
+      record_(record.Copy()),
+      is_deleted_(true),
+      version_(VersionEntry::kDefaultVersion),
+      commit_ts_(0),
+      key_offset_(0),
+      key_length_(0)
+{
+    fd_ = open(path_.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd_ < 0 || fstat(fd_, &st) != 0)
+    {
+        if (fd_ >= 0)
+        {
+            close(fd_);
+        }
+        ThrowErrno("cannot open snapshot " + path_);
+    }
+    if (static_cast<size_t>(st.st_size) < sizeof(footer_))
+    {
+        close(fd_);
+        throw std::runtime_error("truncated snapshot " + path_);
+    }
+    Read(&footer_, sizeof(footer_), st.st_size - sizeof(footer_));
+    std::string index(footer_.index_length_, '\0');
+    Read(index.data(), index.size(), footer_.index_offset_);
+    if (footer_.magic_ != SnapshotFooter::kMagic ||
+        Checksum(index.data(), index.size()) != footer_.index_checksum_)
+    {
+        close(fd_);
+        throw std::runtime_error("corrupted snapshot " + path_);
+    }
+    codec_ = folly::io::getCodec(
+        static_cast<folly::io::CodecType>(footer_.codec_));
+
+    size_t offset = 0;
+    for (uint32_t i = 0; i < footer_.block_count_; i++)
+    {
+        BlockHandle block;
+        block.offset_ = Take<uint64_t>(index.data(), offset);
+        block.length_ = Take<uint32_t>(index.data(), offset);
+        block.raw_length_ = Take<uint32_t>(index.data(), offset);
+        block.checksum_ = Take<uint32_t>(index.data(), offset);
+        // entry count and first key, for seeking.
+        Take<uint32_t>(index.data(), offset);
+        offset += Take<uint32_t>(index.data(), offset);
+        blocks_.push_back(block);
+    }
+}
+
+SnapshotReader::~SnapshotReader()
+{
+    close(fd_);
+}
+
+bool SnapshotReader::MoveNext()
+{
+    if (block_offset_ >= block_.size())
+    {
+        if (next_block_ == blocks_.size())
+        {
+            return false;
+        }
+        const BlockHandle &block = blocks_[next_block_++];
+        std::string compressed(block.length_, '\0');
+        Read(compressed.data(), compressed.size(), block.offset_);
+        if (Checksum(compressed.data(), compressed.size()) != block.checksum_)
+        {
+            throw std::runtime_error("corrupted block in snapshot " + path_);
+        }
+        block_ = codec_->uncompress(compressed, block.raw_length_);
+        block_offset_ = 0;
+    }
+
+    const char *buffer = block_.data();
+    key_length_ = Take<uint32_t>(buffer, block_offset_);
+    key_offset_ = block_offset_;
+    key_->DeserializeFromBuffer(buffer, block_offset_);
+    is_deleted_ = Take<bool>(buffer, block_offset_);
+    version_ = Take<int64_t>(buffer, block_offset_);
+    commit_ts_ = Take<int64_t>(buffer, block_offset_);
+    Take<uint32_t>(buffer, block_offset_);
+    if (!is_deleted_)
+    {
+        record_->DeserializeFromBuffer(buffer, block_offset_);
+    }
+    return true;
+}
+
+CheckpointEntry SnapshotReader::Current()
+{
+    return CheckpointEntry(key_.get(),
+                           is_deleted_ ? nullptr : record_.get(),
+                           is_deleted_,
+                           version_,
+                           commit_ts_);
+}
+
+void SnapshotReader::Read(void *data, size_t length, uint64_t offset)
+{
+    char *buffer = static_cast<char *>(data);
+    while (length > 0)
+    {
+        ssize_t read = pread(fd_, buffer, length, offset);
+        if (read <= 0)
+        {
+            if (read < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error("cannot read snapshot " + path_);
+        }
+        buffer += read;
+        length -= read;
+        offset += read;
+    }
+}
+
+std::string CheckpointPath(const std::string &directory,
+                           int64_t checkpoint_ts)
+{
+    return directory + "/" + kCheckpointPrefix + std::to_string(checkpoint_ts);
+}
+
+std::string SnapshotPath(const std::string &checkpoint_path,
+                         const TableName &table_name,
+                         int partition)
+{
+    return checkpoint_path + "/" + table_name + "." +
+           std::to_string(partition);
+}
+
+std::string DeltaPath(const std::string &directory, int64_t checkpoint_ts)
+{
+    return directory + "/" + kDeltaPrefix + std::to_string(checkpoint_ts);
+}
+
+std::vector<int64_t> ListCheckpoints(const std::string &directory)
+{
+    return ListTimestamps(directory, kCheckpointPrefix);
+}
+
+std::vector<int64_t> ListDeltas(const std::string &directory)
+{
+    return ListTimestamps(directory, kDeltaPrefix);
+}
+}  // namespace txservice::txckpt
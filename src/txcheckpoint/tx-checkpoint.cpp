@@ -0,0 +1,89 @@
+#include "txcheckpoint/tx-checkpoint.h"
+#include <stdexcept>
+#include <thread>
+
+namespace txservice::txckpt
+{
+TxCheckpoint::TxCheckpoint(const TableName table_name,
+                           int partition,
+                           txlog::TxLog::Pointer tx_log,
+                           request::Handler::Pointer handler,
+                           Record *infant,
+                           void *record_deserializer,
+                           void *key_deserializer,
+                           int batch_size)
+    : batch_size_(std::max(1, batch_size)), slots_(batch_size_)
+{
+    this->table_name_ = table_name;
+    this->partition_ = partition;
+    this->tx_log_ = std::move(tx_log);
+    this->handler_ = std::move(handler);
+    this->key_deserializer_ = key_deserializer;
+    this->record_deserailizer_ = record_deserializer;
+    for (Slot &slot : slots_)
+    {
+        slot.record_ = infant->Copy();
+        slot.result_.result_.read_record_ = slot.record_.get();
+    }
+}
+
+bool TxCheckpoint::MoveNext()
+{
+    if (has_current_)
+    {
+        consumed_++;
+        has_current_ = false;
+    }
+    // keep the window full before waiting on its oldest read.
+    while (issued_ - consumed_ < static_cast<size_t>(batch_size_) &&
+           key_iterator_->HasNext())
+    {
+        ReadPayload(issued_ % batch_size_, key_iterator_->Next());
+        issued_++;
+    }
+    if (consumed_ == issued_)
+    {
+        return false;
+    }
+
+    Slot &slot = slots_[consumed_ % batch_size_];
+    while (!slot.result_.IsFinished())
+    {
+        handler_->SendBatch();
+        std::this_thread::yield();
+    }
+    if (slot.result_.IsError())
+    {
+        throw std::runtime_error("checkpoint read failed in table " +
+                                 table_name_ + " partition " +
+                                 std::to_string(partition_));
+    }
+    has_current_ = true;
+    return true;
+}
+
+CheckpointEntry TxCheckpoint::Current()
+{
+    Slot &slot = slots_[consumed_ % batch_size_];
+    const VersionEntry &version = slot.result_.result_;
+    return CheckpointEntry(slot.key_.get(),
+                           version.is_deleted_ ? nullptr : slot.record_.get(),
+                           version.is_deleted_,
+                           version.version_,
+                           version.begin_ts_);
+}
+
+void TxCheckpoint::ReadPayload(int idx, Key &key)
+{
+    Slot &slot = slots_[idx];
+    // the iterator may reuse its key, the slot keeps its own copy.
+    if (slot.key_ == nullptr || !slot.key_->CopyFrom(key))
+    {
+        slot.key_ = key.Copy();
+    }
+    slot.result_.Reset();
+    slot.result_.result_.read_record_ = slot.record_.get();
+    this->handler_->GetVisibleVersionPromise(
+        this->table_name_, *slot.key_, slot.result_, this->record_deserailizer_);
+}
+}  // namespace txservice::txckpt
@@ -0,0 +1,325 @@
+#include "txlog/file-tx-log.h"
+#include <assert.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include "utility/completion.h"
+
+namespace txservice::txlog
+{
+namespace
+{
+// blocks Append until its entry is durable.
+struct BlockingListener : request::CompletionListener
+{
+    virtual void OnCompletion() override
+    {
+        completion_.Set();
+    }
+
+    Completion completion_;
+};
+
+void ThrowErrno(const std::string &what)
+{
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+}  // namespace
+
+FileTxLog::FileTxLog(const std::string &directory,
+                     int executor_count,
+                     int64_t group_commit_window_us,
+                     size_t segment_size)
+    : directory_(directory),
+      group_commit_window_us_(group_commit_window_us),
+      segment_size_(segment_size),
+      buffers_(executor_count),
+      batch_data_(executor_count),
+      fd_(-1),
+      segment_bytes_(0),
+      kicked_(false),
+      stopping_(false),
+      closed_(false)
+{
+    for (ExecutorBuffer &buffer : buffers_)
+    {
+        buffer.data_.reserve(Constant::TX_LOG_BUFFER_SIZE);
+    }
+    // never append to segments of an earlier run, they are left for replay.
+    uint64_t next_sequence = 0;
+    for (uint64_t sequence : ListSegments(directory_))
+    {
+        segments_.push_back({sequence, INT64_MAX});
+        next_sequence = sequence + 1;
+    }
+    OpenSegment(next_sequence);
+    flusher_ = std::thread(&FileTxLog::FlushLoop, this);
+}
+
+FileTxLog::~FileTxLog()
+{
+    Close();
+}
+
+void FileTxLog::Serialize(ExecutorBuffer &buffer,
+                          const transaction::LocalState::WriteSet *write_entry,
+                          size_t size,
+                          const TxnEntry *txn_entry)
+{
+    size_t length = LogRecord::Length(write_entry, size, txn_entry);
+    std::vector<char> &data = buffer.data_;
+    size_t begin = data.size();
+    data.resize(begin + length);
+    LogRecord::Serialize(
+        data.data() + begin, length, write_entry, size, txn_entry);
+    buffer.max_commit_ts_ = std::max(buffer.max_commit_ts_, txn_entry->commit_ts);
+}
+
+void FileTxLog::Append(int executor_id,
+                       const transaction::LocalState::WriteSet *write_entry,
+                       const size_t size,
+                       const TxnEntry *txn_entry,
+                       bool sync)
+{
+    std::atomic<bool> is_finish = false;
+    BlockingListener listener;
+    AsyncAppend(
+        executor_id, write_entry, size, txn_entry, &is_finish, sync, &listener);
+    if (sync)
+    {
+        AsyncAppend();
+    }
+    listener.completion_.Wait();
+}
+
+void FileTxLog::AsyncAppend(int executor_id,
+                            const transaction::LocalState::WriteSet *write_entry,
+                            const size_t size,
+                            const TxnEntry *txn_entry,
+                            std::atomic<bool> *is_finish,
+                            bool sync,
+                            request::CompletionListener *listener)
+{
+    assert(executor_id >= 0 &&
+           static_cast<size_t>(executor_id) < buffers_.size());
+    ExecutorBuffer &buffer = buffers_[executor_id];
+    {
+        std::lock_guard<std::mutex> lock(buffer.mutex_);
+        Serialize(buffer, write_entry, size, txn_entry);
+        if (sync)
+        {
+            buffer.waiters_.push_back({is_finish, listener});
+            return;
+        }
+    }
+    is_finish->store(true);
+    if (listener != nullptr)
+    {
+        listener->OnCompletion();
+    }
+}
+
+void FileTxLog::AsyncAppend()
+{
+    {
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        kicked_ = true;
+    }
+    flush_cv_.notify_one();
+}
+
+void FileTxLog::FlushLoop()
+{
+    while (true)
+    {
+        if (Flush())
+        {
+            // what arrived during the sync is the next batch.
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(flush_mutex_);
+        if (stopping_)
+        {
+            break;
+        }
+        flush_cv_.wait_for(lock,
+                           std::chrono::microseconds(group_commit_window_us_),
+                           [this] { return kicked_ || stopping_; });
+        kicked_ = false;
+    }
+    // the stop may have raced with the last appends.
+    Flush();
+}
+
+bool FileTxLog::Flush()
+{
+    int64_t max_commit_ts = -1;
+    std::vector<iovec> iovecs;
+    size_t bytes = 0;
+    for (size_t i = 0; i < buffers_.size(); i++)
+    {
+        ExecutorBuffer &buffer = buffers_[i];
+        std::vector<char> &data = batch_data_[i];
+        data.clear();
+        {
+            std::lock_guard<std::mutex> lock(buffer.mutex_);
+            data.swap(buffer.data_);
+            batch_waiters_.insert(batch_waiters_.end(),
+                                  buffer.waiters_.begin(),
+                                  buffer.waiters_.end());
+            buffer.waiters_.clear();
+            max_commit_ts = std::max(max_commit_ts, buffer.max_commit_ts_);
+            buffer.max_commit_ts_ = -1;
+        }
+        if (!data.empty())
+        {
+            iovecs.push_back({data.data(), data.size()});
+            bytes += data.size();
+        }
+    }
+    if (bytes == 0 && batch_waiters_.empty())
+    {
+        return false;
+    }
+
+    // writev may write less than asked, or fewer than all iovecs at once.
+    size_t first = 0;
+    while (first < iovecs.size())
+    {
+        ssize_t written = writev(fd_,
+                                 iovecs.data() + first,
+                                 std::min(iovecs.size() - first,
+                                          static_cast<size_t>(IOV_MAX)));
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            ThrowErrno("cannot write to log " + directory_);
+        }
+        while (first < iovecs.size() &&
+               static_cast<size_t>(written) >= iovecs[first].iov_len)
+        {
+            written -= iovecs[first].iov_len;
+            first++;
+        }
+        if (written > 0)
+        {
+            iovecs[first].iov_base =
+                static_cast<char *>(iovecs[first].iov_base) + written;
+            iovecs[first].iov_len -= written;
+        }
+    }
+    if (Constant::LOG_SYNC_BUFFER && fdatasync(fd_) != 0)
+    {
+        ThrowErrno("cannot sync log " + directory_);
+    }
+
+    for (const Waiter &waiter : batch_waiters_)
+    {
+        waiter.is_finish_->store(true);
+        if (waiter.listener_ != nullptr)
+        {
+            waiter.listener_->OnCompletion();
+        }
+    }
+    batch_waiters_.clear();
+
+    segment_bytes_ += bytes;
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(segment_mutex_);
+        LogSegment &current = segments_.back();
+        current.max_commit_ts_ = std::max(current.max_commit_ts_, max_commit_ts);
+        sequence = current.sequence_;
+    }
+    if (segment_bytes_ >= segment_size_)
+    {
+        close(fd_);
+        OpenSegment(sequence + 1);
+    }
+    return true;
+}
+
+void FileTxLog::OpenSegment(uint64_t sequence)
+{
+    std::string path = SegmentPath(directory_, sequence);
+    fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd_ < 0)
+    {
+        ThrowErrno("cannot open log segment " + path);
+    }
+    // before any record of the segment is acknowledged.
+    SyncDirectory(directory_);
+    segment_bytes_ = 0;
+    std::lock_guard<std::mutex> lock(segment_mutex_);
+    segments_.push_back({sequence, -1});
+}
+
+void FileTxLog::CleanBefore(int64_t timestamp)
+{
+    std::lock_guard<std::mutex> lock(segment_mutex_);
+    // the segment being written is kept whatever it holds, those of an
+    // earlier run until they have been replayed.
+    auto current = std::prev(segments_.end());
+    for (auto it = segments_.begin(); it != current;)
+    {
+        if (it->max_commit_ts_ < timestamp)
+        {
+            unlink(SegmentPath(directory_, it->sequence_).c_str());
+            it = segments_.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+void FileTxLog::MarkReplayed(int64_t max_commit_ts)
+{
+    std::lock_guard<std::mutex> lock(segment_mutex_);
+    for (LogSegment &segment : segments_)
+    {
+        if (segment.max_commit_ts_ == INT64_MAX)
+        {
+            segment.max_commit_ts_ = max_commit_ts;
+        }
+    }
+}
+
+std::vector<std::string> FileTxLog::Segments()
+{
+    std::lock_guard<std::mutex> lock(segment_mutex_);
+    std::vector<std::string> paths;
+    for (const LogSegment &segment : segments_)
+    {
+        paths.push_back(SegmentPath(directory_, segment.sequence_));
+    }
+    return paths;
+}
+
+void FileTxLog::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        if (closed_)
+        {
+            return;
+        }
+        closed_ = true;
+        stopping_ = true;
+    }
+    flush_cv_.notify_one();
+    flusher_.join();
+    close(fd_);
+    fd_ = -1;
+}
+}  // namespace txservice::txlog
@@ -0,0 +1,63 @@
+#include "txlog/log-record.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace txservice::txlog
+{
+namespace
+{
+const char kSegmentPrefix[] = "txlog.";
+}  // namespace
+
+std::string SegmentPath(const std::string &directory, uint64_t sequence)
+{
+    return directory + "/" + kSegmentPrefix + std::to_string(sequence);
+}
+
+std::vector<uint64_t> ListSegments(const std::string &directory)
+{
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        throw std::runtime_error("cannot create log directory " + directory +
+                                 ": " + std::strerror(errno));
+    }
+    std::vector<uint64_t> sequences;
+    if (DIR *dir = opendir(directory.c_str()))
+    {
+        size_t prefix_length = sizeof(kSegmentPrefix) - 1;
+        while (dirent *file = readdir(dir))
+        {
+            if (strncmp(file->d_name, kSegmentPrefix, prefix_length) == 0)
+            {
+                sequences.push_back(
+                    strtoull(file->d_name + prefix_length, nullptr, 10));
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(sequences.begin(), sequences.end());
+    return sequences;
+}
+
+void SyncDirectory(const std::string &directory)
+{
+    int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0 || fsync(fd) != 0)
+    {
+        std::string error = std::strerror(errno);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        throw std::runtime_error("cannot sync log directory " + directory +
+                                 ": " + error);
+    }
+    close(fd);
+}
+}  // namespace txservice::txlog
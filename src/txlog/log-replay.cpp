@@ -0,0 +1,422 @@
+#include "txlog/log-replay.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "transaction/local-state.h"
+#include "txlog/log-record.h"
+#include "utility/parallel-for.h"
+
+namespace txservice::txlog
+{
+namespace
+{
+// drives handler until done() holds; throws once that takes longer than
+// the recovery budget, the request being lost.
+template <typename Done>
+void Drive(request::Handler &handler, Done done)
+{
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::microseconds(Constant::RECOVERY_WAIT_TIMEOUT_US);
+    while (!done())
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            throw std::runtime_error(
+                "handler request of recovery did not finish");
+        }
+        handler.SendBatch();
+        std::this_thread::yield();
+    }
+}
+
+template <typename T>
+bool Await(request::Handler &handler, request::HandlerResult<T> &result)
+{
+    Drive(handler, [&result] { return result.IsFinished(); });
+    return !result.IsError();
+}
+
+// sends a request with send(result) until it succeeds, at most
+// RECOVERY_RETRY_COUNT times.
+template <typename Send>
+bool Retry(request::Handler &handler, Send send)
+{
+    for (int attempt = 0; attempt < Constant::RECOVERY_RETRY_COUNT; attempt++)
+    {
+        request::HandlerResult<Void> result;
+        result.Reset();
+        send(result);
+        if (Await(handler, result))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CommitVersion(request::Handler &handler,
+                   const TableName &table_name,
+                   const Key &key,
+                   int64_t version,
+                   Record *record,
+                   int64_t txn_id,
+                   int64_t commit_ts)
+{
+    request::HandlerResult<Void> result;
+    result.Reset();
+    // finished once ref_cnt drops to 0, as in
+    // PostProcessingCommitEntryAfterCommit.
+    result.ref_cnt = 2;
+    handler.CommitVersion(table_name,
+                          key,
+                          version,
+                          txn_id,
+                          commit_ts,
+                          VersionEntry::kMaxTimeStamp,
+                          VersionEntry::kEmptyTxId,
+                          nullptr,
+                          result,
+                          record);
+    Drive(handler,
+          [&result] { return result.ref_cnt == 0 || result.IsError(); });
+    return !result.IsError();
+}
+}  // namespace
+
+struct LogReplay::Version
+{
+    const TableName *table_name_;
+    Key::Pointer key_;
+    Record::Pointer record_;
+    int64_t version_;
+    bool is_deleted_;
+    int64_t txn_id_;
+    int64_t commit_ts_;
+};
+
+struct LogReplay::Txn
+{
+    int64_t txn_id_;
+    int64_t commit_ts_;
+};
+
+/// what one segment holds, versions bucketed by key.
+struct LogReplay::Scan
+{
+    std::vector<std::vector<Version>> buckets_;
+    std::vector<Txn> txns_;
+    size_t records_ = 0;
+    size_t skipped_versions_ = 0;
+    bool torn_ = false;
+};
+
+LogReplay::LogReplay(const std::string &directory,
+                     VersionDb *version_db,
+                     size_t thread_count)
+    : directory_(directory),
+      version_db_(version_db),
+      thread_count_(std::max<size_t>(1, thread_count))
+{
+}
+
+void LogReplay::AddTable(const TableName &table_name,
+                         const Key &key,
+                         const Record &record)
+{
+    tables_[table_name] = Schema{key.Copy(), record.Copy()};
+}
+
+LogReplay::Stats LogReplay::Run()
+{
+    Stats stats;
+    std::vector<uint64_t> sequences = ListSegments(directory_);
+    size_t bucket_count =
+        thread_count_ * Constant::LOG_REPLAY_BUCKETS_PER_THREAD;
+
+    std::vector<Scan> scans(sequences.size());
+    ParallelFor(thread_count_, sequences.size(), [&](size_t i) {
+        scans[i].buckets_.resize(bucket_count);
+        ScanSegment(sequences[i], scans[i]);
+    });
+
+    std::vector<Txn> txns;
+    for (Scan &scan : scans)
+    {
+        stats.segments_++;
+        stats.torn_segments_ += scan.torn_ ? 1 : 0;
+        stats.records_ += scan.records_;
+        stats.skipped_versions_ += scan.skipped_versions_;
+        txns.insert(txns.end(), scan.txns_.begin(), scan.txns_.end());
+    }
+    for (const Txn &txn : txns)
+    {
+        stats.max_commit_ts_ = std::max(stats.max_commit_ts_, txn.commit_ts_);
+    }
+
+    // the txn statuses first, so that a reader meeting a version still dirty
+    // finds its txn committed.
+    size_t chunk_count = std::min(txns.size(), thread_count_);
+    ParallelFor(thread_count_, chunk_count, [&](size_t chunk) {
+        request::Handler::Pointer handler = version_db_->MakeHandler();
+        for (size_t i = chunk; i < txns.size(); i += chunk_count)
+        {
+            if (!RedoTxnStatus(*handler, txns[i].txn_id_, kCommitted))
+            {
+                throw std::runtime_error("cannot redo the status of txn " +
+                                         std::to_string(txns[i].txn_id_));
+            }
+        }
+    });
+
+    std::atomic<size_t> versions{0};
+    std::atomic<size_t> skipped_versions{0};
+    ParallelFor(thread_count_, bucket_count, [&](size_t b) {
+        std::vector<Version> bucket;
+        for (Scan &scan : scans)
+        {
+            std::move(scan.buckets_[b].begin(),
+                      scan.buckets_[b].end(),
+                      std::back_inserter(bucket));
+        }
+        // segments are not ordered by commit timestamp across executors.
+        std::sort(bucket.begin(),
+                  bucket.end(),
+                  [](const Version &lhs, const Version &rhs) {
+                      return lhs.commit_ts_ < rhs.commit_ts_;
+                  });
+        request::Handler::Pointer handler = version_db_->MakeHandler();
+        for (Version &version : bucket)
+        {
+            bool redone = RedoVersion(*handler,
+                                      *version.table_name_,
+                                      *version.key_,
+                                      version.version_,
+                                      version.is_deleted_,
+                                      version.record_.get(),
+                                      version.txn_id_,
+                                      version.commit_ts_);
+            (redone ? versions : skipped_versions)++;
+        }
+    });
+    stats.versions_ = versions;
+    stats.skipped_versions_ += skipped_versions;
+    return stats;
+}
+
+void LogReplay::ScanSegment(uint64_t sequence, Scan &scan)
+{
+    std::string path = SegmentPath(directory_, sequence);
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        throw std::runtime_error("cannot open log segment " + path + ": " +
+                                 std::strerror(errno));
+    }
+    size_t size = st.st_size;
+    if (size == 0)
+    {
+        close(fd);
+        return;
+    }
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        throw std::runtime_error("cannot map log segment " + path + ": " +
+                                 std::strerror(errno));
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    const char *data = static_cast<const char *>(mapped);
+
+    size_t offset = 0;
+    while (offset < size)
+    {
+        LogRecordHeader header;
+        if (size - offset < sizeof(header))
+        {
+            scan.torn_ = true;
+            break;
+        }
+        memcpy(&header, data + offset, sizeof(header));
+        const char *body = data + offset + sizeof(header);
+        if (header.length_ > size - offset - sizeof(header) ||
+            LogRecordHeader::Checksum(body, header.length_) !=
+                header.checksum_)
+        {
+            scan.torn_ = true;
+            break;
+        }
+        offset += sizeof(header) + header.length_;
+        scan.records_++;
+
+        size_t at = 0;
+        Txn txn;
+        memcpy(&txn.txn_id_, body + at, Constant::INT64_T_LENGTH);
+        at += Constant::INT64_T_LENGTH;
+        memcpy(&txn.commit_ts_, body + at, Constant::INT64_T_LENGTH);
+        at += Constant::INT64_T_LENGTH;
+        int entry_count;
+        memcpy(&entry_count, body + at, Constant::INT_LENGTH);
+        at += Constant::INT_LENGTH;
+        scan.txns_.push_back(txn);
+
+        for (int i = 0; i < entry_count; i++)
+        {
+            int name_size;
+            memcpy(&name_size, body + at, Constant::INT_LENGTH);
+            at += Constant::INT_LENGTH;
+            auto table = tables_.find(TableName(body + at, name_size));
+            at += name_size;
+            if (table == tables_.end())
+            {
+                // the layout of the rest of the record is not known.
+                scan.skipped_versions_ += entry_count - i;
+                break;
+            }
+            const Schema &schema = table->second;
+
+            Version version;
+            version.table_name_ = &table->first;
+            version.key_ = schema.key_->Copy();
+            version.key_->DeserializeFromBuffer(body, at);
+            memcpy(&version.version_, body + at, Constant::INT64_T_LENGTH);
+            at += Constant::INT64_T_LENGTH;
+            memcpy(&version.is_deleted_, body + at, Constant::BOOL_LENGTH);
+            at += Constant::BOOL_LENGTH;
+            if (!version.is_deleted_)
+            {
+                version.record_ = schema.record_->Copy();
+                version.record_->DeserializeFromBuffer(body, at);
+            }
+            version.txn_id_ = txn.txn_id_;
+            version.commit_ts_ = txn.commit_ts_;
+
+            size_t bucket = transaction::LocalState::SetKeyIndex::Hash(
+                                table->first, *version.key_) %
+                            scan.buckets_.size();
+            scan.buckets_[bucket].push_back(std::move(version));
+        }
+    }
+    munmap(mapped, size);
+}
+
+bool LogReplay::RedoVersion(request::Handler &handler,
+                            const TableName &table_name,
+                            const Key &key,
+                            int64_t version,
+                            bool is_deleted,
+                            Record *record,
+                            int64_t txn_id,
+                            int64_t commit_ts)
+{
+    if (CommitVersion(
+            handler, table_name, key, version, record, txn_id, commit_ts))
+    {
+        return true;
+    }
+
+    // the store lost the version: put it back behind a committed
+    // predecessor, which stands in for the versions before the log if the
+    // key is not known either.
+    VersionEntry predecessor(version - 1,
+                             VersionEntry::kEmptyTxId,
+                             0,
+                             VersionEntry::kMaxTimeStamp,
+                             0,
+                             true,
+                             nullptr,
+                             nullptr);
+    request::HandlerResult<bool> init_result;
+    init_result.Reset();
+    handler.InitVersionList(table_name, key, predecessor, init_result);
+    if (!Await(handler, init_result))
+    {
+        return false;
+    }
+
+    VersionEntry dirty(version,
+                       txn_id,
+                       VersionEntry::kDefaultBeginTs,
+                       VersionEntry::kDefaultEndTs,
+                       0,
+                       is_deleted,
+                       nullptr,
+                       record);
+    request::HandlerResult<int64_t> upload_result;
+    upload_result.Reset();
+    handler.UploadVersion(table_name, key, dirty, nullptr, upload_result);
+    if (!Await(handler, upload_result))
+    {
+        return false;
+    }
+    return CommitVersion(
+        handler, table_name, key, version, record, txn_id, commit_ts);
+}
+
+bool LogReplay::RestoreVersion(request::Handler &handler,
+                               const TableName &table_name,
+                               const Key &key,
+                               int64_t version,
+                               bool is_deleted,
+                               Record *record,
+                               int64_t commit_ts)
+{
+    VersionEntry committed(version,
+                           VersionEntry::kEmptyTxId,
+                           commit_ts,
+                           VersionEntry::kMaxTimeStamp,
+                           0,
+                           is_deleted,
+                           nullptr,
+                           record);
+    request::HandlerResult<bool> result;
+    result.Reset();
+    handler.InitVersionList(table_name, key, committed, result);
+    return Await(handler, result) && result.result_;
+}
+
+bool LogReplay::RedoTxnStatus(request::Handler &handler,
+                              int64_t txn_id,
+                              TxnStatus status)
+{
+    return Retry(handler, [&](request::HandlerResult<Void> &result) {
+        handler.UpdateTxnStatus(txn_id, status, nullptr, result);
+    });
+}
+
+bool LogReplay::RedoDeleteVersion(request::Handler &handler,
+                                  const TableName &table_name,
+                                  const Key &key,
+                                  int64_t version,
+                                  EntryExtension *extension)
+{
+    return Retry(handler, [&](request::HandlerResult<Void> &result) {
+        handler.DeleteVersion(table_name, key, version, extension, result);
+    });
+}
+
+bool LogReplay::RedoReleaseReadCounter(request::Handler &handler,
+                                       const TableName &table_name,
+                                       const Key &key,
+                                       int64_t version,
+                                       EntryExtension *extension)
+{
+    return Retry(handler, [&](request::HandlerResult<Void> &result) {
+        handler.ReleaseReadCounter(table_name, key, version, extension, result);
+    });
+}
+}  // namespace txservice::txlog
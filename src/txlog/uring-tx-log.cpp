@@ -0,0 +1,829 @@
+#include "txlog/uring-tx-log.h"
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define TXSERVICE_HAS_IO_URING 1
+#endif
+
+namespace txservice::txlog
+{
+namespace
+{
+struct Waiter
+{
+    std::atomic<bool> *is_finish_;
+    request::CompletionListener *listener_;
+};
+
+void ThrowErrno(const std::string &what, int error = errno)
+{
+    throw std::runtime_error(what + ": " + std::strerror(error));
+}
+
+#ifdef TXSERVICE_HAS_IO_URING
+/**
+ * Minimal io_uring over the raw system calls: one submitter, the executor
+ * thread, and completions read straight from the mapped ring.
+ */
+class Ring
+{
+public:
+    ~Ring()
+    {
+        if (sqes_ != nullptr)
+        {
+            munmap(sqes_, sqes_size_);
+        }
+        if (cq_ring_ != nullptr && cq_ring_ != sq_ring_)
+        {
+            munmap(cq_ring_, cq_ring_size_);
+        }
+        if (sq_ring_ != nullptr)
+        {
+            munmap(sq_ring_, sq_ring_size_);
+        }
+        if (fd_ >= 0)
+        {
+            close(fd_);
+        }
+    }
+
+    bool Init(unsigned entries)
+    {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        fd_ = syscall(__NR_io_uring_setup, entries, &params);
+        if (fd_ < 0)
+        {
+            return false;
+        }
+        sq_ring_size_ =
+            params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ =
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap)
+        {
+            sq_ring_size_ = cq_ring_size_ =
+                std::max(sq_ring_size_, cq_ring_size_);
+        }
+        sq_ring_ = Map(sq_ring_size_, IORING_OFF_SQ_RING);
+        cq_ring_ =
+            single_mmap ? sq_ring_ : Map(cq_ring_size_, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe *>(Map(sqes_size_, IORING_OFF_SQES));
+        if (sq_ring_ == nullptr || cq_ring_ == nullptr || sqes_ == nullptr)
+        {
+            return false;
+        }
+
+        char *sq = static_cast<char *>(sq_ring_);
+        sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        sq_entries_ = params.sq_entries;
+        char *cq = static_cast<char *>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        local_tail_ = *sq_tail_;
+        return true;
+    }
+
+    bool RegisterBuffers(const iovec *iovecs, unsigned count)
+    {
+        return syscall(__NR_io_uring_register,
+                       fd_,
+                       IORING_REGISTER_BUFFERS,
+                       iovecs,
+                       count) == 0;
+    }
+
+    /// a zeroed submission entry, nullptr if the ring is full.
+    io_uring_sqe *NextSqe()
+    {
+        unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        if (local_tail_ - head >= sq_entries_)
+        {
+            return nullptr;
+        }
+        unsigned index = local_tail_ & sq_mask_;
+        io_uring_sqe *sqe = &sqes_[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sq_array_[index] = index;
+        local_tail_++;
+        return sqe;
+    }
+
+    void Submit()
+    {
+        unsigned to_submit = local_tail_ - *sq_tail_;
+        __atomic_store_n(sq_tail_, local_tail_, __ATOMIC_RELEASE);
+        while (to_submit > 0)
+        {
+            int submitted =
+                syscall(__NR_io_uring_enter, fd_, to_submit, 0, 0, nullptr, 0);
+            if (submitted < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                {
+                    continue;
+                }
+                ThrowErrno("io_uring_enter");
+            }
+            to_submit -= submitted;
+        }
+    }
+
+    /// blocks until at least one completion is there to be read.
+    void WaitCompletion()
+    {
+        while (syscall(__NR_io_uring_enter,
+                       fd_,
+                       0,
+                       1,
+                       IORING_ENTER_GETEVENTS,
+                       nullptr,
+                       0) < 0)
+        {
+            if (errno != EINTR)
+            {
+                ThrowErrno("io_uring_enter");
+            }
+        }
+    }
+
+    bool PopCompletion(io_uring_cqe &cqe)
+    {
+        unsigned head = *cq_head_;
+        if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE))
+        {
+            return false;
+        }
+        cqe = cqes_[head & cq_mask_];
+        __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+private:
+    void *Map(size_t size, off_t offset)
+    {
+        void *address = mmap(nullptr,
+                             size,
+                             PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE,
+                             fd_,
+                             offset);
+        return address == MAP_FAILED ? nullptr : address;
+    }
+
+    int fd_ = -1;
+    void *sq_ring_ = nullptr;
+    void *cq_ring_ = nullptr;
+    io_uring_sqe *sqes_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    size_t cq_ring_size_ = 0;
+    size_t sqes_size_ = 0;
+    unsigned *sq_head_;
+    unsigned *sq_tail_;
+    unsigned *sq_array_;
+    unsigned sq_mask_;
+    unsigned sq_entries_;
+    unsigned local_tail_;
+    unsigned *cq_head_;
+    unsigned *cq_tail_;
+    unsigned cq_mask_;
+    io_uring_cqe *cqes_;
+};
+#else
+// no io_uring at compile time, the log always takes the writer thread.
+class Ring
+{
+public:
+    bool Init(unsigned)
+    {
+        return false;
+    }
+};
+#endif
+}  // namespace
+
+/**
+ * The log of one executor. Buffers cycle through free, filling (one at a
+ * time) and in flight; everything but the in-flight state is only touched by
+ * the executor thread.
+ */
+struct UringTxLog::Writer
+{
+    static constexpr size_t kBufferSize = Constant::TX_LOG_BUFFER_SIZE;
+    static constexpr size_t kBufferCount = Constant::TX_LOG_URING_BUFFER_COUNT;
+
+    struct Buffer
+    {
+        bool IsEmpty() const
+        {
+            return size_ == 0 && large_.empty();
+        }
+
+        bool Fits(size_t length) const
+        {
+            return large_.empty() && size_ + length <= kBufferSize;
+        }
+
+        char *data_;
+        size_t size_ = 0;
+        // a record larger than a whole buffer, written on its own.
+        std::vector<char> large_;
+        std::vector<Waiter> waiters_;
+        int64_t max_commit_ts_ = -1;
+        // where the submitted buffer goes
+        int fd_;
+        uint64_t sequence_;
+        off_t offset_;
+        iovec iovec_;
+        // io_uring: completions outstanding; writer thread: written and synced
+        int pending_ = 0;
+        std::atomic<bool> done_ = false;
+    };
+
+    Writer(UringTxLog &log) : log_(log), buffers_(kBufferCount), fd_(-1)
+    {
+        arena_ = static_cast<char *>(
+            aligned_alloc(4096, kBufferCount * kBufferSize));
+        for (size_t i = 0; i < kBufferCount; i++)
+        {
+            buffers_[i].data_ = arena_ + i * kBufferSize;
+        }
+        filling_ = 0;
+        for (size_t i = kBufferCount - 1; i > 0; i--)
+        {
+            free_.push_back(i);
+        }
+    }
+
+    ~Writer()
+    {
+        if (fd_ >= 0)
+        {
+            close(fd_);
+        }
+        free(arena_);
+    }
+
+    bool InitRing()
+    {
+        // a write and its fsync per buffer
+        if (!ring_.Init(2 * kBufferCount))
+        {
+            return false;
+        }
+#ifdef TXSERVICE_HAS_IO_URING
+        std::vector<iovec> iovecs(kBufferCount);
+        for (size_t i = 0; i < kBufferCount; i++)
+        {
+            iovecs[i] = {buffers_[i].data_, kBufferSize};
+        }
+        // may be refused over RLIMIT_MEMLOCK, plain writes do then.
+        fixed_ = ring_.RegisterBuffers(iovecs.data(), kBufferCount);
+#endif
+        return true;
+    }
+
+    void OpenSegment()
+    {
+        uint64_t sequence = log_.NextSequence();
+        std::string path = SegmentPath(log_.directory_, sequence);
+        // sequences are never reused, an existing file is not ours.
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd < 0)
+        {
+            ThrowErrno("cannot open log segment " + path);
+        }
+        // before the first buffer of the segment is acknowledged.
+        SyncDirectory(log_.directory_);
+        fd_ = fd;
+        sequence_ = sequence;
+        offset_ = 0;
+        std::lock_guard<std::mutex> lock(segment_mutex_);
+        segments_.push_back({sequence, -1});
+        UpdateOldestOpen();
+    }
+
+    /// closes fd, a segment rotated out, once no buffer in flight writes it.
+    void CloseIfUnused(int fd)
+    {
+        for (size_t index : in_flight_)
+        {
+            if (buffers_[index].fd_ == fd)
+            {
+                return;
+            }
+        }
+        close(fd);
+    }
+
+    // called with segment_mutex_ held.
+    void UpdateOldestOpen()
+    {
+        oldest_open_ = in_flight_.empty()
+                           ? sequence_
+                           : buffers_[in_flight_.front()].sequence_;
+    }
+
+    void Append(const transaction::LocalState::WriteSet *write_entry,
+                size_t size,
+                const TxnEntry *txn_entry,
+                std::atomic<bool> *is_finish,
+                bool sync,
+                request::CompletionListener *listener)
+    {
+        size_t length = LogRecord::Length(write_entry, size, txn_entry);
+        if (!buffers_[filling_].IsEmpty() && !buffers_[filling_].Fits(length))
+        {
+            SubmitFilling(true);
+        }
+        Buffer &buffer = buffers_[filling_];
+        char *record;
+        if (length > kBufferSize)
+        {
+            buffer.large_.resize(length);
+            record = buffer.large_.data();
+        }
+        else
+        {
+            record = buffer.data_ + buffer.size_;
+            buffer.size_ += length;
+        }
+        LogRecord::Serialize(record, length, write_entry, size, txn_entry);
+        buffer.max_commit_ts_ =
+            std::max(buffer.max_commit_ts_, txn_entry->commit_ts);
+        if (sync)
+        {
+            buffer.waiters_.push_back({is_finish, listener});
+        }
+        else
+        {
+            Finish({is_finish, listener});
+        }
+    }
+
+    void Poll()
+    {
+        Harvest();
+        if (static_cast<size_t>(offset_) >= log_.segment_size_)
+        {
+            // new buffers go to the next segment right away; the old one is
+            // closed by its last buffer in flight.
+            int fd = fd_;
+            OpenSegment();
+            CloseIfUnused(fd);
+        }
+        if (!buffers_[filling_].IsEmpty())
+        {
+            SubmitFilling(false);
+        }
+    }
+
+    /// submits the filling buffer and takes a free one, waiting for one if
+    /// wait is set; returns whether it submitted.
+    bool SubmitFilling(bool wait)
+    {
+        while (free_.empty())
+        {
+            if (!wait)
+            {
+                return false;
+            }
+            WaitCompletion();
+            Harvest();
+        }
+        Submit(filling_);
+        filling_ = free_.back();
+        free_.pop_back();
+        return true;
+    }
+
+    void Submit(size_t index)
+    {
+        Buffer &buffer = buffers_[index];
+        size_t length =
+            buffer.large_.empty() ? buffer.size_ : buffer.large_.size();
+        buffer.fd_ = fd_;
+        buffer.sequence_ = sequence_;
+        buffer.offset_ = offset_;
+        buffer.iovec_ = {
+            buffer.large_.empty() ? buffer.data_ : buffer.large_.data(),
+            length};
+        offset_ += length;
+        in_flight_.push_back(index);
+
+        if (!log_.use_uring_)
+        {
+            buffer.done_.store(false, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(log_.writer_mutex_);
+                log_.writes_.emplace_back(this, index);
+            }
+            log_.writer_cv_.notify_one();
+            return;
+        }
+#ifdef TXSERVICE_HAS_IO_URING
+        // the ring has room for a write and an fsync per buffer.
+        io_uring_sqe *write = ring_.NextSqe();
+        io_uring_sqe *sync = ring_.NextSqe();
+        assert(write != nullptr && sync != nullptr);
+        write->fd = buffer.fd_;
+        write->off = buffer.offset_;
+        if (fixed_ && buffer.large_.empty())
+        {
+            write->opcode = IORING_OP_WRITE_FIXED;
+            write->addr = reinterpret_cast<uint64_t>(buffer.data_);
+            write->len = length;
+            write->buf_index = index;
+        }
+        else
+        {
+            write->opcode = IORING_OP_WRITEV;
+            write->addr = reinterpret_cast<uint64_t>(&buffer.iovec_);
+            write->len = 1;
+        }
+        // drained: starts only once the previous buffer is synced, so the
+        // file never has a hole in front of a synced record.
+        write->flags = IOSQE_IO_DRAIN | IOSQE_IO_LINK;
+        write->user_data = index << 1;
+        sync->opcode = IORING_OP_FSYNC;
+        sync->fd = buffer.fd_;
+        sync->fsync_flags = IORING_FSYNC_DATASYNC;
+        sync->user_data = (index << 1) | 1;
+        buffer.pending_ = 2;
+        ring_.Submit();
+#endif
+    }
+
+    void WaitCompletion()
+    {
+#ifdef TXSERVICE_HAS_IO_URING
+        if (log_.use_uring_)
+        {
+            ring_.WaitCompletion();
+            return;
+        }
+#endif
+        std::this_thread::yield();
+    }
+
+    /// finishes the buffers done, oldest first.
+    void Harvest()
+    {
+#ifdef TXSERVICE_HAS_IO_URING
+        io_uring_cqe cqe;
+        while (log_.use_uring_ && ring_.PopCompletion(cqe))
+        {
+            Buffer &buffer = buffers_[cqe.user_data >> 1];
+            bool is_sync = cqe.user_data & 1;
+            // a short write cancels the linked fsync, and is as fatal as a
+            // failed one.
+            if (cqe.res < 0 ||
+                (!is_sync && static_cast<size_t>(cqe.res) != buffer.iovec_.iov_len))
+            {
+                ThrowErrno("cannot write to log " + log_.directory_,
+                           cqe.res < 0 ? -cqe.res : EIO);
+            }
+            buffer.pending_--;
+        }
+#endif
+        while (!in_flight_.empty() && IsDone(buffers_[in_flight_.front()]))
+        {
+            size_t index = in_flight_.front();
+            in_flight_.pop_front();
+            Complete(index);
+        }
+    }
+
+    bool IsDone(const Buffer &buffer) const
+    {
+        return log_.use_uring_ ? buffer.pending_ == 0
+                               : buffer.done_.load(std::memory_order_acquire);
+    }
+
+    void Complete(size_t index)
+    {
+        Buffer &buffer = buffers_[index];
+        for (const Waiter &waiter : buffer.waiters_)
+        {
+            Finish(waiter);
+        }
+        {
+            std::lock_guard<std::mutex> lock(segment_mutex_);
+            for (auto it = segments_.rbegin(); it != segments_.rend(); it++)
+            {
+                if (it->sequence_ == buffer.sequence_)
+                {
+                    it->max_commit_ts_ =
+                        std::max(it->max_commit_ts_, buffer.max_commit_ts_);
+                    break;
+                }
+            }
+            UpdateOldestOpen();
+        }
+        if (buffer.fd_ != fd_)
+        {
+            CloseIfUnused(buffer.fd_);
+        }
+        buffer.waiters_.clear();
+        buffer.size_ = 0;
+        std::vector<char>().swap(buffer.large_);
+        buffer.max_commit_ts_ = -1;
+        free_.push_back(index);
+    }
+
+    static void Finish(const Waiter &waiter)
+    {
+        waiter.is_finish_->store(true);
+        if (waiter.listener_ != nullptr)
+        {
+            waiter.listener_->OnCompletion();
+        }
+    }
+
+    /// submits what is left and waits until all of it is durable.
+    void Drain()
+    {
+        if (!buffers_[filling_].IsEmpty())
+        {
+            SubmitFilling(true);
+        }
+        Harvest();
+        while (!in_flight_.empty())
+        {
+            WaitCompletion();
+            Harvest();
+        }
+    }
+
+    UringTxLog &log_;
+    char *arena_;
+    std::vector<Buffer> buffers_;
+    size_t filling_;
+    std::vector<size_t> free_;
+    std::deque<size_t> in_flight_;
+    Ring ring_;
+    bool fixed_ = false;
+    int fd_;
+    uint64_t sequence_ = 0;
+    off_t offset_ = 0;
+
+    // the executor's segments, oldest first; those from oldest_open_ on are
+    // still being written.
+    std::mutex segment_mutex_;
+    std::deque<LogSegment> segments_;
+    uint64_t oldest_open_ = 0;
+};
+
+UringTxLog::UringTxLog(const std::string &directory,
+                       int executor_count,
+                       size_t segment_size,
+                       bool use_uring)
+    : directory_(directory),
+      segment_size_(segment_size),
+      use_uring_(use_uring),
+      next_sequence_(0),
+      stopping_(false),
+      closed_(false)
+{
+    // never append to segments of an earlier run, they are left for replay.
+    for (uint64_t sequence : ListSegments(directory_))
+    {
+        old_segments_.push_back({sequence, INT64_MAX});
+        next_sequence_ = sequence + 1;
+    }
+    for (int i = 0; i < executor_count; i++)
+    {
+        writers_.push_back(std::make_unique<Writer>(*this));
+    }
+    for (auto &writer : writers_)
+    {
+        if (use_uring_ && !writer->InitRing())
+        {
+            // ENOSYS on old kernels, EPERM where seccomp forbids it.
+            use_uring_ = false;
+        }
+    }
+    for (auto &writer : writers_)
+    {
+        writer->OpenSegment();
+    }
+    if (!use_uring_)
+    {
+        writer_thread_ = std::thread(&UringTxLog::WriterLoop, this);
+    }
+}
+
+UringTxLog::~UringTxLog()
+{
+    Close();
+}
+
+uint64_t UringTxLog::NextSequence()
+{
+    std::lock_guard<std::mutex> lock(sequence_mutex_);
+    return next_sequence_++;
+}
+
+void UringTxLog::Append(int executor_id,
+                        const transaction::LocalState::WriteSet *write_entry,
+                        const size_t size,
+                        const TxnEntry *txn_entry,
+                        bool sync)
+{
+    std::atomic<bool> is_finish = false;
+    AsyncAppend(executor_id, write_entry, size, txn_entry, &is_finish, sync);
+    Writer &writer = *writers_[executor_id];
+    Poll(executor_id);
+    while (!is_finish.load())
+    {
+        writer.WaitCompletion();
+        Poll(executor_id);
+    }
+}
+
+void UringTxLog::AsyncAppend(
+    int executor_id,
+    const transaction::LocalState::WriteSet *write_entry,
+    const size_t size,
+    const TxnEntry *txn_entry,
+    std::atomic<bool> *is_finish,
+    bool sync,
+    request::CompletionListener *listener)
+{
+    assert(executor_id >= 0 &&
+           static_cast<size_t>(executor_id) < writers_.size());
+    writers_[executor_id]->Append(
+        write_entry, size, txn_entry, is_finish, sync, listener);
+}
+
+void UringTxLog::Poll(int executor_id)
+{
+    writers_[executor_id]->Poll();
+}
+
+void UringTxLog::WriterLoop()
+{
+    std::vector<std::pair<Writer *, size_t>> writes;
+    std::vector<int> fds;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(writer_mutex_);
+            writer_cv_.wait(lock,
+                            [this] { return stopping_ || !writes_.empty(); });
+            if (writes_.empty())
+            {
+                break;
+            }
+            writes.swap(writes_);
+        }
+
+        // one pass of writes, then one sync per file touched
+        fds.clear();
+        for (auto &[writer, index] : writes)
+        {
+            Writer::Buffer &buffer = writer->buffers_[index];
+            iovec iov = buffer.iovec_;
+            off_t offset = buffer.offset_;
+            while (iov.iov_len > 0)
+            {
+                ssize_t written = pwritev(buffer.fd_, &iov, 1, offset);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    ThrowErrno("cannot write to log " + directory_);
+                }
+                iov.iov_base = static_cast<char *>(iov.iov_base) + written;
+                iov.iov_len -= written;
+                offset += written;
+            }
+            if (std::find(fds.begin(), fds.end(), buffer.fd_) == fds.end())
+            {
+                fds.push_back(buffer.fd_);
+            }
+        }
+        for (int fd : fds)
+        {
+            if (fdatasync(fd) != 0)
+            {
+                ThrowErrno("cannot sync log " + directory_);
+            }
+        }
+        for (auto &[writer, index] : writes)
+        {
+            writer->buffers_[index].done_.store(true, std::memory_order_release);
+        }
+        writes.clear();
+    }
+}
+
+void UringTxLog::CleanBefore(int64_t timestamp)
+{
+    // segments from open on are kept whatever they hold.
+    auto clean = [&](auto &segments, uint64_t open) {
+        for (auto it = segments.begin();
+             it != segments.end() && it->sequence_ < open;)
+        {
+            if (it->max_commit_ts_ < timestamp)
+            {
+                unlink(SegmentPath(directory_, it->sequence_).c_str());
+                it = segments.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    };
+    {
+        std::lock_guard<std::mutex> lock(sequence_mutex_);
+        clean(old_segments_, UINT64_MAX);
+    }
+    for (auto &writer : writers_)
+    {
+        std::lock_guard<std::mutex> lock(writer->segment_mutex_);
+        clean(writer->segments_, writer->oldest_open_);
+    }
+}
+
+void UringTxLog::MarkReplayed(int64_t max_commit_ts)
+{
+    std::lock_guard<std::mutex> lock(sequence_mutex_);
+    for (LogSegment &segment : old_segments_)
+    {
+        if (segment.max_commit_ts_ == INT64_MAX)
+        {
+            segment.max_commit_ts_ = max_commit_ts;
+        }
+    }
+}
+
+std::vector<std::string> UringTxLog::Segments()
+{
+    std::vector<uint64_t> sequences;
+    {
+        std::lock_guard<std::mutex> lock(sequence_mutex_);
+        for (const LogSegment &segment : old_segments_)
+        {
+            sequences.push_back(segment.sequence_);
+        }
+    }
+    for (auto &writer : writers_)
+    {
+        std::lock_guard<std::mutex> lock(writer->segment_mutex_);
+        for (const LogSegment &segment : writer->segments_)
+        {
+            sequences.push_back(segment.sequence_);
+        }
+    }
+    std::sort(sequences.begin(), sequences.end());
+    std::vector<std::string> paths;
+    for (uint64_t sequence : sequences)
+    {
+        paths.push_back(SegmentPath(directory_, sequence));
+    }
+    return paths;
+}
+
+void UringTxLog::Close()
+{
+    if (closed_)
+    {
+        return;
+    }
+    closed_ = true;
+    for (auto &writer : writers_)
+    {
+        writer->Drain();
+    }
+    if (writer_thread_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(writer_mutex_);
+            stopping_ = true;
+        }
+        writer_cv_.notify_one();
+        writer_thread_.join();
+    }
+}
+}  // namespace txservice::txlog
@@ -0,0 +1,167 @@
+// Round trip of a store through checkpoints, a truncated log and a crash.
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include "test-fixture.h"
+#include "txcheckpoint/checkpoint-coordinator.h"
+#include "txcheckpoint/checkpoint-restore.h"
+#include "txcheckpoint/snapshot-file.h"
+#include "txlog/file-tx-log.h"
+#include "txlog/log-replay.h"
+
+using namespace txservice;
+using namespace txservice::test;
+
+namespace
+{
+const std::string kDirectory = "checkpoint-test.dir";
+const std::string kLogDirectory = kDirectory + "/log";
+const std::string kCheckpointDirectory = kDirectory + "/checkpoint";
+
+void DeleteKey(Fixture &fixture, int64_t key)
+{
+    fixture.Submit(Begin);
+    fixture.Submit(Read, key);
+    fixture.Submit(Delete, key);
+    fixture.Submit(Commit);
+    fixture.executor_->Run();
+    fixture.session_++;
+}
+
+void RestoreAfterCrash()
+{
+    std::system(("rm -rf " + kDirectory + " && mkdir " + kDirectory).c_str());
+    {
+        txlog::FileTxLog log(kLogDirectory, 1, 200, 512);
+        Fixture fixture;
+        auto time = std::make_unique<StepTimeProvider>();
+        StepTimeProvider *clock = time.get();
+        fixture.executor_ = std::make_unique<RuntimeTransactionExecutor>(
+            0,
+            16,
+            fixture.id_factory_.GetTxnIDGenerator(1),
+            fixture.db_.MakeHandler(),
+            std::move(time),
+            &log,
+            1 << 10);
+        txckpt::ChangeFeed feed(fixture.db_.GetPartitionCount());
+        fixture.executor_->SetChangeFeed(&feed);
+        txckpt::CheckpointCoordinator coordinator(
+            kCheckpointDirectory, &fixture.db_, &log, 2, 16, &feed);
+        coordinator.AddTable(
+            kTable, fixture.db_.GetPartitionCount(), IntRecord(0));
+
+        for (int64_t key = 0; key < 50; key++)
+        {
+            fixture.Write(Insert, key, key * 10);
+        }
+        DeleteKey(fixture, 5);
+        size_t segments = log.Segments().size();
+        coordinator.Checkpoint(clock->GetTime());
+        // the log before the checkpoint is gone.
+        CHECK(log.Segments().size() < segments);
+
+        fixture.Write(Upsert, 7, 77);
+        DeleteKey(fixture, 8);
+        fixture.Write(Insert, 60, 600);
+        coordinator.IncrementalCheckpoint(clock->GetTime());
+
+        // only in the log.
+        fixture.Write(Upsert, 9, 99);
+        fixture.Write(Upsert, 7, 78);
+        fixture.Write(Insert, 61, 610);
+        log.Close();
+    }
+
+    // a store that lost everything in the crash.
+    Fixture restored;
+    txckpt::CheckpointRestore restore(kCheckpointDirectory, &restored.db_, 2);
+    restore.AddTable(kTable,
+                     restored.db_.GetPartitionCount(),
+                     IntKey(),
+                     IntRecord(0));
+    txckpt::CheckpointRestore::Stats stats = restore.Run();
+    CHECK(stats.checkpoint_ts_ > 0);
+    // every key written before the incremental checkpoint, 5 and 8 as
+    // tombstones.
+    CHECK(stats.keys_ == 51);
+    txlog::LogReplay replay(kLogDirectory, &restored.db_, 2);
+    replay.AddTable(kTable, IntKey(), IntRecord(0));
+    replay.Run();
+
+    CHECK(restored.ReadValue(0) == 0);
+    CHECK(restored.ReadValue(5) == -1);
+    CHECK(restored.ReadValue(7) == 78);
+    CHECK(restored.ReadValue(8) == -1);
+    CHECK(restored.ReadValue(9) == 99);
+    CHECK(restored.ReadValue(49) == 490);
+    CHECK(restored.ReadValue(60) == 600);
+    CHECK(restored.ReadValue(61) == 610);
+    // and takes new commits on top.
+    restored.Write(Upsert, 7, 79);
+    CHECK(restored.ReadValue(7) == 79);
+    std::system(("rm -rf " + kDirectory).c_str());
+}
+
+void FailedCheckpointKeepsChanges()
+{
+    std::system(("rm -rf " + kDirectory + " && mkdir " + kDirectory).c_str());
+    Fixture fixture;
+    auto time = std::make_unique<StepTimeProvider>();
+    StepTimeProvider *clock = time.get();
+    fixture.executor_ = std::make_unique<RuntimeTransactionExecutor>(
+        0,
+        16,
+        fixture.id_factory_.GetTxnIDGenerator(1),
+        fixture.db_.MakeHandler(),
+        std::move(time),
+        nullptr,
+        1 << 10);
+    txckpt::ChangeFeed feed(fixture.db_.GetPartitionCount());
+    fixture.executor_->SetChangeFeed(&feed);
+    txckpt::CheckpointCoordinator coordinator(
+        kCheckpointDirectory, &fixture.db_, nullptr, 2, 16, &feed);
+    coordinator.AddTable(
+        kTable, fixture.db_.GetPartitionCount(), IntRecord(0));
+    coordinator.Checkpoint(clock->GetTime());
+    for (int64_t key = 0; key < 20; key++)
+    {
+        fixture.Write(Insert, key, key);
+    }
+    CHECK(feed.Size() == 20);
+
+    // a file in the way of the rename publishing the checkpoint.
+    int64_t checkpoint_ts = clock->GetTime();
+    std::system(("touch " + txckpt::DeltaPath(kCheckpointDirectory,
+                                              checkpoint_ts))
+                    .c_str());
+    bool thrown = false;
+    try
+    {
+        coordinator.IncrementalCheckpoint(checkpoint_ts);
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    // the keys drained are back, with one changed again since.
+    fixture.Write(Upsert, 3, 33);
+    CHECK(feed.Size() == 20);
+
+    txckpt::CheckpointCoordinator::Stats stats =
+        coordinator.IncrementalCheckpoint(clock->GetTime());
+    CHECK(stats.entries_ == 20);
+    CHECK(feed.Size() == 0);
+    std::system(("rm -rf " + kDirectory).c_str());
+}
+}  // namespace
+
+int main()
+{
+    RestoreAfterCrash();
+    FailedCheckpointKeepsChanges();
+    std::printf("checkpoint-test passed\n");
+    return 0;
+}
@@ -0,0 +1,35 @@
+// Regression tests of the executor threads of ExecutorPool.
+
+#include "test-fixture.h"
+#include "transaction/executor-pool.h"
+
+using namespace txservice;
+using namespace txservice::test;
+
+namespace
+{
+void ShutDownAbortsOpenSession()
+{
+    memory::InMemoryVersionDb db;
+    db.CreateVersionTable(kTable);
+    EpochTxnIDGeneratorFactory id_factory(0, 0);
+    ExecutorPool pool(2, 16, &id_factory, &db, nullptr, 1 << 10, false);
+    pool.Start();
+    pool.AddRequest(std::make_shared<OperationRequest>(1, Begin));
+    auto insert = std::make_shared<OperationRequest>(
+        1, kTable, std::make_unique<IntKey>(1), std::make_unique<IntRecord>(5),
+        Insert);
+    pool.AddRequest(insert);
+    insert->Wait();
+    // the session is never committed.
+    pool.ShutDown();
+    CHECK(pool.Metrics().abort_count_ == 1);
+}
+}  // namespace
+
+int main()
+{
+    ShutDownAbortsOpenSession();
+    std::printf("executor-pool-test passed\n");
+    return 0;
+}
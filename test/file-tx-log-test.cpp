@@ -0,0 +1,57 @@
+// Round trip of commits through a FileTxLog and back with LogReplay.
+
+#include <cstdlib>
+#include <string>
+#include "test-fixture.h"
+#include "txlog/file-tx-log.h"
+#include "txlog/log-replay.h"
+
+using namespace txservice;
+using namespace txservice::test;
+
+namespace
+{
+const std::string kDirectory = "file-tx-log-test.dir";
+
+void ReplayRestoresCommits()
+{
+    std::system(("rm -rf " + kDirectory).c_str());
+    {
+        // small segments, so that the commits span several of them.
+        txlog::FileTxLog log(kDirectory, 1, 200, 512);
+        Fixture fixture(&log);
+        for (int64_t key = 0; key < 100; key++)
+        {
+            fixture.Write(Insert, key, key * 10);
+        }
+        fixture.Write(Upsert, 7, 77);
+        fixture.Submit(Begin);
+        fixture.Submit(Read, 8);
+        fixture.Submit(Delete, 8);
+        fixture.Submit(Commit);
+        fixture.executor_->Run();
+        log.Close();
+        CHECK(log.Segments().size() > 2);
+    }
+
+    // a store that lost everything in the crash.
+    Fixture restored;
+    txlog::LogReplay replay(kDirectory, &restored.db_, 2);
+    replay.AddTable(kTable, IntKey(), IntRecord(0));
+    txlog::LogReplay::Stats stats = replay.Run();
+    CHECK(stats.records_ == 102);
+    CHECK(stats.torn_segments_ == 0);
+    CHECK(restored.ReadValue(0) == 0);
+    CHECK(restored.ReadValue(7) == 77);
+    CHECK(restored.ReadValue(8) == -1);
+    CHECK(restored.ReadValue(99) == 990);
+    std::system(("rm -rf " + kDirectory).c_str());
+}
+}  // namespace
+
+int main()
+{
+    ReplayRestoresCommits();
+    std::printf("file-tx-log-test passed\n");
+    return 0;
+}
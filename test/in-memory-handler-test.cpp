@@ -0,0 +1,57 @@
+// Regression tests of the in-memory backend.
+
+#include "test-fixture.h"
+
+using namespace txservice;
+using namespace txservice::test;
+
+namespace
+{
+void UpsertExistingKey()
+{
+    Fixture fixture;
+    fixture.Write(Upsert, 1, 70);
+    fixture.Write(Upsert, 1, 77);
+    CHECK(fixture.ReadValue(1) == 77);
+}
+
+void InsertAfterDelete()
+{
+    Fixture fixture;
+    fixture.Write(Insert, 2, 70);
+    fixture.Submit(Begin);
+    fixture.Submit(Read, 2);
+    fixture.Submit(Delete, 2);
+    fixture.Submit(Commit);
+    fixture.executor_->Run();
+    fixture.session_++;
+    fixture.Write(Insert, 2, 71);
+    CHECK(fixture.ReadValue(2) == 71);
+}
+
+void KickoutKeepsCommittedValue()
+{
+    Fixture fixture;
+    fixture.Write(Insert, 3, 70);
+    fixture.Write(Upsert, 3, 71);
+    request::Handler::Pointer handler = fixture.db_.MakeHandler();
+    IntKey key(3);
+    request::HandlerResult<bool> result;
+    handler->KickoutVersion(
+        kTable, &key, INT64_MAX, INT64_MAX, INT64_MAX, result);
+    CHECK(result.IsFinished() && !result.IsError());
+    CHECK(fixture.ReadValue(3) == 71);
+    // the version numbering goes on from the kept version.
+    fixture.Write(Upsert, 3, 72);
+    CHECK(fixture.ReadValue(3) == 72);
+}
+}  // namespace
+
+int main()
+{
+    UpsertExistingKey();
+    InsertAfterDelete();
+    KickoutKeepsCommittedValue();
+    std::printf("in-memory-handler-test passed\n");
+    return 0;
+}
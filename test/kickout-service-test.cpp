@@ -0,0 +1,90 @@
+// KickoutService rounds over the in-memory backend, with and without a
+// memory budget.
+
+#include "test-fixture.h"
+#include "txcheckpoint/kickout-service.h"
+
+using namespace txservice;
+using namespace txservice::test;
+
+namespace
+{
+const int64_t kKeys = 200;
+
+// kKeys keys each written four times, the old versions superseded at
+// timestamps just before the clock.
+StepTimeProvider *WriteVersions(Fixture &fixture)
+{
+    auto time = std::make_unique<StepTimeProvider>();
+    StepTimeProvider *clock = time.get();
+    fixture.executor_ = std::make_unique<RuntimeTransactionExecutor>(
+        0,
+        16,
+        fixture.id_factory_.GetTxnIDGenerator(1),
+        fixture.db_.MakeHandler(),
+        std::move(time),
+        nullptr,
+        1 << 10);
+    for (int64_t round = 0; round < 4; round++)
+    {
+        for (int64_t key = 0; key < kKeys; key++)
+        {
+            fixture.Write(Upsert, key, key + round);
+        }
+    }
+    return clock;
+}
+
+void BudgetTrimsVersions()
+{
+    Fixture fixture;
+    StepTimeProvider *clock = WriteVersions(fixture);
+    size_t usage = fixture.db_.VersionMemoryUsage();
+    kickout::KickoutService service(&fixture.db_, usage / 2, 2, 16);
+    service.AddTable(kTable, fixture.db_.GetPartitionCount());
+
+    // a second past the writes: nothing is expired, and only an LRU
+    // interval shortened below it trims the old versions.
+    int64_t kickout_ts = clock->now_ + 1000000;
+    kickout::KickoutService::Stats stats =
+        service.Round(kickout_ts, kickout::KickoutService::kNoCheckpoint);
+    CHECK(stats.kickout_num_ == 0);
+    CHECK(stats.memory_usage_ == usage);
+    for (int round = 0; round < 8 && stats.memory_usage_ >= usage; round++)
+    {
+        stats = service.Round(kickout_ts,
+                              kickout::KickoutService::kNoCheckpoint);
+    }
+    CHECK(stats.kickout_num_ == static_cast<size_t>(kKeys));
+    CHECK(stats.memory_usage_ < usage / 2);
+    CHECK(service.LruInterval() < 1000000);
+    // the latest versions stay.
+    for (int64_t key = 0; key < kKeys; key++)
+    {
+        CHECK(fixture.ReadValue(key) == key + 3);
+    }
+}
+
+void NoBudgetKeepsVersions()
+{
+    Fixture fixture;
+    StepTimeProvider *clock = WriteVersions(fixture);
+    size_t usage = fixture.db_.VersionMemoryUsage();
+    kickout::KickoutService service(&fixture.db_, 0, 2, 16);
+    service.AddTable(kTable, fixture.db_.GetPartitionCount());
+    int64_t kickout_ts = clock->now_ + 1000000;
+    for (int round = 0; round < 8; round++)
+    {
+        service.Round(kickout_ts, kickout::KickoutService::kNoCheckpoint);
+    }
+    CHECK(fixture.db_.VersionMemoryUsage() == usage);
+}
+}  // namespace
+
+int main()
+{
+    BudgetTrimsVersions();
+    NoBudgetKeepsVersions();
+    std::printf("kickout-service-test passed\n");
+    return 0;
+}
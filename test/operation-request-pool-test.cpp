@@ -0,0 +1,61 @@
+// Regression tests of requests recycled through an OperationRequestPool.
+
+#include "test-fixture.h"
+#include "transaction/operation-request-pool.h"
+
+using namespace txservice;
+using namespace txservice::test;
+
+namespace
+{
+void RecycledRequestKeepsKeyAndRecord()
+{
+    OperationRequestPool pool(4);
+    OperationRequest *first = pool.Acquire(1, kTable, IntKey(1), nullptr, Read);
+    first->record_ = std::make_unique<IntRecord>(0);
+    Key *key = first->key_.get();
+    Record *record = first->record_.get();
+    first->Release();
+
+    IntRecord value(7);
+    OperationRequest *second = pool.Acquire(2, kTable, IntKey(5), &value, Update);
+    CHECK(second == first);
+    CHECK(second->key_.get() == key);
+    CHECK(second->record_.get() == record);
+    CHECK(static_cast<IntKey *>(second->key_.get())->k == 5);
+    CHECK(static_cast<IntRecord *>(second->record_.get())->data == 7);
+    CHECK(second->session_id_ == 2);
+    second->Release();
+
+    // a record of another type is copied, not cast into the kept one.
+    StringRecord text("abc");
+    OperationRequest *third = pool.Acquire(3, kTable, IntKey(6), &text, Update);
+    CHECK(dynamic_cast<StringRecord *>(third->record_.get()) != nullptr);
+    third->Release();
+}
+
+void ContinuationRunsOnce()
+{
+    Fixture fixture;
+    int calls = 0;
+    bool committed = false;
+    fixture.Submit(Begin);
+    fixture.Submit(Insert, 1, 10);
+    auto commit = fixture.Submit(Commit);
+    commit->OnComplete([&calls, &committed](OperationRequest *request) {
+        calls++;
+        committed = request->GetResult()->IsCommitted();
+    });
+    fixture.executor_->Run();
+    CHECK(calls == 1);
+    CHECK(committed);
+}
+}  // namespace
+
+int main()
+{
+    RecycledRequestKeepsKeyAndRecord();
+    ContinuationRunsOnce();
+    std::printf("operation-request-pool-test passed\n");
+    return 0;
+}
@@ -0,0 +1,133 @@
+// Regression tests of the abort post processing redone after a failed
+// handler request.
+
+#include <stdexcept>
+#include "test-fixture.h"
+
+using namespace txservice;
+using namespace txservice::test;
+
+namespace
+{
+// fails the first failures_ DeleteVersion and ReleaseReadCounter calls.
+struct FlakyHandler : memory::InMemoryHandler
+{
+    FlakyHandler(memory::InMemoryVersionDb *db, int failures)
+        : InMemoryHandler(db), failures_(failures)
+    {
+    }
+
+    virtual void DeleteVersion(const TableName &table_name,
+                               const Key &key,
+                               int64_t version_key,
+                               EntryExtension *extension,
+                               request::HandlerResult<Void> &result) override
+    {
+        if (delete_calls_++ < failures_)
+        {
+            result.SetError();
+            return;
+        }
+        InMemoryHandler::DeleteVersion(
+            table_name, key, version_key, extension, result);
+    }
+
+    virtual void ReleaseReadCounter(
+        const TableName &table_name,
+        const Key &key,
+        int64_t version_key,
+        EntryExtension *extension,
+        request::HandlerResult<Void> &result) override
+    {
+        if (release_calls_++ < failures_)
+        {
+            result.SetError();
+            return;
+        }
+        InMemoryHandler::ReleaseReadCounter(
+            table_name, key, version_key, extension, result);
+    }
+
+    int failures_;
+    int delete_calls_ = 0;
+    int release_calls_ = 0;
+};
+
+int64_t ReadCount(Fixture &fixture, int64_t key)
+{
+    IntKey k(key);
+    memory::VersionList *list =
+        fixture.db_.GetVersionTable(kTable)->GetPartition(k).Find(k);
+    return list == nullptr ? 0 : list->read_count_;
+}
+
+// two txns reading key 1, each inserting a key of its own, 2 or 4, and
+// updating key 3, so that one of them aborts on the conflict after its
+// insert is uploaded; over a handler failing the cleanup failures times.
+FlakyHandler *AbortOverFlakyHandler(Fixture &fixture, int failures)
+{
+    fixture.Write(Insert, 1, 10);
+    fixture.Write(Insert, 3, 30);
+    auto handler = std::make_unique<FlakyHandler>(&fixture.db_, failures);
+    FlakyHandler *flaky = handler.get();
+    fixture.executor_ = std::make_unique<RuntimeTransactionExecutor>(
+        0,
+        16,
+        fixture.id_factory_.GetTxnIDGenerator(1),
+        std::move(handler),
+        std::make_unique<LocalTimeProvider>(),
+        nullptr,
+        1 << 10);
+    for (int64_t key : {2, 4})
+    {
+        fixture.Submit(Begin);
+        fixture.Submit(Read, 1);
+        fixture.Submit(Read, 3);
+        fixture.Submit(Insert, key, key * 10);
+        fixture.Submit(Update, 3, key);
+        fixture.Submit(Commit);
+        fixture.session_++;
+    }
+    return flaky;
+}
+
+void AbortRetriesFailedCleanup()
+{
+    Fixture fixture;
+    FlakyHandler *flaky = AbortOverFlakyHandler(fixture, 2);
+    fixture.executor_->Run();
+    CHECK(flaky->delete_calls_ == 3);
+    CHECK(flaky->release_calls_ > 2);
+    // the read counters are given back and the dirty version is gone.
+    CHECK(ReadCount(fixture, 1) == 0);
+    int64_t aborted = fixture.ReadValue(3) == 2 ? 4 : 2;
+    CHECK(fixture.ReadValue(aborted) == -1);
+    fixture.Write(Insert, aborted, 21);
+    CHECK(fixture.ReadValue(aborted) == 21);
+}
+
+void AbortGivesUpAfterRetryBudget()
+{
+    Fixture fixture;
+    FlakyHandler *flaky = AbortOverFlakyHandler(fixture, 1 << 20);
+    bool thrown = false;
+    try
+    {
+        fixture.executor_->Run();
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(flaky->delete_calls_ == 1 + Constant::RECOVERY_RETRY_COUNT);
+}
+}  // namespace
+
+int main()
+{
+    AbortRetriesFailedCleanup();
+    AbortGivesUpAfterRetryBudget();
+    std::printf("recovery-test passed\n");
+    return 0;
+}
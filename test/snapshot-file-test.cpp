@@ -0,0 +1,95 @@
+// Round trip of entries through a SnapshotWriter spilling sorted runs and a
+// SnapshotReader.
+
+#include <dirent.h>
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "test-fixture.h"
+#include "txcheckpoint/snapshot-file.h"
+
+using namespace txservice;
+using namespace txservice::test;
+
+namespace
+{
+const std::string kDirectory = "snapshot-file-test.dir";
+
+size_t FileCount(const std::string &directory)
+{
+    size_t count = 0;
+    DIR *dir = opendir(directory.c_str());
+    while (dirent *entry = readdir(dir))
+    {
+        count += entry->d_name[0] != '.' ? 1 : 0;
+    }
+    closedir(dir);
+    return count;
+}
+
+void RoundTrip(size_t run_size)
+{
+    std::system(("rm -rf " + kDirectory + " && mkdir " + kDirectory).c_str());
+    const std::string path = kDirectory + "/snapshot";
+    const int64_t count = 1000;
+    std::vector<int64_t> keys(count);
+    for (int64_t key = 0; key < count; key++)
+    {
+        keys[key] = key;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+    {
+        txckpt::SnapshotWriter writer(path, 42, run_size);
+        for (int64_t key : keys)
+        {
+            IntKey k(key);
+            IntRecord record(key * 10);
+            // every tenth key a tombstone.
+            writer.Add(txckpt::CheckpointEntry(
+                &k, &record, key % 10 == 0, key + 1, key + 100));
+        }
+        writer.Finish();
+        CHECK(writer.EntryCount() == static_cast<size_t>(count));
+    }
+    // the runs are gone, only the snapshot is left.
+    CHECK(FileCount(kDirectory) == 1);
+
+    txckpt::SnapshotReader reader(path, IntKey(), IntRecord(0));
+    CHECK(reader.CheckpointTs() == 42);
+    CHECK(reader.EntryCount() == static_cast<uint64_t>(count));
+    std::vector<bool> seen(count, false);
+    std::string last_key;
+    int64_t read = 0;
+    while (reader.MoveNext())
+    {
+        std::string key(reader.CurrentKey());
+        CHECK(read == 0 || last_key < key);
+        last_key = key;
+        txckpt::CheckpointEntry entry = reader.Current();
+        int64_t k = static_cast<IntKey *>(entry.key_)->k;
+        CHECK(k >= 0 && k < count && !seen[k]);
+        seen[k] = true;
+        CHECK(entry.is_deleted_ == (k % 10 == 0));
+        CHECK(entry.version_ == k + 1);
+        CHECK(entry.commit_ts_ == k + 100);
+        if (!entry.is_deleted_)
+        {
+            CHECK(static_cast<IntRecord *>(entry.record_)->data == k * 10);
+        }
+        read++;
+    }
+    CHECK(read == count);
+    std::system(("rm -rf " + kDirectory).c_str());
+}
+}  // namespace
+
+int main()
+{
+    // held in memory, then spilled in many small runs.
+    RoundTrip(Constant::SNAPSHOT_RUN_SIZE);
+    RoundTrip(4096);
+    std::printf("snapshot-file-test passed\n");
+    return 0;
+}
@@ -0,0 +1,128 @@
+#ifndef TXSERVICE_TEST_TEST_FIXTURE_H_
+#define TXSERVICE_TEST_TEST_FIXTURE_H_
+
+// An in-memory VersionDb behind a RuntimeTransactionExecutor, driven
+// through OperationRequests as a client would.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include "memory/in-memory-handler.h"
+#include "memory/in-memory-versiondb.h"
+#include "transaction/runtime-transaction-executor.h"
+#include "transaction/txn-id-generator-factory.h"
+#include "txlog/txlog.h"
+
+#define CHECK(cond)                                                     \
+    do                                                                  \
+    {                                                                   \
+        if (!(cond))                                                    \
+        {                                                               \
+            std::fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            std::exit(1);                                               \
+        }                                                               \
+    } while (0)
+
+namespace txservice::test
+{
+using namespace txservice::transaction;
+
+const TableName kTable = "t";
+
+// hands out increasing timestamps, so that a test knows which commits come
+// before a checkpoint or a kickout.
+struct StepTimeProvider : TimeProvider
+{
+    virtual int64_t GetTime() override
+    {
+        return ++now_;
+    }
+
+    virtual void SetTime(int64_t time) override
+    {
+        now_ = std::max(now_, time);
+    }
+
+    int64_t now_ = 1000;
+};
+
+struct Fixture
+{
+    explicit Fixture(txlog::TxLog *tx_log = nullptr) : id_factory_(0, 0)
+    {
+        db_.CreateVersionTable(kTable);
+        executor_ = std::make_unique<RuntimeTransactionExecutor>(
+            0,
+            16,
+            id_factory_.GetTxnIDGenerator(0),
+            db_.MakeHandler(),
+            std::make_unique<LocalTimeProvider>(),
+            tx_log,
+            1 << 10);
+    }
+
+    std::shared_ptr<OperationRequest> Submit(OperationType type,
+                                             int64_t key = 0,
+                                             int64_t value = 0)
+    {
+        std::shared_ptr<OperationRequest> request;
+        if (type == Begin || type == Commit || type == Abort)
+        {
+            request = std::make_shared<OperationRequest>(session_, type);
+        }
+        else
+        {
+            request = std::make_shared<OperationRequest>(
+                session_,
+                kTable,
+                std::make_unique<IntKey>(key),
+                std::make_unique<IntRecord>(value),
+                type);
+        }
+        executor_->AddRequest(request);
+        return request;
+    }
+
+    // runs one txn writing value to key with the given operation.
+    void Write(OperationType type, int64_t key, int64_t value)
+    {
+        Submit(Begin);
+        auto write = Submit(type, key, value);
+        bool committed = false;
+        auto commit = Submit(Commit);
+        commit->OnComplete([&committed](OperationRequest *request) {
+            committed = request->GetResult()->IsCommitted();
+        });
+        executor_->Run();
+        session_++;
+        CHECK(committed);
+        // the payload handed in is what got written, not the old value.
+        CHECK(static_cast<IntRecord *>(write->record_.get())->data == value);
+    }
+
+    // the committed value of key, -1 if there is none.
+    int64_t ReadValue(int64_t key)
+    {
+        Submit(Begin);
+        auto read = Submit(Read, key);
+        bool found = false;
+        read->OnComplete([&found](OperationRequest *request) {
+            found = !request->GetResult()->IsNull() &&
+                    !request->GetResult()->IsDeleted();
+        });
+        Submit(Commit);
+        executor_->Run();
+        session_++;
+        return found ? static_cast<IntRecord *>(read->record_.get())->data
+                     : -1;
+    }
+
+    memory::InMemoryVersionDb db_;
+    EpochTxnIDGeneratorFactory id_factory_;
+    std::unique_ptr<RuntimeTransactionExecutor> executor_;
+    int64_t session_ = 1;
+};
+}  // namespace txservice::test
+#endif  // TXSERVICE_TEST_TEST_FIXTURE_H_
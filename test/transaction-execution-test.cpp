@@ -0,0 +1,126 @@
+// Regression tests of reads served from the local state of a txn.
+
+#include "test-fixture.h"
+
+using namespace txservice;
+using namespace txservice::test;
+
+namespace
+{
+int64_t &Data(const std::shared_ptr<OperationRequest> &request)
+{
+    return static_cast<IntRecord *>(request->record_.get())->data;
+}
+
+void RepeatedReadIgnoresClientBuffer()
+{
+    Fixture fixture;
+    fixture.Write(Insert, 1, 70);
+    fixture.Submit(Begin);
+    auto first = fixture.Submit(Read, 1);
+    int64_t first_value = -1;
+    first->OnComplete([&first_value](OperationRequest *request) {
+        IntRecord *record = static_cast<IntRecord *>(request->record_.get());
+        first_value = record->data;
+        // the client reuses the buffer of the first read.
+        record->data = 12345;
+    });
+    auto second = fixture.Submit(Read, 1);
+    fixture.Submit(Commit);
+    fixture.executor_->Run();
+    CHECK(first_value == 70);
+    CHECK(Data(second) == 70);
+}
+
+void RepeatedReadKeepsOneReadSetEntry()
+{
+    Fixture fixture;
+    fixture.Write(Insert, 2, 70);
+    const MetricsSnapshot before = fixture.executor_->Metrics();
+    fixture.Submit(Begin);
+    fixture.Submit(Read, 2);
+    fixture.Submit(Read, 2);
+    bool committed = false;
+    auto commit = fixture.Submit(Commit);
+    commit->OnComplete([&committed](OperationRequest *request) {
+        committed = request->GetResult()->IsCommitted();
+    });
+    fixture.executor_->Run();
+    CHECK(committed);
+    const MetricsSnapshot after = fixture.executor_->Metrics();
+    size_t phase =
+        static_cast<size_t>(OperationPhase::kUpdateReadEntryMaxCommitTs);
+    // the key is validated once, not once per read.
+    CHECK(after.phases_[phase].count_ - before.phases_[phase].count_ == 1);
+}
+
+// steps the executor until done is set.
+void RunUntil(Fixture &fixture, const bool &done)
+{
+    while (!done)
+    {
+        fixture.executor_->RunOnce();
+    }
+}
+
+void ReadOnlyTxnReadsOneSnapshot()
+{
+    Fixture fixture;
+    fixture.Write(Insert, 1, 10);
+    fixture.Write(Insert, 2, 20);
+    const int64_t reader = fixture.session_++;
+    const int64_t writer = fixture.session_++;
+
+    fixture.session_ = reader;
+    auto begin = fixture.Submit(Begin);
+    begin->type_ = ReadOnlyTxn;
+    auto first = fixture.Submit(Read, 1);
+    bool first_read = false;
+    first->OnComplete(
+        [&first_read](OperationRequest *) { first_read = true; });
+    RunUntil(fixture, first_read);
+
+    // moves 5 from key 1 to key 2 between the two reads.
+    fixture.session_ = writer;
+    fixture.Submit(Begin);
+    fixture.Submit(Read, 1);
+    fixture.Submit(Read, 2);
+    fixture.Submit(Update, 1, 5);
+    fixture.Submit(Update, 2, 25);
+    bool moved = false;
+    bool committed = false;
+    auto commit = fixture.Submit(Commit);
+    commit->OnComplete([&](OperationRequest *request) {
+        moved = true;
+        committed = request->GetResult()->IsCommitted();
+    });
+    RunUntil(fixture, moved);
+    CHECK(committed);
+
+    fixture.session_ = reader;
+    auto second = fixture.Submit(Read, 2);
+    committed = false;
+    commit = fixture.Submit(Commit);
+    commit->OnComplete([&committed](OperationRequest *request) {
+        committed = request->GetResult()->IsCommitted();
+    });
+    fixture.executor_->Run();
+    CHECK(committed);
+    // both reads are of the state before the move.
+    CHECK(Data(first) == 10);
+    CHECK(Data(second) == 20);
+
+    fixture.session_ = writer + 1;
+    CHECK(fixture.ReadValue(1) == 5);
+    CHECK(fixture.ReadValue(2) == 25);
+}
+}  // namespace
+
+int main()
+{
+    RepeatedReadIgnoresClientBuffer();
+    RepeatedReadKeepsOneReadSetEntry();
+    ReadOnlyTxnReadsOneSnapshot();
+    std::printf("transaction-execution-test passed\n");
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Txn ids of EpochTxnIDGenerators over boots and sequence rollovers.
+
+#include <cstdlib>
+#include <set>
+#include <string>
+#include "test-fixture.h"
+#include "transaction/txn-id-generator.h"
+
+using namespace txservice;
+using namespace txservice::test;
+
+namespace
+{
+const std::string kDirectory = "txn-id-generator-test.dir";
+const std::string kEpochPath = kDirectory + "/epoch";
+
+int64_t EpochOf(int64_t id)
+{
+    return (id >> EpochTxnIDGenerator::kSequenceBits) &
+           ((int64_t(1) << EpochTxnIDGenerator::kEpochBits) - 1);
+}
+
+void BootsTakeNewEpochs()
+{
+    std::system(("rm -rf " + kDirectory + " && mkdir " + kDirectory).c_str());
+    std::set<int64_t> epochs;
+    for (int boot = 0; boot < 3; boot++)
+    {
+        EpochTxnIDGeneratorFactory factory(1, kEpochPath);
+        CHECK(factory.CurrentEpoch() == boot);
+        int64_t id = factory.GetTxnIDGenerator(2)->GenerateID();
+        CHECK(EpochOf(id) == boot);
+        epochs.insert(EpochOf(id));
+    }
+    CHECK(epochs.size() == 3);
+    std::system(("rm -rf " + kDirectory).c_str());
+}
+
+void ExhaustedSequenceRollsOver()
+{
+    std::system(("rm -rf " + kDirectory + " && mkdir " + kDirectory).c_str());
+    const int64_t last = (int64_t(1) << EpochTxnIDGenerator::kSequenceBits) - 1;
+    int64_t rolled_epoch;
+    {
+        BootEpoch epochs(kEpochPath);
+        // two ids before the end of the sequence.
+        EpochTxnIDGenerator generator(1, 2, &epochs, last - 2);
+        std::set<int64_t> ids;
+        for (int i = 0; i < 4; i++)
+        {
+            int64_t id = generator.GenerateID();
+            CHECK(id > 0);
+            ids.insert(id);
+        }
+        CHECK(ids.size() == 4);
+        auto it = ids.begin();
+        CHECK(EpochOf(*it++) == 0);
+        CHECK(EpochOf(*it++) == 0);
+        rolled_epoch = EpochOf(*it);
+        CHECK(rolled_epoch == 1);
+        CHECK(epochs.Current() == 1);
+    }
+    // the epoch rolled over to is not taken again by the next boot.
+    BootEpoch epochs(kEpochPath);
+    CHECK(epochs.Current() == rolled_epoch + 1);
+    std::system(("rm -rf " + kDirectory).c_str());
+}
+}  // namespace
+
+int main()
+{
+    BootsTakeNewEpochs();
+    ExhaustedSequenceRollsOver();
+    std::printf("txn-id-generator-test passed\n");
+    return 0;
+}
@@ -0,0 +1,51 @@
+// Round trip of commits through a UringTxLog and back with LogReplay.
+
+#include <cstdlib>
+#include <string>
+#include "test-fixture.h"
+#include "txlog/log-replay.h"
+#include "txlog/uring-tx-log.h"
+
+using namespace txservice;
+using namespace txservice::test;
+
+namespace
+{
+const std::string kDirectory = "uring-tx-log-test.dir";
+
+void ReplayRestoresCommits(bool use_uring)
+{
+    std::system(("rm -rf " + kDirectory).c_str());
+    {
+        // small segments, rotated while buffers are still in flight.
+        txlog::UringTxLog log(kDirectory, 1, 512, use_uring);
+        Fixture fixture(&log);
+        for (int64_t key = 0; key < 100; key++)
+        {
+            fixture.Write(Insert, key, key * 10);
+        }
+        fixture.Write(Upsert, 7, 77);
+        log.Close();
+        CHECK(log.Segments().size() > 2);
+    }
+
+    Fixture restored;
+    txlog::LogReplay replay(kDirectory, &restored.db_, 2);
+    replay.AddTable(kTable, IntKey(), IntRecord(0));
+    txlog::LogReplay::Stats stats = replay.Run();
+    CHECK(stats.records_ == 101);
+    CHECK(stats.torn_segments_ == 0);
+    CHECK(restored.ReadValue(0) == 0);
+    CHECK(restored.ReadValue(7) == 77);
+    CHECK(restored.ReadValue(99) == 990);
+    std::system(("rm -rf " + kDirectory).c_str());
+}
+}  // namespace
+
+int main()
+{
+    ReplayRestoresCommits(true);
+    ReplayRestoresCommits(false);
+    std::printf("uring-tx-log-test passed\n");
+    return 0;
+}